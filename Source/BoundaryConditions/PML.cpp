@@ -11,6 +11,7 @@
 #include "Utils/WarpXConst.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "WarpX.H"
+#include "Diagnostics/CompressedMultiFabIO.H"
 
 #include <AMReX.H>
 #include <AMReX_Print.H>
@@ -22,6 +23,7 @@
 
 #include <algorithm>
 #include <memory>
+#include <vector>
 
 
 using namespace amrex;
@@ -1124,26 +1126,26 @@ PML::FillBoundaryG (PatchType patch_type)
 }
 
 void
-PML::CheckPoint (const std::string& dir) const
+PML::CheckPoint (const std::string& dir, const bool compress) const
 {
     if (pml_E_fp[0])
     {
-        VisMF::AsyncWrite(*pml_E_fp[0], dir+"_Ex_fp");
-        VisMF::AsyncWrite(*pml_E_fp[1], dir+"_Ey_fp");
-        VisMF::AsyncWrite(*pml_E_fp[2], dir+"_Ez_fp");
-        VisMF::AsyncWrite(*pml_B_fp[0], dir+"_Bx_fp");
-        VisMF::AsyncWrite(*pml_B_fp[1], dir+"_By_fp");
-        VisMF::AsyncWrite(*pml_B_fp[2], dir+"_Bz_fp");
+        WriteCheckpointMultiFab(*pml_E_fp[0], dir+"_Ex_fp", compress);
+        WriteCheckpointMultiFab(*pml_E_fp[1], dir+"_Ey_fp", compress);
+        WriteCheckpointMultiFab(*pml_E_fp[2], dir+"_Ez_fp", compress);
+        WriteCheckpointMultiFab(*pml_B_fp[0], dir+"_Bx_fp", compress);
+        WriteCheckpointMultiFab(*pml_B_fp[1], dir+"_By_fp", compress);
+        WriteCheckpointMultiFab(*pml_B_fp[2], dir+"_Bz_fp", compress);
     }
 
     if (pml_E_cp[0])
     {
-        VisMF::AsyncWrite(*pml_E_cp[0], dir+"_Ex_cp");
-        VisMF::AsyncWrite(*pml_E_cp[1], dir+"_Ey_cp");
-        VisMF::AsyncWrite(*pml_E_cp[2], dir+"_Ez_cp");
-        VisMF::AsyncWrite(*pml_B_cp[0], dir+"_Bx_cp");
-        VisMF::AsyncWrite(*pml_B_cp[1], dir+"_By_cp");
-        VisMF::AsyncWrite(*pml_B_cp[2], dir+"_Bz_cp");
+        WriteCheckpointMultiFab(*pml_E_cp[0], dir+"_Ex_cp", compress);
+        WriteCheckpointMultiFab(*pml_E_cp[1], dir+"_Ey_cp", compress);
+        WriteCheckpointMultiFab(*pml_E_cp[2], dir+"_Ez_cp", compress);
+        WriteCheckpointMultiFab(*pml_B_cp[0], dir+"_Bx_cp", compress);
+        WriteCheckpointMultiFab(*pml_B_cp[1], dir+"_By_cp", compress);
+        WriteCheckpointMultiFab(*pml_B_cp[2], dir+"_Bz_cp", compress);
     }
 }
 
@@ -1152,22 +1154,22 @@ PML::Restart (const std::string& dir)
 {
     if (pml_E_fp[0])
     {
-        VisMF::Read(*pml_E_fp[0], dir+"_Ex_fp");
-        VisMF::Read(*pml_E_fp[1], dir+"_Ey_fp");
-        VisMF::Read(*pml_E_fp[2], dir+"_Ez_fp");
-        VisMF::Read(*pml_B_fp[0], dir+"_Bx_fp");
-        VisMF::Read(*pml_B_fp[1], dir+"_By_fp");
-        VisMF::Read(*pml_B_fp[2], dir+"_Bz_fp");
+        ReadCheckpointMultiFab(*pml_E_fp[0], dir+"_Ex_fp");
+        ReadCheckpointMultiFab(*pml_E_fp[1], dir+"_Ey_fp");
+        ReadCheckpointMultiFab(*pml_E_fp[2], dir+"_Ez_fp");
+        ReadCheckpointMultiFab(*pml_B_fp[0], dir+"_Bx_fp");
+        ReadCheckpointMultiFab(*pml_B_fp[1], dir+"_By_fp");
+        ReadCheckpointMultiFab(*pml_B_fp[2], dir+"_Bz_fp");
     }
 
     if (pml_E_cp[0])
     {
-        VisMF::Read(*pml_E_cp[0], dir+"_Ex_cp");
-        VisMF::Read(*pml_E_cp[1], dir+"_Ey_cp");
-        VisMF::Read(*pml_E_cp[2], dir+"_Ez_cp");
-        VisMF::Read(*pml_B_cp[0], dir+"_Bx_cp");
-        VisMF::Read(*pml_B_cp[1], dir+"_By_cp");
-        VisMF::Read(*pml_B_cp[2], dir+"_Bz_cp");
+        ReadCheckpointMultiFab(*pml_E_cp[0], dir+"_Ex_cp");
+        ReadCheckpointMultiFab(*pml_E_cp[1], dir+"_Ey_cp");
+        ReadCheckpointMultiFab(*pml_E_cp[2], dir+"_Ez_cp");
+        ReadCheckpointMultiFab(*pml_B_cp[0], dir+"_Bx_cp");
+        ReadCheckpointMultiFab(*pml_B_cp[1], dir+"_By_cp");
+        ReadCheckpointMultiFab(*pml_B_cp[2], dir+"_Bz_cp");
     }
 }
 
@@ -1193,79 +1195,85 @@ PushPMLPSATDSinglePatch (
 {
     using SpIdx = SpectralPMLIndex;
 
-    // Perform forward Fourier transforms
-    solver.ForwardTransform(lev, *pml_E[0], SpIdx::Exy, PMLComp::xy);
-    solver.ForwardTransform(lev, *pml_E[0], SpIdx::Exz, PMLComp::xz);
-    solver.ForwardTransform(lev, *pml_E[1], SpIdx::Eyx, PMLComp::yx);
-    solver.ForwardTransform(lev, *pml_E[1], SpIdx::Eyz, PMLComp::yz);
-    solver.ForwardTransform(lev, *pml_E[2], SpIdx::Ezx, PMLComp::zx);
-    solver.ForwardTransform(lev, *pml_E[2], SpIdx::Ezy, PMLComp::zy);
-    solver.ForwardTransform(lev, *pml_B[0], SpIdx::Bxy, PMLComp::xy);
-    solver.ForwardTransform(lev, *pml_B[0], SpIdx::Bxz, PMLComp::xz);
-    solver.ForwardTransform(lev, *pml_B[1], SpIdx::Byx, PMLComp::yx);
-    solver.ForwardTransform(lev, *pml_B[1], SpIdx::Byz, PMLComp::yz);
-    solver.ForwardTransform(lev, *pml_B[2], SpIdx::Bzx, PMLComp::zx);
-    solver.ForwardTransform(lev, *pml_B[2], SpIdx::Bzy, PMLComp::zy);
+    // Perform forward Fourier transforms (batched over all the fields of a box)
+    std::vector<SpectralFieldData::ForwardTransformInput> inputs;
+    inputs.emplace_back(*pml_E[0], SpIdx::Exy, PMLComp::xy);
+    inputs.emplace_back(*pml_E[0], SpIdx::Exz, PMLComp::xz);
+    inputs.emplace_back(*pml_E[1], SpIdx::Eyx, PMLComp::yx);
+    inputs.emplace_back(*pml_E[1], SpIdx::Eyz, PMLComp::yz);
+    inputs.emplace_back(*pml_E[2], SpIdx::Ezx, PMLComp::zx);
+    inputs.emplace_back(*pml_E[2], SpIdx::Ezy, PMLComp::zy);
+    inputs.emplace_back(*pml_B[0], SpIdx::Bxy, PMLComp::xy);
+    inputs.emplace_back(*pml_B[0], SpIdx::Bxz, PMLComp::xz);
+    inputs.emplace_back(*pml_B[1], SpIdx::Byx, PMLComp::yx);
+    inputs.emplace_back(*pml_B[1], SpIdx::Byz, PMLComp::yz);
+    inputs.emplace_back(*pml_B[2], SpIdx::Bzx, PMLComp::zx);
+    inputs.emplace_back(*pml_B[2], SpIdx::Bzy, PMLComp::zy);
 
     // WarpX::do_pml_dive_cleaning = true
     if (pml_F)
     {
-        solver.ForwardTransform(lev, *pml_E[0], SpIdx::Exx, PMLComp::xx);
-        solver.ForwardTransform(lev, *pml_E[1], SpIdx::Eyy, PMLComp::yy);
-        solver.ForwardTransform(lev, *pml_E[2], SpIdx::Ezz, PMLComp::zz);
-        solver.ForwardTransform(lev, *pml_F, SpIdx::Fx, PMLComp::x);
-        solver.ForwardTransform(lev, *pml_F, SpIdx::Fy, PMLComp::y);
-        solver.ForwardTransform(lev, *pml_F, SpIdx::Fz, PMLComp::z);
+        inputs.emplace_back(*pml_E[0], SpIdx::Exx, PMLComp::xx);
+        inputs.emplace_back(*pml_E[1], SpIdx::Eyy, PMLComp::yy);
+        inputs.emplace_back(*pml_E[2], SpIdx::Ezz, PMLComp::zz);
+        inputs.emplace_back(*pml_F, SpIdx::Fx, PMLComp::x);
+        inputs.emplace_back(*pml_F, SpIdx::Fy, PMLComp::y);
+        inputs.emplace_back(*pml_F, SpIdx::Fz, PMLComp::z);
     }
 
     // WarpX::do_pml_divb_cleaning = true
     if (pml_G)
     {
-        solver.ForwardTransform(lev, *pml_B[0], SpIdx::Bxx, PMLComp::xx);
-        solver.ForwardTransform(lev, *pml_B[1], SpIdx::Byy, PMLComp::yy);
-        solver.ForwardTransform(lev, *pml_B[2], SpIdx::Bzz, PMLComp::zz);
-        solver.ForwardTransform(lev, *pml_G, SpIdx::Gx, PMLComp::x);
-        solver.ForwardTransform(lev, *pml_G, SpIdx::Gy, PMLComp::y);
-        solver.ForwardTransform(lev, *pml_G, SpIdx::Gz, PMLComp::z);
+        inputs.emplace_back(*pml_B[0], SpIdx::Bxx, PMLComp::xx);
+        inputs.emplace_back(*pml_B[1], SpIdx::Byy, PMLComp::yy);
+        inputs.emplace_back(*pml_B[2], SpIdx::Bzz, PMLComp::zz);
+        inputs.emplace_back(*pml_G, SpIdx::Gx, PMLComp::x);
+        inputs.emplace_back(*pml_G, SpIdx::Gy, PMLComp::y);
+        inputs.emplace_back(*pml_G, SpIdx::Gz, PMLComp::z);
     }
 
+    solver.ForwardTransform(lev, inputs);
+
     // Advance fields in spectral space
     solver.pushSpectralFields();
 
-    // Perform backward Fourier transforms
-    solver.BackwardTransform(lev, *pml_E[0], SpIdx::Exy, PMLComp::xy);
-    solver.BackwardTransform(lev, *pml_E[0], SpIdx::Exz, PMLComp::xz);
-    solver.BackwardTransform(lev, *pml_E[1], SpIdx::Eyx, PMLComp::yx);
-    solver.BackwardTransform(lev, *pml_E[1], SpIdx::Eyz, PMLComp::yz);
-    solver.BackwardTransform(lev, *pml_E[2], SpIdx::Ezx, PMLComp::zx);
-    solver.BackwardTransform(lev, *pml_E[2], SpIdx::Ezy, PMLComp::zy);
-    solver.BackwardTransform(lev, *pml_B[0], SpIdx::Bxy, PMLComp::xy);
-    solver.BackwardTransform(lev, *pml_B[0], SpIdx::Bxz, PMLComp::xz);
-    solver.BackwardTransform(lev, *pml_B[1], SpIdx::Byx, PMLComp::yx);
-    solver.BackwardTransform(lev, *pml_B[1], SpIdx::Byz, PMLComp::yz);
-    solver.BackwardTransform(lev, *pml_B[2], SpIdx::Bzx, PMLComp::zx);
-    solver.BackwardTransform(lev, *pml_B[2], SpIdx::Bzy, PMLComp::zy);
+    // Perform backward Fourier transforms (batched over all the fields of a box)
+    std::vector<SpectralFieldData::BackwardTransformOutput> outputs;
+    outputs.emplace_back(*pml_E[0], SpIdx::Exy, PMLComp::xy);
+    outputs.emplace_back(*pml_E[0], SpIdx::Exz, PMLComp::xz);
+    outputs.emplace_back(*pml_E[1], SpIdx::Eyx, PMLComp::yx);
+    outputs.emplace_back(*pml_E[1], SpIdx::Eyz, PMLComp::yz);
+    outputs.emplace_back(*pml_E[2], SpIdx::Ezx, PMLComp::zx);
+    outputs.emplace_back(*pml_E[2], SpIdx::Ezy, PMLComp::zy);
+    outputs.emplace_back(*pml_B[0], SpIdx::Bxy, PMLComp::xy);
+    outputs.emplace_back(*pml_B[0], SpIdx::Bxz, PMLComp::xz);
+    outputs.emplace_back(*pml_B[1], SpIdx::Byx, PMLComp::yx);
+    outputs.emplace_back(*pml_B[1], SpIdx::Byz, PMLComp::yz);
+    outputs.emplace_back(*pml_B[2], SpIdx::Bzx, PMLComp::zx);
+    outputs.emplace_back(*pml_B[2], SpIdx::Bzy, PMLComp::zy);
 
     // WarpX::do_pml_dive_cleaning = true
     if (pml_F)
     {
-        solver.BackwardTransform(lev, *pml_E[0], SpIdx::Exx, PMLComp::xx);
-        solver.BackwardTransform(lev, *pml_E[1], SpIdx::Eyy, PMLComp::yy);
-        solver.BackwardTransform(lev, *pml_E[2], SpIdx::Ezz, PMLComp::zz);
-        solver.BackwardTransform(lev, *pml_F, SpIdx::Fx, PMLComp::x);
-        solver.BackwardTransform(lev, *pml_F, SpIdx::Fy, PMLComp::y);
-        solver.BackwardTransform(lev, *pml_F, SpIdx::Fz, PMLComp::z);
+        outputs.emplace_back(*pml_E[0], SpIdx::Exx, PMLComp::xx);
+        outputs.emplace_back(*pml_E[1], SpIdx::Eyy, PMLComp::yy);
+        outputs.emplace_back(*pml_E[2], SpIdx::Ezz, PMLComp::zz);
+        outputs.emplace_back(*pml_F, SpIdx::Fx, PMLComp::x);
+        outputs.emplace_back(*pml_F, SpIdx::Fy, PMLComp::y);
+        outputs.emplace_back(*pml_F, SpIdx::Fz, PMLComp::z);
     }
 
     // WarpX::do_pml_divb_cleaning = true
     if (pml_G)
     {
-        solver.BackwardTransform(lev, *pml_B[0], SpIdx::Bxx, PMLComp::xx);
-        solver.BackwardTransform(lev, *pml_B[1], SpIdx::Byy, PMLComp::yy);
-        solver.BackwardTransform(lev, *pml_B[2], SpIdx::Bzz, PMLComp::zz);
-        solver.BackwardTransform(lev, *pml_G, SpIdx::Gx, PMLComp::x);
-        solver.BackwardTransform(lev, *pml_G, SpIdx::Gy, PMLComp::y);
-        solver.BackwardTransform(lev, *pml_G, SpIdx::Gz, PMLComp::z);
+        outputs.emplace_back(*pml_B[0], SpIdx::Bxx, PMLComp::xx);
+        outputs.emplace_back(*pml_B[1], SpIdx::Byy, PMLComp::yy);
+        outputs.emplace_back(*pml_B[2], SpIdx::Bzz, PMLComp::zz);
+        outputs.emplace_back(*pml_G, SpIdx::Gx, PMLComp::x);
+        outputs.emplace_back(*pml_G, SpIdx::Gy, PMLComp::y);
+        outputs.emplace_back(*pml_G, SpIdx::Gz, PMLComp::z);
     }
+
+    solver.BackwardTransform(lev, outputs);
 }
 #endif
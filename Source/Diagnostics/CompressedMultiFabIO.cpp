@@ -0,0 +1,370 @@
+/* This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "CompressedMultiFabIO.H"
+#include "Utils/WarpXProfilerWrapper.H"
+
+#include <AMReX_GpuContainers.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Utility.H>
+#include <AMReX_VisMF.H>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+using namespace amrex;
+
+namespace
+{
+    const std::string header_magic {"WarpX_CompressedMultiFab_V1"};
+
+    /** How the data of a FAB are stored */
+    enum Codec : int { Raw = 0, ShuffleRLE = 1 };
+
+    std::string DataFileName (const std::string& mf_name, const int file_number)
+    {
+        std::ostringstream os;
+        os << mf_name << "_Z_D_" << std::setfill('0') << std::setw(5) << file_number;
+        return os.str();
+    }
+
+    /** Store the b-th byte of the n elements contiguously, for each byte b */
+    void Shuffle (const unsigned char* src, unsigned char* dst,
+                  const std::size_t n, const std::size_t elem_size)
+    {
+        for (std::size_t b = 0; b < elem_size; ++b) {
+            for (std::size_t i = 0; i < n; ++i) {
+                dst[b*n + i] = src[i*elem_size + b];
+            }
+        }
+    }
+
+    /** Inverse of Shuffle */
+    void Unshuffle (const unsigned char* src, unsigned char* dst,
+                    const std::size_t n, const std::size_t elem_size)
+    {
+        for (std::size_t b = 0; b < elem_size; ++b) {
+            for (std::size_t i = 0; i < n; ++i) {
+                dst[i*elem_size + b] = src[b*n + i];
+            }
+        }
+    }
+
+    // A control byte c < 128 is followed by c+1 literal bytes; a control
+    // byte c >= 128 is followed by one byte, repeated c-125 times.
+    constexpr std::size_t max_literal = 128;
+    constexpr std::size_t min_run = 3;
+    constexpr std::size_t max_run = 130;
+
+    void RunLengthEncode (const unsigned char* src, const std::size_t n, std::vector<char>& out)
+    {
+        auto flush_literal = [&] (std::size_t begin, const std::size_t end) {
+            while (begin < end) {
+                const std::size_t len = std::min(end - begin, max_literal);
+                out.push_back(static_cast<char>(len - 1));
+                out.insert(out.end(), src + begin, src + begin + len);
+                begin += len;
+            }
+        };
+
+        std::size_t literal_begin = 0;
+        std::size_t i = 0;
+        while (i < n) {
+            std::size_t run = 1;
+            while (i + run < n && run < max_run && src[i + run] == src[i]) ++run;
+            if (run >= min_run) {
+                flush_literal(literal_begin, i);
+                out.push_back(static_cast<char>(max_literal + run - min_run));
+                out.push_back(static_cast<char>(src[i]));
+                literal_begin = i + run;
+            }
+            i += run;
+        }
+        flush_literal(literal_begin, n);
+    }
+
+    /** Returns false if src does not decode to exactly ndst bytes */
+    bool RunLengthDecode (const unsigned char* src, const std::size_t n,
+                          unsigned char* dst, const std::size_t ndst)
+    {
+        std::size_t pos = 0;
+        std::size_t out = 0;
+        while (pos < n) {
+            const std::size_t c = src[pos++];
+            if (c < max_literal) {
+                const std::size_t len = c + 1;
+                if (pos + len > n || out + len > ndst) return false;
+                std::memcpy(dst + out, src + pos, len);
+                pos += len;
+                out += len;
+            } else {
+                const std::size_t len = c - max_literal + min_run;
+                if (pos >= n || out + len > ndst) return false;
+                std::memset(dst + out, src[pos++], len);
+                out += len;
+            }
+        }
+        return out == ndst;
+    }
+
+    /** Compress n values; falls back to the raw bytes if they do not compress */
+    std::vector<char> CompressFab (const Real* data, const std::size_t n, int& codec)
+    {
+        const std::size_t nbytes = n*sizeof(Real);
+        const auto bytes = reinterpret_cast<const unsigned char*>(data);
+        std::vector<unsigned char> shuffled(nbytes);
+        Shuffle(bytes, shuffled.data(), n, sizeof(Real));
+        std::vector<char> out;
+        out.reserve(nbytes/4);
+        RunLengthEncode(shuffled.data(), nbytes, out);
+        if (out.size() < nbytes) {
+            codec = Codec::ShuffleRLE;
+        } else {
+            codec = Codec::Raw;
+            out.assign(bytes, bytes + nbytes);
+        }
+        return out;
+    }
+
+    bool DecompressFab (const std::vector<char>& blob, const int codec,
+                        Real* data, const std::size_t n)
+    {
+        const std::size_t nbytes = n*sizeof(Real);
+        const auto src = reinterpret_cast<const unsigned char*>(blob.data());
+        if (codec == Codec::Raw) {
+            if (blob.size() != nbytes) return false;
+            std::memcpy(data, src, nbytes);
+            return true;
+        } else if (codec == Codec::ShuffleRLE) {
+            std::vector<unsigned char> shuffled(nbytes);
+            if (!RunLengthDecode(src, blob.size(), shuffled.data(), nbytes)) return false;
+            Unshuffle(shuffled.data(), reinterpret_cast<unsigned char*>(data), n, sizeof(Real));
+            return true;
+        }
+        return false;
+    }
+}
+
+void
+WriteCompressedMultiFab (const MultiFab& mf, const std::string& mf_name)
+{
+    WARPX_PROFILE("WriteCompressedMultiFab()");
+
+    const int nboxes = mf.size();
+    const Vector<int>& local_index = mf.IndexArray();
+    const int nlocal = local_index.size();
+
+#ifdef AMREX_USE_GPU
+    Vector<Gpu::PinnedVector<Real>> staging(nlocal);
+    for (int i = 0; i < nlocal; ++i) {
+        const FArrayBox& fab = mf[local_index[i]];
+        staging[i].resize(fab.size());
+        Gpu::copyAsync(Gpu::deviceToHost, fab.dataPtr(), fab.dataPtr() + fab.size(),
+                       staging[i].begin());
+    }
+    Gpu::synchronize();
+#endif
+
+    std::vector<std::vector<char>> blobs(nlocal);
+    std::vector<int> codecs(nlocal);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < nlocal; ++i) {
+        const FArrayBox& fab = mf[local_index[i]];
+#ifdef AMREX_USE_GPU
+        const Real* data = staging[i].data();
+#else
+        const Real* data = fab.dataPtr();
+#endif
+        blobs[i] = CompressFab(data, fab.size(), codecs[i]);
+    }
+
+    // As in amrex::VisMF, the ranks are grouped into at most VisMF::GetNOutFiles()
+    // data files: rank r writes to file r % nfiles, after the lower ranks of its
+    // group, so that the number of files and of concurrent writers is bounded.
+    const int nprocs = ParallelDescriptor::NProcs();
+    const int myproc = ParallelDescriptor::MyProc();
+    const int nfiles = std::max(1, std::min(VisMF::GetNOutFiles(), nprocs));
+    const int file_number = myproc % nfiles;
+
+    // The offset of each rank in its file follows from the sizes of all ranks
+    Long nbytes = 0;
+    for (int i = 0; i < nlocal; ++i) nbytes += blobs[i].size();
+    Vector<Long> rank_bytes(nprocs, 0);
+    rank_bytes[myproc] = nbytes;
+    ParallelDescriptor::ReduceLongSum(rank_bytes.data(), nprocs);
+    Long rank_offset = 0;
+    for (int r = file_number; r < myproc; r += nfiles) rank_offset += rank_bytes[r];
+
+    // For each box: number of the data file, offset in this file, size and codec.
+    // Only the I/O processor needs them to write the header.
+    Vector<Long> location(4*nboxes, 0);
+    Long offset = rank_offset;
+    for (int i = 0; i < nlocal; ++i) {
+        const int k = local_index[i];
+        location[4*k  ] = file_number;
+        location[4*k+1] = offset;
+        location[4*k+2] = blobs[i].size();
+        location[4*k+3] = codecs[i];
+        offset += blobs[i].size();
+    }
+
+    // The ranks of a file write in turn, each one passing a token to the next
+    const int tag = ParallelDescriptor::SeqNum();
+    const int prev_rank = myproc - nfiles;
+    const int next_rank = myproc + nfiles;
+    int token = 0;
+    if (prev_rank >= 0) ParallelDescriptor::Recv(&token, 1, prev_rank, tag);
+    if (nbytes > 0 || prev_rank < 0) {
+        const std::string data_file = DataFileName(mf_name, file_number);
+        std::ofstream ofs;
+        if (prev_rank < 0) {
+            ofs.open(data_file, std::ios::binary | std::ios::trunc);
+        } else {
+            ofs.open(data_file, std::ios::binary | std::ios::in | std::ios::out);
+            ofs.seekp(rank_offset);
+        }
+        for (int i = 0; i < nlocal; ++i) {
+            ofs.write(blobs[i].data(), blobs[i].size());
+        }
+        if (!ofs) amrex::Abort("WriteCompressedMultiFab: failed to write " + data_file);
+    }
+    if (next_rank < nprocs) ParallelDescriptor::Send(&token, 1, next_rank, tag);
+
+    ParallelDescriptor::ReduceLongSum(location.data(), location.size(),
+                                      ParallelDescriptor::IOProcessorNumber());
+
+    if (ParallelDescriptor::IOProcessor()) {
+        std::ofstream hdr(mf_name + "_Z_H", std::ios::trunc);
+        hdr << header_magic << "\n"
+            << sizeof(Real) << "\n"
+            << mf.nComp() << "\n"
+            << mf.nGrowVect() << "\n";
+        mf.boxArray().writeOn(hdr);
+        hdr << "\n";
+        for (int k = 0; k < nboxes; ++k) {
+            hdr << location[4*k] << " " << location[4*k+1] << " "
+                << location[4*k+2] << " " << location[4*k+3] << "\n";
+        }
+        if (!hdr) amrex::Abort("WriteCompressedMultiFab: failed to write " + mf_name + "_Z_H");
+    }
+}
+
+bool
+CompressedMultiFabExists (const std::string& mf_name)
+{
+    return amrex::FileExists(mf_name + "_Z_H");
+}
+
+void
+ReadCompressedMultiFab (MultiFab& mf, const std::string& mf_name)
+{
+    WARPX_PROFILE("ReadCompressedMultiFab()");
+
+    Vector<char> fileCharPtr;
+    ParallelDescriptor::ReadAndBcastFile(mf_name + "_Z_H", fileCharPtr);
+    std::string fileCharPtrString(fileCharPtr.dataPtr());
+    std::istringstream is(fileCharPtrString, std::istringstream::in);
+
+    std::string magic;
+    int real_size = 0;
+    int ncomp = 0;
+    IntVect ngrow;
+    is >> magic >> real_size >> ncomp >> ngrow;
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(magic == header_magic,
+        mf_name + "_Z_H is not a compressed MultiFab header");
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(real_size == static_cast<int>(sizeof(Real)),
+        mf_name + " was written with a different floating-point precision");
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ncomp == mf.nComp(),
+        mf_name + " was written with a different number of components");
+    BoxArray ba;
+    ba.readFrom(is);
+    const int nboxes = ba.size();
+    Vector<Long> location(4*nboxes);
+    for (auto& v : location) is >> v;
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!is.fail(), mf_name + "_Z_H is corrupted");
+
+    // Read directly into mf if it has the same boxes, whatever their distribution
+    const bool read_direct = (ba == mf.boxArray() && ngrow == mf.nGrowVect());
+    MultiFab tmp;
+    if (!read_direct) tmp.define(ba, DistributionMapping(ba), ncomp, ngrow);
+    MultiFab& dst = read_direct ? mf : tmp;
+
+    const Vector<int>& local_index = dst.IndexArray();
+    const int nlocal = local_index.size();
+    std::vector<std::vector<char>> blobs(nlocal);
+    for (int i = 0; i < nlocal; ++i) {
+        const int k = local_index[i];
+        const std::string data_file = DataFileName(mf_name, static_cast<int>(location[4*k]));
+        blobs[i].resize(location[4*k+2]);
+        std::ifstream ifs(data_file, std::ios::binary);
+        ifs.seekg(location[4*k+1]);
+        ifs.read(blobs[i].data(), blobs[i].size());
+        if (!ifs) amrex::Abort("ReadCompressedMultiFab: failed to read " + data_file);
+    }
+
+#ifdef AMREX_USE_GPU
+    Vector<Gpu::PinnedVector<Real>> staging(nlocal);
+    for (int i = 0; i < nlocal; ++i) {
+        staging[i].resize(dst[local_index[i]].size());
+    }
+#endif
+
+    int nfailed = 0;
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic) reduction(+:nfailed)
+#endif
+    for (int i = 0; i < nlocal; ++i) {
+        FArrayBox& fab = dst[local_index[i]];
+#ifdef AMREX_USE_GPU
+        Real* data = staging[i].data();
+#else
+        Real* data = fab.dataPtr();
+#endif
+        const int codec = static_cast<int>(location[4*local_index[i]+3]);
+        if (!DecompressFab(blobs[i], codec, data, fab.size())) ++nfailed;
+    }
+    if (nfailed > 0) amrex::Abort("ReadCompressedMultiFab: corrupted data in " + mf_name);
+
+#ifdef AMREX_USE_GPU
+    for (int i = 0; i < nlocal; ++i) {
+        Gpu::copyAsync(Gpu::hostToDevice, staging[i].begin(), staging[i].end(),
+                       dst[local_index[i]].dataPtr());
+    }
+    Gpu::synchronize();
+#endif
+
+    if (!read_direct) mf.ParallelCopy(tmp, 0, 0, ncomp);
+}
+
+void
+WriteCheckpointMultiFab (const MultiFab& mf, const std::string& mf_name, const bool compress)
+{
+    if (compress) {
+        WriteCompressedMultiFab(mf, mf_name);
+    } else {
+        VisMF::AsyncWrite(mf, mf_name);
+    }
+}
+
+bool
+CheckpointMultiFabExists (const std::string& mf_name)
+{
+    return CompressedMultiFabExists(mf_name) || VisMF::Exist(mf_name);
+}
+
+void
+ReadCheckpointMultiFab (MultiFab& mf, const std::string& mf_name)
+{
+    if (CompressedMultiFabExists(mf_name)) {
+        ReadCompressedMultiFab(mf, mf_name);
+    } else {
+        VisMF::Read(mf, mf_name);
+    }
+}
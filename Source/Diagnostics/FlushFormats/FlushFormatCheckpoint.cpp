@@ -1,5 +1,6 @@
 #include "FlushFormatCheckpoint.H"
 #include "WarpX.H"
+#include "Diagnostics/CompressedMultiFabIO.H"
 #include "Utils/WarpXProfilerWrapper.H"
 
 #include <AMReX_buildInfo.H>
@@ -11,6 +12,13 @@ namespace
     const std::string default_level_prefix {"Level_"};
 }
 
+FlushFormatCheckpoint::FlushFormatCheckpoint (const std::string& diag_name)
+{
+    ParmParse pp_diag_name(diag_name);
+    pp_diag_name.query("checkpoint_write_current", m_write_current);
+    pp_diag_name.query("checkpoint_compression", m_compression);
+}
+
 void
 FlushFormatCheckpoint::WriteToFile (
         const amrex::Vector<std::string> /*varnames*/,
@@ -43,58 +51,79 @@ FlushFormatCheckpoint::WriteToFile (
 
     WriteJobInfo(checkpointname);
 
+    // Without compression, the field data are copied to a host buffer and written in
+    // the background when AMReX asynchronous output is enabled (amrex.async_out = 1).
     for (int lev = 0; lev < nlev; ++lev)
     {
-        VisMF::Write(warpx.getEfield_fp(lev, 0),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_fp"));
-        VisMF::Write(warpx.getEfield_fp(lev, 1),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_fp"));
-        VisMF::Write(warpx.getEfield_fp(lev, 2),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_fp"));
-        VisMF::Write(warpx.getBfield_fp(lev, 0),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_fp"));
-        VisMF::Write(warpx.getBfield_fp(lev, 1),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_fp"));
-        VisMF::Write(warpx.getBfield_fp(lev, 2),
-                     amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_fp"));
-        if (warpx.getis_synchronized()) {
-            // Need to save j if synchronized because after restart we need j to evolve E by dt/2.
-            VisMF::Write(warpx.getcurrent_fp(lev, 0),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jx_fp"));
-            VisMF::Write(warpx.getcurrent_fp(lev, 1),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jy_fp"));
-            VisMF::Write(warpx.getcurrent_fp(lev, 2),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jz_fp"));
+        WriteCheckpointMultiFab(warpx.getEfield_fp(lev, 0),
+                                amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_fp"),
+                                m_compression);
+        WriteCheckpointMultiFab(warpx.getEfield_fp(lev, 1),
+                                amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_fp"),
+                                m_compression);
+        WriteCheckpointMultiFab(warpx.getEfield_fp(lev, 2),
+                                amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_fp"),
+                                m_compression);
+        WriteCheckpointMultiFab(warpx.getBfield_fp(lev, 0),
+                                amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_fp"),
+                                m_compression);
+        WriteCheckpointMultiFab(warpx.getBfield_fp(lev, 1),
+                                amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_fp"),
+                                m_compression);
+        WriteCheckpointMultiFab(warpx.getBfield_fp(lev, 2),
+                                amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_fp"),
+                                m_compression);
+        if (warpx.getis_synchronized() && m_write_current) {
+            // j is only needed on restart when synchronized; it is redeposited before the
+            // first field push, so it may be skipped to reduce the checkpoint size.
+            WriteCheckpointMultiFab(warpx.getcurrent_fp(lev, 0),
+                                    amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jx_fp"),
+                                    m_compression);
+            WriteCheckpointMultiFab(warpx.getcurrent_fp(lev, 1),
+                                    amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jy_fp"),
+                                    m_compression);
+            WriteCheckpointMultiFab(warpx.getcurrent_fp(lev, 2),
+                                    amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jz_fp"),
+                                    m_compression);
         }
 
         if (lev > 0)
         {
-            VisMF::Write(warpx.getEfield_cp(lev, 0),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_cp"));
-            VisMF::Write(warpx.getEfield_cp(lev, 1),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_cp"));
-            VisMF::Write(warpx.getEfield_cp(lev, 2),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_cp"));
-            VisMF::Write(warpx.getBfield_cp(lev, 0),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_cp"));
-            VisMF::Write(warpx.getBfield_cp(lev, 1),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_cp"));
-            VisMF::Write(warpx.getBfield_cp(lev, 2),
-                         amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_cp"));
-            if (warpx.getis_synchronized()) {
-                // Need to save j if synchronized because after restart we need j to evolve E by dt/2.
-                VisMF::Write(warpx.getcurrent_cp(lev, 0),
-                             amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jx_cp"));
-                VisMF::Write(warpx.getcurrent_cp(lev, 1),
-                             amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jy_cp"));
-                VisMF::Write(warpx.getcurrent_cp(lev, 2),
-                             amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jz_cp"));
+            WriteCheckpointMultiFab(warpx.getEfield_cp(lev, 0),
+                                    amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ex_cp"),
+                                    m_compression);
+            WriteCheckpointMultiFab(warpx.getEfield_cp(lev, 1),
+                                    amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ey_cp"),
+                                    m_compression);
+            WriteCheckpointMultiFab(warpx.getEfield_cp(lev, 2),
+                                    amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Ez_cp"),
+                                    m_compression);
+            WriteCheckpointMultiFab(warpx.getBfield_cp(lev, 0),
+                                    amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bx_cp"),
+                                    m_compression);
+            WriteCheckpointMultiFab(warpx.getBfield_cp(lev, 1),
+                                    amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "By_cp"),
+                                    m_compression);
+            WriteCheckpointMultiFab(warpx.getBfield_cp(lev, 2),
+                                    amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "Bz_cp"),
+                                    m_compression);
+            if (warpx.getis_synchronized() && m_write_current) {
+                WriteCheckpointMultiFab(warpx.getcurrent_cp(lev, 0),
+                                        amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jx_cp"),
+                                        m_compression);
+                WriteCheckpointMultiFab(warpx.getcurrent_cp(lev, 1),
+                                        amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jy_cp"),
+                                        m_compression);
+                WriteCheckpointMultiFab(warpx.getcurrent_cp(lev, 2),
+                                        amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "jz_cp"),
+                                        m_compression);
             }
         }
 
         if (warpx.DoPML() && warpx.GetPML(lev)) {
             warpx.GetPML(lev)->CheckPoint(
-                amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "pml"));
+                amrex::MultiFabFileFullPrefix(lev, checkpointname, default_level_prefix, "pml"),
+                m_compression);
         }
     }
 
@@ -109,6 +138,8 @@ FlushFormatCheckpoint::CheckpointParticles(
     const std::string& dir,
     const amrex::Vector<ParticleDiag>& particle_diags) const
 {
+    // With amrex.async_out = 1, each rank hands its particle data to the
+    // background writer and the particle headers are written by the IO rank only.
     for (unsigned i = 0, n = particle_diags.size(); i < n; ++i) {
         particle_diags[i].getParticleContainer()->Checkpoint(
             dir, particle_diags[i].getSpeciesName());
@@ -13,11 +13,14 @@ FlushFormatOpenPMD::FlushFormatOpenPMD (const std::string& diag_name)
     std::string openpmd_backend {"default"};
     // one file per timestep (or one file for all steps)
     bool openpmd_tspf = true;
+    // write the data in a background thread, while the simulation continues
+    bool openpmd_async = false;
     pp_diag_name.query("openpmd_backend", openpmd_backend);
     pp_diag_name.query("openpmd_tspf", openpmd_tspf);
+    pp_diag_name.query("openpmd_async", openpmd_async);
     auto & warpx = WarpX::GetInstance();
     m_OpenPMDPlotWriter = std::make_unique<WarpXOpenPMDPlot>(
-        openpmd_tspf, openpmd_backend, warpx.getPMLdirections()
+        openpmd_tspf, openpmd_backend, warpx.getPMLdirections(), openpmd_async
     );
 }
 
@@ -75,3 +75,12 @@ MultiDiagnostics::NewIteration ()
         diag->NewIteration();
     }
 }
+
+bool
+MultiDiagnostics::DoDumpCheckpoint (int step, bool force_flush)
+{
+    for( auto& diag : alldiags ){
+        if (diag->IsCheckpoint() && diag->DoComputeAndPack(step, force_flush)) return true;
+    }
+    return false;
+}
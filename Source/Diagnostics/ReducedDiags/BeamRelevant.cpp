@@ -9,7 +9,6 @@
 #include "Utils/WarpXConst.H"
 
 #include <AMReX_REAL.H>
-#include <AMReX_ParticleReduce.H>
 
 #include <iostream>
 #include <cmath>
@@ -133,6 +132,13 @@ void BeamRelevant::ComputeDiags (int step)
     int const index_z = 1;
 #endif
 
+    // number of quantities whose moments are computed
+#if (defined WARPX_DIM_3D || defined WARPX_DIM_RZ)
+    constexpr int nq = 7;
+#elif (defined WARPX_DIM_XZ)
+    constexpr int nq = 6;
+#endif
+
     // loop over species
     for (int i_s = 0; i_s < nSpecies; ++i_s)
     {
@@ -149,265 +155,83 @@ void BeamRelevant::ComputeDiags (int step)
 
         using PType = typename WarpXParticleContainer::SuperParticleType;
 
-        // weight sum
-        Real w_sum = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.rdata(PIdx::w); });
-
-        // reduced sum over mpi ranks
-        ParallelDescriptor::ReduceRealSum(w_sum);
-
-        if (w_sum < std::numeric_limits<Real>::min() )
-        {
-            for (int i = 0; i < static_cast<int>(m_data.size()); ++i){
-                m_data[i] = 0.0_rt;
-            }
-            return;
-        }
-
-#if (defined WARPX_DIM_RZ)
-        // x mean
-        Real x_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.pos(0)*std::cos(p.rdata(PIdx::theta)) * p.rdata(PIdx::w); });
-#else
-        // x mean
-        Real x_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.pos(0) * p.rdata(PIdx::w); });
-#endif
-
-#if (defined WARPX_DIM_3D)
-        // y mean
-        Real y_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.pos(1) * p.rdata(PIdx::w); });
-#elif (defined WARPX_DIM_RZ)
-        // y mean
-        Real y_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.pos(0)*std::sin(p.rdata(PIdx::theta)) * p.rdata(PIdx::w); });
-#endif
-
-        // z mean
-        Real z_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.pos(index_z) * p.rdata(PIdx::w); });
-
-        // ux mean
-        Real ux_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.rdata(PIdx::ux) * p.rdata(PIdx::w); });
-
-        // uy mean
-        Real uy_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.rdata(PIdx::uy) * p.rdata(PIdx::w); });
-
-        // uz mean
-        Real uz_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        { return p.rdata(PIdx::uz) * p.rdata(PIdx::w); });
-
-        // gamma mean
-        Real gm_mean = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
+        // weight sum, means, variances and correlations, in a single pass
+        // over the particles and a single reduction over mpi ranks
+        m_moments.Compute(myspc,
+        [=] AMREX_GPU_HOST_DEVICE (const PType& p, GpuArray<Real,nq>& v) -> Real
         {
-            Real ux = p.rdata(PIdx::ux);
-            Real uy = p.rdata(PIdx::uy);
-            Real uz = p.rdata(PIdx::uz);
-            Real us = ux*ux + uy*uy + uz*uz;
-            return std::sqrt(1.0_rt + us*inv_c2) * p.rdata(PIdx::w);
-        });
-
-        // reduced sum over mpi ranks
-        ParallelDescriptor::ReduceRealSum(x_mean);  x_mean  /= w_sum;
-#if (defined WARPX_DIM_3D || defined WARPX_DIM_RZ)
-        ParallelDescriptor::ReduceRealSum(y_mean);  y_mean  /= w_sum;
-#endif
-        ParallelDescriptor::ReduceRealSum(z_mean);  z_mean  /= w_sum;
-        ParallelDescriptor::ReduceRealSum(ux_mean); ux_mean /= w_sum;
-        ParallelDescriptor::ReduceRealSum(uy_mean); uy_mean /= w_sum;
-        ParallelDescriptor::ReduceRealSum(uz_mean); uz_mean /= w_sum;
-        ParallelDescriptor::ReduceRealSum(gm_mean); gm_mean /= w_sum;
-
 #if (defined WARPX_DIM_RZ)
-        // x mean square
-        Real x_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const x = p.pos(0)*std::cos(p.rdata(PIdx::theta));
-            Real const a = (x-x_mean) * (x-x_mean);
-            return a * p.rdata(PIdx::w);
-        });
-#else
-        // x mean square
-        Real x_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.pos(0)-x_mean) * (p.pos(0)-x_mean);
-            return a * p.rdata(PIdx::w);
-        });
-#endif
-
-#if (defined WARPX_DIM_3D)
-        // y mean square
-        Real y_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.pos(1)-y_mean) * (p.pos(1)-y_mean);
-            return a * p.rdata(PIdx::w);
-        });
-#elif (defined WARPX_DIM_RZ)
-        // y mean square
-        Real y_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const y = p.pos(0)*std::sin(p.rdata(PIdx::theta));
-            Real const a = (y-y_mean) * (y-y_mean);
-            return a * p.rdata(PIdx::w);
-        });
+            Real const theta = p.rdata(PIdx::theta);
+            v[0] = p.pos(0)*std::cos(theta);
+            v[1] = p.pos(0)*std::sin(theta);
+            int const iu = 3;
+#elif (defined WARPX_DIM_3D)
+            v[0] = p.pos(0);
+            v[1] = p.pos(1);
+            int const iu = 3;
+#elif (defined WARPX_DIM_XZ)
+            v[0] = p.pos(0);
+            int const iu = 2;
 #endif
-
-        // z mean square
-        Real z_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.pos(index_z)-z_mean) * (p.pos(index_z)-z_mean);
-            return a * p.rdata(PIdx::w);
-        });
-
-        // ux mean square
-        Real ux_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.rdata(PIdx::ux)-ux_mean) *
-                           (p.rdata(PIdx::ux)-ux_mean);
-            return a * p.rdata(PIdx::w);
-        });
-
-        // uy mean square
-        Real uy_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.rdata(PIdx::uy)-uy_mean) *
-                           (p.rdata(PIdx::uy)-uy_mean);
-            return a * p.rdata(PIdx::w);
-        });
-
-        // uz mean square
-        Real uz_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.rdata(PIdx::uz)-uz_mean) *
-                           (p.rdata(PIdx::uz)-uz_mean);
-            return a * p.rdata(PIdx::w);
-        });
-
-        // gamma mean square
-        Real gm_ms = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
+            v[iu-1] = p.pos(index_z);
             Real const ux = p.rdata(PIdx::ux);
             Real const uy = p.rdata(PIdx::uy);
             Real const uz = p.rdata(PIdx::uz);
             Real const us = ux*ux + uy*uy + uz*uz;
-            Real const gm = std::sqrt(1.0_rt + us*inv_c2);
-            Real const a  = (gm - gm_mean) * (gm - gm_mean);
-            return a * p.rdata(PIdx::w);
-        });
-
-#if (defined WARPX_DIM_RZ)
-        // x times ux
-        Real xux = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const x = p.pos(0)*std::cos(p.rdata(PIdx::theta));
-            Real const a = (x-x_mean) * (p.rdata(PIdx::ux)-ux_mean);
-            return a * p.rdata(PIdx::w);
-        });
-#else
-        // x times ux
-        Real xux = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.pos(0)-x_mean) * (p.rdata(PIdx::ux)-ux_mean);
-            return a * p.rdata(PIdx::w);
-        });
-#endif
-
-#if (defined WARPX_DIM_3D)
-        // y times uy
-        Real yuy = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.pos(1)-y_mean) * (p.rdata(PIdx::uy)-uy_mean);
-            return a * p.rdata(PIdx::w);
+            v[iu]   = ux;
+            v[iu+1] = uy;
+            v[iu+2] = uz;
+            v[iu+3] = std::sqrt(1.0_rt + us*inv_c2);
+            return p.rdata(PIdx::w);
         });
-#elif (defined WARPX_DIM_RZ)
-        // y times uy
-        Real yuy = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const y = p.pos(0)*std::sin(p.rdata(PIdx::theta));
-            Real const a = (y-y_mean) * (p.rdata(PIdx::uy)-uy_mean);
-            return a * p.rdata(PIdx::w);
-        });
-#endif
 
-        // z times uz
-        Real zuz = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            Real const a = (p.pos(index_z)-z_mean) * (p.rdata(PIdx::uz)-uz_mean);
-            return a * p.rdata(PIdx::w);
-        });
+        Real const w_sum = m_moments.Weight();
 
-        // charge
-        Real charge = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
+        if (w_sum < std::numeric_limits<Real>::min() )
         {
-            Real const w = p.rdata(PIdx::w);
-            return q * w;
-        });
+            for (int i = 0; i < static_cast<int>(m_data.size()); ++i){
+                m_data[i] = 0.0_rt;
+            }
+            return;
+        }
 
-        // reduced sum over mpi ranks
-        ParallelDescriptor::ReduceRealSum
-            ( x_ms, ParallelDescriptor::IOProcessorNumber());
-        x_ms /= w_sum;
 #if (defined WARPX_DIM_3D || defined WARPX_DIM_RZ)
-        ParallelDescriptor::ReduceRealSum
-            ( y_ms, ParallelDescriptor::IOProcessorNumber());
-        y_ms /= w_sum;
-#endif
-        ParallelDescriptor::ReduceRealSum
-            ( z_ms, ParallelDescriptor::IOProcessorNumber());
-        z_ms /= w_sum;
-        ParallelDescriptor::ReduceRealSum
-            (ux_ms, ParallelDescriptor::IOProcessorNumber());
-        ux_ms /= w_sum;
-        ParallelDescriptor::ReduceRealSum
-            (uy_ms, ParallelDescriptor::IOProcessorNumber());
-        uy_ms /= w_sum;
-        ParallelDescriptor::ReduceRealSum
-            (uz_ms, ParallelDescriptor::IOProcessorNumber());
-        uz_ms /= w_sum;
-        ParallelDescriptor::ReduceRealSum
-            (gm_ms, ParallelDescriptor::IOProcessorNumber());
-        gm_ms /= w_sum;
-        ParallelDescriptor::ReduceRealSum
-            (   xux, ParallelDescriptor::IOProcessorNumber());
-        xux /= w_sum;
-#if (defined WARPX_DIM_3D || defined WARPX_DIM_RZ)
-        ParallelDescriptor::ReduceRealSum
-            (   yuy, ParallelDescriptor::IOProcessorNumber());
-        yuy /= w_sum;
+        Real const x_mean  = m_moments.Mean(0);
+        Real const y_mean  = m_moments.Mean(1);
+        Real const z_mean  = m_moments.Mean(2);
+        Real const ux_mean = m_moments.Mean(3);
+        Real const uy_mean = m_moments.Mean(4);
+        Real const uz_mean = m_moments.Mean(5);
+        Real const gm_mean = m_moments.Mean(6);
+        Real const x_ms  = m_moments.Moment2(0);
+        Real const y_ms  = m_moments.Moment2(1);
+        Real const z_ms  = m_moments.Moment2(2);
+        Real const ux_ms = m_moments.Moment2(3);
+        Real const uy_ms = m_moments.Moment2(4);
+        Real const uz_ms = m_moments.Moment2(5);
+        Real const gm_ms = m_moments.Moment2(6);
+        Real const xux   = m_moments.Moment2(7);
+        Real const yuy   = m_moments.Moment2(8);
+        Real const zuz   = m_moments.Moment2(9);
+#elif (defined WARPX_DIM_XZ)
+        Real const x_mean  = m_moments.Mean(0);
+        Real const z_mean  = m_moments.Mean(1);
+        Real const ux_mean = m_moments.Mean(2);
+        Real const uy_mean = m_moments.Mean(3);
+        Real const uz_mean = m_moments.Mean(4);
+        Real const gm_mean = m_moments.Mean(5);
+        Real const x_ms  = m_moments.Moment2(0);
+        Real const z_ms  = m_moments.Moment2(1);
+        Real const ux_ms = m_moments.Moment2(2);
+        Real const uy_ms = m_moments.Moment2(3);
+        Real const uz_ms = m_moments.Moment2(4);
+        Real const gm_ms = m_moments.Moment2(5);
+        Real const xux   = m_moments.Moment2(6);
+        Real const zuz   = m_moments.Moment2(7);
 #endif
-        ParallelDescriptor::ReduceRealSum
-            (   zuz, ParallelDescriptor::IOProcessorNumber());
-        zuz /= w_sum;
-        ParallelDescriptor::ReduceRealSum
-            ( charge, ParallelDescriptor::IOProcessorNumber());
+
+        // charge
+        Real const charge = q * w_sum;
 
         // save data
 #if (defined WARPX_DIM_3D || defined WARPX_DIM_RZ)
@@ -0,0 +1,118 @@
+/* This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+
+#include "KernelCounters.H"
+#include "WarpX.H"
+#include "Utils/KernelCounter.H"
+
+using namespace amrex;
+
+// constructor
+KernelCounters::KernelCounters (std::string rd_name)
+    : ReducedDiags{rd_name}
+{
+    // the counters are allocated with the levels, after this constructor
+    WarpX::do_kernel_counters = true;
+
+    constexpr int ncounters = KernelCounter::nkernels*KernelCounter::nquantities;
+    m_row_size = m_nbox_fields + ncounters;
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        if ( m_IsNotRestart )
+        {
+            // open file
+            std::ofstream ofs{m_path + m_rd_name + "." + m_extension, std::ofstream::out};
+            // write header row
+            int c = 0;
+            ofs << "#";
+            ofs << "[" << ++c << "]step()" << m_sep;
+            ofs << "[" << ++c << "]time(s)" << m_sep;
+            ofs << "[" << ++c << "]lev()" << m_sep;
+            ofs << "[" << ++c << "]box()" << m_sep;
+            ofs << "[" << ++c << "]proc()" << m_sep;
+            ofs << "[" << ++c << "]i_low()" << m_sep;
+            ofs << "[" << ++c << "]j_low()" << m_sep;
+            ofs << "[" << ++c << "]k_low()";
+            for (auto const& name : KernelCounter::names)
+            {
+                ofs << m_sep << "[" << ++c << "]" << name << "_time(s)";
+                ofs << m_sep << "[" << ++c << "]" << name << "_calls()";
+                ofs << m_sep << "[" << ++c << "]" << name << "_particles()";
+                ofs << m_sep << "[" << ++c << "]" << name << "_bytes(B)";
+            }
+            ofs << std::endl;
+            // close file
+            ofs.close();
+        }
+    }
+}
+// end constructor
+
+// function that gathers the kernel counters
+void KernelCounters::ComputeDiags (int step)
+{
+    // judge if the diags should be done
+    if (!m_intervals.contains(step+1)) { return; }
+
+    // get a reference to WarpX instance
+    auto& warpx = WarpX::GetInstance();
+
+    const int nLevels = warpx.finestLevel() + 1;
+    constexpr int ncounters = KernelCounter::nkernels*KernelCounter::nquantities;
+
+    // add the times of the kernels that are still running
+    FlushKernelTimers();
+
+    // one row per box, over all levels
+    int nBoxes = 0;
+    for (int lev = 0; lev < nLevels; ++lev)
+    {
+        nBoxes += warpx.boxArray(lev).size();
+    }
+    m_data.assign(static_cast<std::size_t>(nBoxes)*m_row_size, 0.0);
+
+    // index of the first box of level lev in m_data
+    int shift_box = 0;
+
+    for (int lev = 0; lev < nLevels; ++lev)
+    {
+        amrex::LayoutData<KernelCounterArray>* counters = WarpX::getKernelCounters(lev);
+        if (counters)
+        {
+            const amrex::BoxArray& ba = counters->boxArray();
+            const amrex::DistributionMapping& dm = counters->DistributionMap();
+            for (int i : counters->IndexArray())
+            {
+                Real* row = m_data.data() + static_cast<std::size_t>(shift_box + i)*m_row_size;
+                const IntVect& lo = ba[i].smallEnd();
+                row[0] = lev;
+                row[1] = i;
+                row[2] = dm[i];
+                row[3] = lo[0];
+#if (AMREX_SPACEDIM >= 2)
+                row[4] = lo[1];
+#endif
+#if (AMREX_SPACEDIM == 3)
+                row[5] = lo[2];
+#endif
+                KernelCounterArray& c = (*counters)[i];
+                for (int k = 0; k < ncounters; ++k)
+                {
+                    row[m_nbox_fields + k] = c[k];
+                }
+                // start accumulating again for the next output
+                c.fill(0.0);
+            }
+        }
+        shift_box += warpx.boxArray(lev).size();
+    }
+
+    // each box is on one rank: the sum gathers the rows on the IO proc
+    ParallelDescriptor::ReduceRealSum(m_data.data(),
+                                      m_data.size(),
+                                      ParallelDescriptor::IOProcessorNumber());
+}
+// end void KernelCounters::ComputeDiags
@@ -17,7 +17,10 @@ using namespace amrex;
 LoadBalanceCosts::LoadBalanceCosts (std::string rd_name)
     : ReducedDiags{rd_name}
 {
-
+    // rows hold host names and are rewritten at the final step
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+        m_output_format == "text" && m_buffer_size == 1,
+        "LoadBalanceCosts supports only output_format = text and buffer_size = 1");
 }
 
 // function that gathers costs
@@ -189,7 +192,7 @@ void LoadBalanceCosts::ComputeDiags (int step)
 }
 
 // write to file function for cost
-void LoadBalanceCosts::WriteToFile (int step) const
+void LoadBalanceCosts::WriteToFile (int step)
 {
     // open file
     std::ofstream ofs{m_path + m_rd_name + "." + m_extension,
@@ -5,6 +5,7 @@
  * License: BSD-3-Clause-LBNL
  */
 
+#include "KernelCounters.H"
 #include "LoadBalanceCosts.H"
 #include "LoadBalanceEfficiency.H"
 #include "ParticleHistogram.H"
@@ -21,6 +22,7 @@
 #include <AMReX_ParallelDescriptor.H>
 
 #include <fstream>
+#include <map>
 
 using namespace amrex;
 
@@ -79,6 +81,11 @@ MultiReducedDiags::MultiReducedDiags ()
             m_multi_rd[i_rd] =
                 std::make_unique<LoadBalanceCosts>(m_rd_names[i_rd]);
         }
+        else if (rd_type.compare("KernelCounters") == 0)
+        {
+            m_multi_rd[i_rd] =
+                std::make_unique<KernelCounters>(m_rd_names[i_rd]);
+        }
         else if (rd_type.compare("LoadBalanceEfficiency") == 0)
         {
             m_multi_rd[i_rd] =
@@ -112,12 +119,29 @@ MultiReducedDiags::MultiReducedDiags ()
 // call functions to compute diags
 void MultiReducedDiags::ComputeDiags (int step)
 {
+    // ParticleHistogram diags of the same species that are due at this
+    // step are filled together, in a single pass over the particles
+    std::map<int, std::vector<ParticleHistogram*>> histograms;
+
     // loop over all reduced diags
     for (int i_rd = 0; i_rd < static_cast<int>(m_rd_names.size()); ++i_rd)
     {
+        auto histogram = dynamic_cast<ParticleHistogram*>(m_multi_rd[i_rd].get());
+        if (histogram)
+        {
+            if (histogram->m_intervals.contains(step+1)) {
+                histograms[histogram->m_selected_species_id].push_back(histogram);
+            }
+            continue;
+        }
         m_multi_rd[i_rd] -> ComputeDiags(step);
     }
     // end loop over all reduced diags
+
+    for (auto const& species_histograms : histograms)
+    {
+        ParticleHistogram::ComputeDiagsBatched(species_histograms.second);
+    }
 }
 // end void MultiReducedDiags::ComputeDiags
 
@@ -141,3 +165,19 @@ void MultiReducedDiags::WriteToFile (int step)
     // end loop over all reduced diags
 }
 // end void MultiReducedDiags::WriteToFile
+
+// function to write buffered data
+void MultiReducedDiags::Flush ()
+{
+
+    // Only the I/O rank does
+    if ( !ParallelDescriptor::IOProcessor() ) { return; }
+
+    // loop over all reduced diags
+    for (int i_rd = 0; i_rd < static_cast<int>(m_rd_names.size()); ++i_rd)
+    {
+        m_multi_rd[i_rd]->Flush();
+    }
+    // end loop over all reduced diags
+}
+// end void MultiReducedDiags::Flush
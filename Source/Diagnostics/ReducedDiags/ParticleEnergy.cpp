@@ -8,9 +8,9 @@
 #include "ParticleEnergy.H"
 #include "WarpX.H"
 #include "Utils/WarpXConst.H"
+#include "ParticleMoments.H"
 
 #include <AMReX_REAL.H>
-#include <AMReX_ParticleReduce.H>
 
 #include <iostream>
 #include <cmath>
@@ -105,50 +105,45 @@ void ParticleEnergy::ComputeDiags (int step)
 
         using PType = typename WarpXParticleContainer::SuperParticleType;
 
-        // Use amrex::ReduceSum to compute the sum of energies of all particles
-        // held by the current MPI rank, for this species. This involves a loop over all
-        // boxes held by this MPI rank.
-        Real Etot = 0.0_rt;
+        // Compute the sums of the energies and of the weights of all particles
+        // held by the current MPI rank, for this species, in a single pass.
+        // This involves a loop over all boxes held by this MPI rank.
+        GpuArray<Real,2> sums;
         if(myspc.AmIA<PhysicalSpecies::photon>()){
             //Photons have m = 0, but ux,uy and uz are calculated assuming
             //a mass equal to the electron mass. Therefore, photons need a special
             //treatment to calculate the total energy.
             constexpr auto me_c = PhysConst::m_e * PhysConst::c;
-            Etot = ReduceSum( myspc,
-            [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
+            sums = ParticleReduceSumArray<2>( myspc,
+            [=] AMREX_GPU_HOST_DEVICE (const PType& p, GpuArray<Real,2>& v)
             {
                 const auto w  = p.rdata(PIdx::w);
                 const auto ux = p.rdata(PIdx::ux);
                 const auto uy = p.rdata(PIdx::uy);
                 const auto uz = p.rdata(PIdx::uz);
                 const auto us = ux*ux + uy*uy + uz*uz;
-                return std::sqrt(us) * me_c * w;
+                v[0] = std::sqrt(us) * me_c * w;
+                v[1] = w;
             });
         } else {
-            Etot = ReduceSum( myspc,
-            [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
+            sums = ParticleReduceSumArray<2>( myspc,
+            [=] AMREX_GPU_HOST_DEVICE (const PType& p, GpuArray<Real,2>& v)
             {
                 const auto w  = p.rdata(PIdx::w);
                 const auto ux = p.rdata(PIdx::ux);
                 const auto uy = p.rdata(PIdx::uy);
                 const auto uz = p.rdata(PIdx::uz);
                 const auto us = ux*ux + uy*uy + uz*uz;
-                return ( std::sqrt(us*c2 + c2*c2) - c2 ) * m * w;
+                v[0] = ( std::sqrt(us*c2 + c2*c2) - c2 ) * m * w;
+                v[1] = w;
             });
         }
 
-        // Same thing for the particles weights.
-        auto Wtot = ReduceSum( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p) -> Real
-        {
-            return p.rdata(PIdx::w);
-        });
-
         // reduced sum over mpi ranks
         ParallelDescriptor::ReduceRealSum
-            (Etot, ParallelDescriptor::IOProcessorNumber());
-        ParallelDescriptor::ReduceRealSum
-            (Wtot, ParallelDescriptor::IOProcessorNumber());
+            (sums.data(), 2, ParallelDescriptor::IOProcessorNumber());
+        Real const Etot = sums[0];
+        Real const Wtot = sums[1];
 
         // save results for this species i_s into m_data
         m_data[i_s+1] = Etot;
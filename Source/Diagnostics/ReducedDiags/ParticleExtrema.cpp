@@ -8,12 +8,12 @@
 #include "ParticleExtrema.H"
 #include "WarpX.H"
 #include "Utils/WarpXConst.H"
+#include "ParticleMoments.H"
 #if (defined WARPX_QED)
 #include "Particles/ElementaryProcess/QEDInternals/QedChiFunctions.H"
 #endif
 
 #include <AMReX_REAL.H>
-#include <AMReX_ParticleReduce.H>
 
 #include <iostream>
 #include <cmath>
@@ -175,171 +175,51 @@ void ParticleExtrema::ComputeDiags (int step)
 
         using PType = typename WarpXParticleContainer::SuperParticleType;
 
-        // xmin
-#if (defined WARPX_DIM_RZ)
-        Real xmin = ReduceMin( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.pos(0)*std::cos(p.rdata(PIdx::theta)); });
-        ParallelDescriptor::ReduceRealMin(xmin);
-#else
-        Real xmin = ReduceMin( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.pos(0); });
-        ParallelDescriptor::ReduceRealMin(xmin);
-#endif
-
-        // xmax
-#if (defined WARPX_DIM_RZ)
-        Real xmax = ReduceMax( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.pos(0)*std::cos(p.rdata(PIdx::theta)); });
-        ParallelDescriptor::ReduceRealMax(xmax);
-#else
-        Real xmax = ReduceMax( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.pos(0); });
-        ParallelDescriptor::ReduceRealMax(xmax);
-#endif
-
-        // ymin
-#if (defined WARPX_DIM_RZ)
-        Real ymin = ReduceMin( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.pos(0)*std::sin(p.rdata(PIdx::theta)); });
-        ParallelDescriptor::ReduceRealMin(ymin);
-#elif (defined WARPX_DIM_XZ)
-        Real ymin = 0.0_rt;
-#else
-        Real ymin = ReduceMin( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.pos(1); });
-        ParallelDescriptor::ReduceRealMin(ymin);
-#endif
-
-        // ymax
+        // minimum and maximum of x,y,z,ux,uy,uz,gamma,w, in a single pass
+        // over the particles and two reductions over mpi ranks
+        GpuArray<Real,8> vmin, vmax;
+        ParticleReduceMinMaxArray<8>( myspc,
+        [=] AMREX_GPU_HOST_DEVICE (const PType& p, GpuArray<Real,8>& v)
+        {
 #if (defined WARPX_DIM_RZ)
-        Real ymax = ReduceMax( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.pos(0)*std::sin(p.rdata(PIdx::theta)); });
-        ParallelDescriptor::ReduceRealMax(ymax);
+            Real const theta = p.rdata(PIdx::theta);
+            v[0] = p.pos(0)*std::cos(theta);
+            v[1] = p.pos(0)*std::sin(theta);
 #elif (defined WARPX_DIM_XZ)
-        Real ymax = 0.0_rt;
+            v[0] = p.pos(0);
+            v[1] = 0.0_rt;
 #else
-        Real ymax = ReduceMax( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.pos(1); });
-        ParallelDescriptor::ReduceRealMax(ymax);
+            v[0] = p.pos(0);
+            v[1] = p.pos(1);
 #endif
-
-        // zmin
-        Real zmin = ReduceMin( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.pos(index_z); });
-        ParallelDescriptor::ReduceRealMin(zmin);
-
-        // zmax
-        Real zmax = ReduceMax( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.pos(index_z); });
-        ParallelDescriptor::ReduceRealMax(zmax);
-
-        // uxmin
-        Real uxmin = ReduceMin( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.rdata(PIdx::ux); });
-        ParallelDescriptor::ReduceRealMin(uxmin);
-
-        // uxmax
-        Real uxmax = ReduceMax( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.rdata(PIdx::ux); });
-        ParallelDescriptor::ReduceRealMax(uxmax);
-
-        // uymin
-        Real uymin = ReduceMin( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.rdata(PIdx::uy); });
-        ParallelDescriptor::ReduceRealMin(uymin);
-
-        // uymax
-        Real uymax = ReduceMax( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.rdata(PIdx::uy); });
-        ParallelDescriptor::ReduceRealMax(uymax);
-
-        // uzmin
-        Real uzmin = ReduceMin( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.rdata(PIdx::uz); });
-        ParallelDescriptor::ReduceRealMin(uzmin);
-
-        // uzmax
-        Real uzmax = ReduceMax( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.rdata(PIdx::uz); });
-        ParallelDescriptor::ReduceRealMax(uzmax);
-
-        // gmin
-        Real gmin = 0.0_rt;
-        if ( is_photon ) {
-            gmin = ReduceMin( myspc,
-            [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-            {
-                Real ux = p.rdata(PIdx::ux);
-                Real uy = p.rdata(PIdx::uy);
-                Real uz = p.rdata(PIdx::uz);
-                Real us = ux*ux + uy*uy + uz*uz;
-                return std::sqrt(us*inv_c2);
-            });
-        } else {
-            gmin = ReduceMin( myspc,
-            [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-            {
-                Real ux = p.rdata(PIdx::ux);
-                Real uy = p.rdata(PIdx::uy);
-                Real uz = p.rdata(PIdx::uz);
-                Real us = ux*ux + uy*uy + uz*uz;
-                return std::sqrt(1.0_rt + us*inv_c2);
-            });
-        }
-        ParallelDescriptor::ReduceRealMin(gmin);
-
-        // gmax
-        Real gmax = 0.0_rt;
-        if ( is_photon ) {
-            gmax = ReduceMax( myspc,
-            [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-            {
-                Real ux = p.rdata(PIdx::ux);
-                Real uy = p.rdata(PIdx::uy);
-                Real uz = p.rdata(PIdx::uz);
-                Real us = ux*ux + uy*uy + uz*uz;
-                return std::sqrt(us*inv_c2);
-            });
-        } else {
-            gmax = ReduceMax( myspc,
-            [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-            {
-                Real ux = p.rdata(PIdx::ux);
-                Real uy = p.rdata(PIdx::uy);
-                Real uz = p.rdata(PIdx::uz);
-                Real us = ux*ux + uy*uy + uz*uz;
-                return std::sqrt(1.0_rt + us*inv_c2);
-            });
-        }
-        ParallelDescriptor::ReduceRealMax(gmax);
-
-        // wmin
-        Real wmin = ReduceMin( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.rdata(PIdx::w); });
-        ParallelDescriptor::ReduceRealMin(wmin);
-
-        // wmax
-        Real wmax = ReduceMax( myspc,
-        [=] AMREX_GPU_HOST_DEVICE (const PType& p)
-        { return p.rdata(PIdx::w); });
-        ParallelDescriptor::ReduceRealMax(wmax);
+            v[2] = p.pos(index_z);
+            Real const ux = p.rdata(PIdx::ux);
+            Real const uy = p.rdata(PIdx::uy);
+            Real const uz = p.rdata(PIdx::uz);
+            Real const us = ux*ux + uy*uy + uz*uz;
+            v[3] = ux;
+            v[4] = uy;
+            v[5] = uz;
+            v[6] = is_photon ? std::sqrt(us*inv_c2) : std::sqrt(1.0_rt + us*inv_c2);
+            v[7] = p.rdata(PIdx::w);
+        }, vmin, vmax);
+
+        Real const xmin  = vmin[0];
+        Real const xmax  = vmax[0];
+        Real const ymin  = vmin[1];
+        Real const ymax  = vmax[1];
+        Real const zmin  = vmin[2];
+        Real const zmax  = vmax[2];
+        Real const uxmin = vmin[3];
+        Real const uxmax = vmax[3];
+        Real const uymin = vmin[4];
+        Real const uymax = vmax[4];
+        Real const uzmin = vmin[5];
+        Real const uzmax = vmax[5];
+        Real const gmin  = vmin[6];
+        Real const gmax  = vmax[6];
+        Real const wmin  = vmin[7];
+        Real const wmax  = vmax[7];
 
 #if (defined WARPX_QED)
         // get number of level (int)
@@ -137,6 +137,34 @@ void ParticleHistogram::ComputeDiags (int step)
     // Judge if the diags should be done
     if (!m_intervals.contains(step+1)) return;
 
+    ComputeDiagsBatched({this});
+
+}
+// end void ParticleHistogram::ComputeDiags
+
+namespace
+{
+    /** Parameters of one histogram in a batch, copied to the device */
+    struct HistogramParams
+    {
+        HostDeviceParser<ParticleHistogram::m_nvars> fun_partparser;
+        HostDeviceParser<ParticleHistogram::m_nvars> fun_filterparser;
+        Real bin_min;
+        Real bin_size;
+        int num_bins;
+        int offset;
+        bool do_parser_filter;
+        bool is_unity_particle_weight;
+    };
+}
+
+// function that fills several histograms of one species in one pass
+void ParticleHistogram::ComputeDiagsBatched (std::vector<ParticleHistogram*> const& histograms)
+{
+    if (histograms.empty()) return;
+
+    int const species_id = histograms[0]->m_selected_species_id;
+
     // get a reference to WarpX instance
     auto & warpx = WarpX::GetInstance();
 
@@ -147,26 +175,33 @@ void ParticleHistogram::ComputeDiags (int step)
     const auto & mypc = warpx.GetPartContainer();
 
     // get WarpXParticleContainer class object
-    auto & myspc = mypc.GetParticleContainer(m_selected_species_id);
-
-    // get parser
-    HostDeviceParser<m_nvars> fun_partparser = getParser(m_parser);
-
-    // get filter parser
-    HostDeviceParser<m_nvars> fun_filterparser = getParser(m_parser_filter);
-
-    // declare local variables
-    auto const num_bins = m_bin_num;
-    Real const bin_min  = m_bin_min;
-    Real const bin_size = m_bin_size;
-    const bool is_unity_particle_weight =
-        (m_norm == NormalizationType::unity_particle_weight) ? true : false;
+    auto & myspc = mypc.GetParticleContainer(species_id);
 
-    bool const do_parser_filter = m_do_parser_filter;
+    // all histograms are stored one after the other in one array
+    int const num_hist = static_cast<int>(histograms.size());
+    Gpu::HostVector<HistogramParams> h_params(num_hist);
+    int total_bins = 0;
+    for (int ih = 0; ih < num_hist; ++ih)
+    {
+        ParticleHistogram const* h = histograms[ih];
+        AMREX_ALWAYS_ASSERT(h->m_selected_species_id == species_id);
+        h_params[ih].fun_partparser = getParser(h->m_parser);
+        h_params[ih].fun_filterparser = getParser(h->m_parser_filter);
+        h_params[ih].bin_min = h->m_bin_min;
+        h_params[ih].bin_size = h->m_bin_size;
+        h_params[ih].num_bins = h->m_bin_num;
+        h_params[ih].offset = total_bins;
+        h_params[ih].do_parser_filter = h->m_do_parser_filter;
+        h_params[ih].is_unity_particle_weight =
+            (h->m_norm == NormalizationType::unity_particle_weight) ? true : false;
+        total_bins += h->m_bin_num;
+    }
+    Gpu::DeviceVector<HistogramParams> d_params(num_hist);
+    Gpu::copyAsync(Gpu::hostToDevice, h_params.begin(), h_params.end(), d_params.begin());
+    HistogramParams const* const AMREX_RESTRICT dptr_params = d_params.dataPtr();
 
-    // zero-out old data on the host
-    std::fill(m_data.begin(), m_data.end(), amrex::Real(0.0));
-    amrex::Gpu::DeviceVector< amrex::Real > d_data( m_data.size(), 0.0 );
+    // zero-out old data
+    amrex::Gpu::DeviceVector< amrex::Real > d_data( total_bins, 0.0 );
     amrex::Real* const AMREX_RESTRICT dptr_data = d_data.dataPtr();
 
     int const nlevs = std::max(0, myspc.finestLevel()+1);
@@ -175,6 +210,15 @@ void ParticleHistogram::ComputeDiags (int step)
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
         {
+#ifdef AMREX_USE_GPU
+            // on GPU, accumulate into the shared bins with atomics
+            amrex::Real* const AMREX_RESTRICT dptr_bins = dptr_data;
+#else
+            // on CPU, each thread accumulates into its own private bins,
+            // so that no atomic operation is needed in the particle loop
+            std::vector<amrex::Real> thread_data(total_bins, 0.0_rt);
+            amrex::Real* const AMREX_RESTRICT dptr_bins = thread_data.data();
+#endif
             for (WarpXParIter pti(myspc, lev); pti.isValid(); ++pti)
             {
                 auto const GetPosition = GetParticlePosition(pti);
@@ -187,7 +231,6 @@ void ParticleHistogram::ComputeDiags (int step)
 
                 long const np = pti.numParticles();
 
-                //Flag particles that need to be copied if they cross the z_slice
                 amrex::ParallelFor(np,
                    [=] AMREX_GPU_DEVICE(int i)
                 {
@@ -198,39 +241,66 @@ void ParticleHistogram::ComputeDiags (int step)
                     auto const uy = d_uy[i] / PhysConst::c;
                     auto const uz = d_uz[i] / PhysConst::c;
 
-                    // don't count a particle if it is filtered out
-                    if (do_parser_filter)
-                        if (!fun_filterparser(t, x, y, z, ux, uy, uz))
-                            return;
-                    // continue function if particle is not filtered out
-                    auto const f = fun_partparser(t, x, y, z, ux, uy, uz);
-
-                    // determine particle bin
-                    int const bin = int(Math::floor((f-bin_min)/bin_size));
-                    if ( bin<0 || bin>=num_bins ) return; // discard if out-of-range
-
-                    // add particle to histogram bin
-                    //! @todo performance: on CPU, we are probably faster by
-                    //        letting each thread compute its own histogram and
-                    //        then we reduce the histograms after the loop
-                    if ( is_unity_particle_weight ) {
-                        amrex::HostDevice::Atomic::Add(&dptr_data[bin], 1.0_rt);
-                    } else {
-                        amrex::HostDevice::Atomic::Add(&dptr_data[bin], w);
+                    for (int ih = 0; ih < num_hist; ++ih)
+                    {
+                        HistogramParams const& p = dptr_params[ih];
+
+                        // don't count a particle if it is filtered out
+                        if (p.do_parser_filter)
+                            if (!p.fun_filterparser(t, x, y, z, ux, uy, uz))
+                                continue;
+                        // continue function if particle is not filtered out
+                        auto const f = p.fun_partparser(t, x, y, z, ux, uy, uz);
+
+                        // determine particle bin
+                        int const bin = int(Math::floor((f-p.bin_min)/p.bin_size));
+                        if ( bin<0 || bin>=p.num_bins ) continue; // discard if out-of-range
+
+                        // add particle to histogram bin
+                        amrex::Real const value = p.is_unity_particle_weight ? 1.0_rt : w;
+#ifdef AMREX_USE_GPU
+                        amrex::HostDevice::Atomic::Add(&dptr_bins[p.offset+bin], value);
+#else
+                        dptr_bins[p.offset+bin] += value;
+#endif
                     }
                 });
             }
+#ifndef AMREX_USE_GPU
+            // reduce the private bins of all threads
+#ifdef AMREX_USE_OMP
+#pragma omp critical (particle_histogram_reduce)
+#endif
+            for (int ib = 0; ib < total_bins; ++ib) {
+                dptr_data[ib] += thread_data[ib];
+            }
+#endif
         }
     }
 
     // blocking copy from device to host
+    std::vector<amrex::Real> h_data(total_bins);
     amrex::Gpu::copy(amrex::Gpu::deviceToHost,
-        d_data.begin(), d_data.end(), m_data.begin());
+        d_data.begin(), d_data.end(), h_data.begin());
 
-    // reduced sum over mpi ranks
+    // reduced sum over mpi ranks, for all histograms at once
     ParallelDescriptor::ReduceRealSum
-        (m_data.data(), m_data.size(), ParallelDescriptor::IOProcessorNumber());
+        (h_data.data(), h_data.size(), ParallelDescriptor::IOProcessorNumber());
 
+    for (int ih = 0; ih < num_hist; ++ih)
+    {
+        ParticleHistogram* h = histograms[ih];
+        std::copy(h_data.begin() + h_params[ih].offset,
+                  h_data.begin() + h_params[ih].offset + h->m_bin_num,
+                  h->m_data.begin());
+        h->Normalize();
+    }
+
+}
+// end void ParticleHistogram::ComputeDiagsBatched
+
+void ParticleHistogram::Normalize ()
+{
     // normalize the maximum value to be one
     if ( m_norm == NormalizationType::max_to_unity )
     {
@@ -262,4 +332,4 @@ void ParticleHistogram::ComputeDiags (int step)
     }
 
 }
-// end void ParticleHistogram::ComputeDiags
+// end void ParticleHistogram::Normalize
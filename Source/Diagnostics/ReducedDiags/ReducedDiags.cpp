@@ -12,6 +12,7 @@
 #include <AMReX_Utility.H>
 
 #include <iomanip>
+#include <sstream>
 
 using namespace amrex;
 
@@ -31,6 +32,17 @@ ReducedDiags::ReducedDiags (std::string rd_name)
     // read extension
     pp_rd_name.query("extension", m_extension);
 
+    // read output format
+    pp_rd_name.query("output_format", m_output_format);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+        m_output_format == "text" || m_output_format == "binary",
+        "<reduced_diags_name>.output_format must be text or binary");
+
+    // read number of buffered rows
+    pp_rd_name.query("buffer_size", m_buffer_size);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_buffer_size >= 1,
+        "<reduced_diags_name>.buffer_size must be at least 1");
+
     // check if it is a restart run
     std::string restart_chkfile = "";
     ParmParse pp_amr("amr");
@@ -48,6 +60,12 @@ ReducedDiags::ReducedDiags (std::string rd_name)
         {
             std::ofstream ofs{m_path+m_rd_name+"."+m_extension, std::ios::trunc};
             ofs.close();
+            if (m_output_format == "binary")
+            {
+                std::ofstream ofs_bin{m_path+m_rd_name+".bin",
+                    std::ios::trunc | std::ios::binary};
+                ofs_bin.close();
+            }
         }
     }
 
@@ -72,38 +90,120 @@ void ReducedDiags::BackwardCompatibility ()
     }
 }
 
+// destructor
+ReducedDiags::~ReducedDiags ()
+{
+    Flush();
+}
+
 // write to file function
-void ReducedDiags::WriteToFile (int step) const
+void ReducedDiags::WriteToFile (int step)
 {
 
-    // open file
-    std::ofstream ofs{m_path + m_rd_name + "." + m_extension,
-        std::ofstream::out | std::ofstream::app};
+    // get time
+    Real const time = WarpX::GetInstance().gett_new(0);
+
+    // m_data holds one row, or several rows of m_row_size values
+    std::size_t const row_size = (m_row_size > 0) ? m_row_size : m_data.size();
+    std::size_t const nrows = (m_row_size > 0) ? m_data.size()/row_size : 1;
+    m_ncols = static_cast<int>(row_size) + 2;
+
+    for (std::size_t irow = 0; irow < nrows; ++irow)
+    {
+        AppendRow(step, time, m_data.data() + irow*row_size, row_size);
+    }
+
+    // write the buffered rows once the buffer is full
+    ++m_buffered_rows;
+    if (m_buffered_rows >= m_buffer_size) { Flush(); }
+
+}
+// end ReducedDiags::WriteToFile
+
+void ReducedDiags::AppendRow (int step, Real time, Real const* data, std::size_t n)
+{
+    if (m_output_format == "binary")
+    {
+        // row of doubles: step, time, data
+        std::vector<double> row;
+        row.reserve(n+2);
+        row.push_back(static_cast<double>(step+1));
+        row.push_back(static_cast<double>(time));
+        for (std::size_t i = 0; i < n; ++i) { row.push_back(static_cast<double>(data[i])); }
+        m_buffer.append(reinterpret_cast<char const*>(row.data()),
+                        row.size()*sizeof(double));
+    }
+    else
+    {
+        std::ostringstream ss;
+
+        // write step
+        ss << step+1;
+
+        ss << m_sep;
 
-    // write step
-    ofs << step+1;
+        // set precision
+        ss << std::fixed << std::setprecision(14) << std::scientific;
 
-    ofs << m_sep;
+        // write time
+        ss << time;
 
-    // set precision
-    ofs << std::fixed << std::setprecision(14) << std::scientific;
+        // loop over data size and write
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            ss << m_sep;
+            ss << data[i];
+        }
+        // end loop over data size
 
-    // write time
-    ofs << WarpX::GetInstance().gett_new(0);
+        // end line
+        ss << "\n";
 
-    // loop over data size and write
-    for (int i = 0; i < static_cast<int>(m_data.size()); ++i)
+        m_buffer.append(ss.str());
+    }
+}
+
+void ReducedDiags::Flush ()
+{
+    if (m_buffered_rows == 0) { return; }
+
+    // open file, once
+    if (!m_ofs.is_open())
     {
-        ofs << m_sep;
-        ofs << m_data[i];
+        if (m_output_format == "binary")
+        {
+            std::string const filename = m_path + m_rd_name + ".bin";
+            // header is written once, at the beginning of the file
+            bool const empty_file = (std::ifstream{filename}.peek() == std::ifstream::traits_type::eof());
+            m_ofs.open(filename, std::ofstream::out | std::ofstream::app | std::ofstream::binary);
+            if (empty_file)
+            {
+                WriteBinaryHeader(m_ncols);
+            }
+        }
+        else
+        {
+            m_ofs.open(m_path + m_rd_name + "." + m_extension,
+                       std::ofstream::out | std::ofstream::app);
+        }
     }
-    // end loop over data size
 
-    // end line
-    ofs << std::endl;
+    m_ofs.write(m_buffer.data(), m_buffer.size());
+    m_ofs.flush();
 
-    // close file
-    ofs.close();
+    m_buffer.clear();
+    m_buffered_rows = 0;
+}
+// end ReducedDiags::Flush
 
+void ReducedDiags::WriteBinaryHeader (int ncols)
+{
+    // column names, from the header row of the text output file
+    std::string columns;
+    std::ifstream ifs{m_path + m_rd_name + "." + m_extension};
+    std::getline(ifs, columns);
+
+    m_ofs << "# WarpX reduced diagnostics: rows of " << ncols
+          << " float64 values (native byte order) follow this header\n";
+    m_ofs << columns << "\n";
 }
-// end ReducedDiags::WriteToFile
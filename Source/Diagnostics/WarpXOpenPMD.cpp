@@ -12,10 +12,13 @@
 #include "Utils/WarpXUtil.H"
 
 #include <AMReX_AmrParticles.H>
+#include <AMReX_Arena.H>
+#include <AMReX_GpuContainers.H>
 #include <AMReX_ParallelDescriptor.H>
 
 #include <algorithm>
 #include <cstdint>
+#include <future>
 #include <map>
 #include <set>
 #include <string>
@@ -196,12 +199,31 @@ namespace detail
 
 #ifdef WARPX_USE_OPENPMD
 WarpXOpenPMDPlot::WarpXOpenPMDPlot(bool oneFilePerTS,
-    std::string openPMDFileType, std::vector<bool> fieldPMLdirections)
+    std::string openPMDFileType, std::vector<bool> fieldPMLdirections, bool async)
   :m_Series(nullptr),
    m_OneFilePerTS(oneFilePerTS),
    m_OpenPMDFileType(std::move(openPMDFileType)),
-   m_fieldPMLdirections(std::move(fieldPMLdirections))
+   m_fieldPMLdirections(std::move(fieldPMLdirections)),
+   m_Async(async)
 {
+#if defined(AMREX_USE_MPI)
+  // The background thread calls MPI (through the I/O library) while the
+  // simulation communicates: this needs MPI_THREAD_MULTIPLE, and a separate
+  // communicator so that the collective operations of both threads do not mix.
+  if( m_Async && amrex::ParallelDescriptor::NProcs() > 1 )
+  {
+    int provided = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&provided);
+    if( provided < MPI_THREAD_MULTIPLE ) {
+      amrex::Warning("openPMD: asynchronous output requires MPI_THREAD_MULTIPLE, "
+                     "writing synchronously instead");
+      m_Async = false;
+    } else {
+      MPI_Comm_dup(amrex::ParallelDescriptor::Communicator(), &m_AsyncComm);
+    }
+  }
+#endif
+
   // pick first available backend if default is chosen
   if( m_OpenPMDFileType == "default" )
 #if openPMD_HAVE_ADIOS2==1
@@ -217,11 +239,58 @@ WarpXOpenPMDPlot::WarpXOpenPMDPlot(bool oneFilePerTS,
 
 WarpXOpenPMDPlot::~WarpXOpenPMDPlot()
 {
+  WaitForPendingFlush();
   if( m_Series )
   {
     m_Series->flush();
     m_Series.reset( nullptr );
   }
+#if defined(AMREX_USE_MPI)
+  if( m_AsyncComm != MPI_COMM_NULL )
+    MPI_Comm_free(&m_AsyncComm);
+#endif
+}
+
+void
+WarpXOpenPMDPlot::WaitForPendingFlush ()
+{
+  if( m_PendingFlush.valid() )
+  {
+    WARPX_PROFILE("WarpXOpenPMDPlot::WaitForPendingFlush()");
+    // rethrows the exceptions of the background thread, if any
+    m_PendingFlush.get();
+  }
+}
+
+void
+WarpXOpenPMDPlot::Flush () const
+{
+  if( !m_DeferFlush )
+    m_Series->flush();
+}
+
+template <typename T>
+std::shared_ptr<T>
+WarpXOpenPMDPlot::ChunkBuffer (std::size_t n) const
+{
+  if( m_DeferFlush )
+    // the staging area owns the memory
+    return std::shared_ptr<T>(m_Staging.Alloc<T>(n), [](T const *){});
+  else
+    return std::shared_ptr<T>(new T[n], [](T const *p){ delete[] p; });
+}
+
+template <typename T>
+std::shared_ptr<T const>
+WarpXOpenPMDPlot::StageChunk (T const* src, std::size_t n) const
+{
+  if( !m_DeferFlush )
+    return openPMD::shareRaw(src);
+
+  // src may be overwritten or freed before the background flush reads it
+  T* staged = m_Staging.Alloc<T>(n);
+  amrex::Gpu::copy(amrex::Gpu::deviceToHost, src, src + n, staged);
+  return std::shared_ptr<T const>(staged, [](T const *){});
 }
 
 std::string
@@ -244,6 +313,12 @@ void WarpXOpenPMDPlot::SetStep (int ts, const std::string& dirPrefix,
 {
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE(ts >= 0 , "openPMD iterations are unsigned");
 
+    // the series and the staging buffers are in use until the previous step is written
+    WaitForPendingFlush();
+    m_Staging.Reset();
+    // the back-transformed diagnostics write a snapshot in several flushes, synchronously
+    m_DeferFlush = m_Async && !isBTD;
+
     m_dirPrefix = dirPrefix;
 
     if( ! isBTD ) {
@@ -267,8 +342,17 @@ void WarpXOpenPMDPlot::CloseStep (bool isBTD, bool isLastBTDFlush)
     // close BTD file only when isLastBTDFlush is true
     if (isBTD and !isLastBTDFlush) callClose = false;
     if (callClose) {
-        if (m_Series)
-            m_Series->iterations[m_CurrentStep].close();
+        if (m_Series) {
+            if (m_DeferFlush) {
+                // write the staged data in the background; the next SetStep waits for it
+                auto series_iteration = m_Series->iterations[m_CurrentStep];
+                m_PendingFlush = std::async(std::launch::async, [series_iteration] () mutable {
+                    series_iteration.close();
+                });
+            } else {
+                m_Series->iterations[m_CurrentStep].close();
+            }
+        }
 
         // create a little helper file for ParaView 5.9+
         if (amrex::ParallelDescriptor::IOProcessor())
@@ -301,10 +385,9 @@ WarpXOpenPMDPlot::Init (openPMD::Access access, bool isBTD)
 
     if (amrex::ParallelDescriptor::NProcs() > 1) {
 #if defined(AMREX_USE_MPI)
-        m_Series = std::make_unique<openPMD::Series>(
-                filepath, access,
-                amrex::ParallelDescriptor::Communicator()
-        );
+        MPI_Comm const comm = (m_AsyncComm != MPI_COMM_NULL) ?
+            m_AsyncComm : amrex::ParallelDescriptor::Communicator();
+        m_Series = std::make_unique<openPMD::Series>(filepath, access, comm);
         m_MPISize = amrex::ParallelDescriptor::NProcs();
         m_MPIRank = amrex::ParallelDescriptor::MyProc();
 #else
@@ -475,7 +558,7 @@ WarpXOpenPMDPlot::DumpToFile (ParticleContainer* pc,
   SetupRealProperties(currSpecies, write_real_comp, real_comp_names, write_int_comp, int_comp_names, counter.GetTotalNumParticles());
 
   // open files from all processors, in case some will not contribute below
-  m_Series->flush();
+  Flush();
 
   for (auto currentLevel = 0; currentLevel <= pc->finestLevel(); currentLevel++)
     {
@@ -494,10 +577,8 @@ WarpXOpenPMDPlot::DumpToFile (ParticleContainer* pc,
            auto const positionComponents = detail::getParticlePositionComponentLabels();
 #if defined(WARPX_DIM_RZ)
            {
-              std::shared_ptr<amrex::ParticleReal> z(
-                      new amrex::ParticleReal[numParticleOnTile],
-                      [](amrex::ParticleReal const *p) { delete[] p; }
-              );
+              std::shared_ptr<amrex::ParticleReal> z =
+                  ChunkBuffer<amrex::ParticleReal>(numParticleOnTile);
               for (auto i = 0; i < numParticleOnTile; i++)
                   z.get()[i] = aos[i].pos(1);  // {0: "r", 1: "z"}
               std::string const positionComponent = "z";
@@ -511,14 +592,10 @@ WarpXOpenPMDPlot::DumpToFile (ParticleContainer* pc,
            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(int(soa.GetRealData(PIdx::theta).size()) == numParticleOnTile,
                                             "openPMD: theta and tile size do not match");
            {
-               std::shared_ptr< amrex::ParticleReal > x(
-                       new amrex::ParticleReal[numParticleOnTile],
-                       [](amrex::ParticleReal const *p){ delete[] p; }
-               );
-               std::shared_ptr< amrex::ParticleReal > y(
-                       new amrex::ParticleReal[numParticleOnTile],
-                       [](amrex::ParticleReal const *p){ delete[] p; }
-               );
+               std::shared_ptr< amrex::ParticleReal > x =
+                   ChunkBuffer<amrex::ParticleReal>(numParticleOnTile);
+               std::shared_ptr< amrex::ParticleReal > y =
+                   ChunkBuffer<amrex::ParticleReal>(numParticleOnTile);
                for (auto i=0; i<numParticleOnTile; i++) {
                    auto const r = aos[i].pos(0);  // {0: "r", 1: "z"}
                    x.get()[i] = r * std::cos(theta[i]);
@@ -529,10 +606,8 @@ WarpXOpenPMDPlot::DumpToFile (ParticleContainer* pc,
            }
 #else
            for (auto currDim = 0; currDim < AMREX_SPACEDIM; currDim++) {
-                std::shared_ptr< amrex::ParticleReal > curr(
-                    new amrex::ParticleReal[numParticleOnTile],
-                    [](amrex::ParticleReal const *p){ delete[] p; }
-                );
+                std::shared_ptr< amrex::ParticleReal > curr =
+                    ChunkBuffer<amrex::ParticleReal>(numParticleOnTile);
                 for (auto i=0; i<numParticleOnTile; i++) {
                      curr.get()[i] = aos[i].pos(currDim);
                 }
@@ -542,10 +617,7 @@ WarpXOpenPMDPlot::DumpToFile (ParticleContainer* pc,
 #endif
 
            // save particle ID after converting it to a globally unique ID
-           std::shared_ptr< uint64_t > ids(
-               new uint64_t[numParticleOnTile],
-               [](uint64_t const *p){ delete[] p; }
-           );
+           std::shared_ptr< uint64_t > ids = ChunkBuffer<uint64_t>(numParticleOnTile);
            for (auto i=0; i<numParticleOnTile; i++) {
                ids.get()[i] = WarpXUtilIO::localIDtoGlobal( aos[i].id(), aos[i].cpu() );
            }
@@ -562,7 +634,7 @@ WarpXOpenPMDPlot::DumpToFile (ParticleContainer* pc,
          offset += numParticleOnTile64;
       }
     }
-    m_Series->flush();
+    Flush();
 }
 
 void
@@ -676,10 +748,8 @@ WarpXOpenPMDPlot::SaveRealProperty (ParticleIter& pti,
           auto currRecord = currSpecies[record_name];
           auto currRecordComp = currRecord[component_name];
 
-          std::shared_ptr< amrex::ParticleReal > d(
-              new amrex::ParticleReal[numParticleOnTile],
-              [](amrex::ParticleReal const *p){ delete[] p; }
-          );
+          std::shared_ptr< amrex::ParticleReal > d =
+              ChunkBuffer<amrex::ParticleReal>(numParticleOnTile);
 
           for( auto kk=0; kk<numParticleOnTile; kk++ )
                d.get()[kk] = aos[kk].rdata(idx);
@@ -703,7 +773,8 @@ WarpXOpenPMDPlot::SaveRealProperty (ParticleIter& pti,
     for (auto idx=0; idx<real_counter; idx++) {
       auto ii = m_NumAoSRealAttributes + idx;
       if (write_real_comp[ii]) {
-        getComponentRecord(real_comp_names[ii]).storeChunk(openPMD::shareRaw(soa.GetRealData(idx)),
+        getComponentRecord(real_comp_names[ii]).storeChunk(
+          StageChunk(soa.GetRealData(idx).dataPtr(), numParticleOnTile),
           {offset}, {numParticleOnTile64});
       }
     }
@@ -714,7 +785,8 @@ WarpXOpenPMDPlot::SaveRealProperty (ParticleIter& pti,
     for (auto idx=0; idx<int_counter; idx++) {
       auto ii = m_NumAoSIntAttributes + idx; // jump over AoS names
       if (write_int_comp[ii]) {
-        getComponentRecord(int_comp_names[ii]).storeChunk(openPMD::shareRaw(soa.GetIntData(idx)),
+        getComponentRecord(int_comp_names[ii]).storeChunk(
+          StageChunk(soa.GetIntData(idx).dataPtr(), numParticleOnTile),
           {offset}, {numParticleOnTile64});
       }
     }
@@ -943,17 +1015,44 @@ WarpXOpenPMDPlot::WriteOpenPMDFields ( //const std::string& filename,
 
       // Write local data
       amrex::Real const * local_data = fab.dataPtr( icomp );
-      mesh_comp.storeChunk( openPMD::shareRaw(local_data),
+      mesh_comp.storeChunk( StageChunk(local_data, local_box.numPts()),
                             chunk_offset, chunk_size );
     }
   }
   // Flush data to disk after looping over all components
-  m_Series->flush();
+  Flush();
 }
 #endif // WARPX_USE_OPENPMD
 
 
 
+//
+//
+//
+OpenPMDStagingArea::~OpenPMDStagingArea ()
+{
+  for( auto& buffer : m_buffers )
+    amrex::The_Pinned_Arena()->free(buffer.m_ptr);
+}
+
+void*
+OpenPMDStagingArea::AllocBytes (std::size_t nbytes)
+{
+  if( m_next == m_buffers.size() )
+    m_buffers.emplace_back();
+
+  // never return a null pointer, openPMD rejects it even for empty chunks
+  nbytes = std::max(nbytes, std::size_t(1));
+  Buffer& buffer = m_buffers[m_next++];
+  if( buffer.m_size < nbytes )
+  {
+    amrex::The_Pinned_Arena()->free(buffer.m_ptr);
+    buffer.m_ptr = amrex::The_Pinned_Arena()->alloc(nbytes);
+    buffer.m_size = nbytes;
+  }
+  return buffer.m_ptr;
+}
+
 //
 //
 //
@@ -81,6 +81,7 @@ WarpX::Evolve (int numsteps)
                 }
             }
         }
+        CalibrateCostsHeuristicBeginStep();
 
         // At the beginning, we have B^{n} and E^{n}.
         // Particles have p^{n} and x^{n}.
@@ -107,8 +108,16 @@ WarpX::Evolve (int numsteps)
                 // Particles have p^{n-1/2} and x^{n}.
 
                 // E and B are up-to-date inside the domain only
-                FillBoundaryE(guard_cells.ng_FieldGather);
-                FillBoundaryB(guard_cells.ng_FieldGather);
+                if (overlap_guard_cell_exchange) {
+                    // the messages of E and B are in flight together
+                    FillBoundaryE_nowait(guard_cells.ng_FieldGather);
+                    FillBoundaryB_nowait(guard_cells.ng_FieldGather);
+                    FillBoundaryE_finish();
+                    FillBoundaryB_finish();
+                } else {
+                    FillBoundaryE(guard_cells.ng_FieldGather);
+                    FillBoundaryB(guard_cells.ng_FieldGather);
+                }
                 // E and B: enough guard cells to update Aux or call Field Gather in fp and cp
                 // Need to update Aux on lower levels, to interpolate to higher levels.
                 if (fft_do_time_averaging)
@@ -260,13 +269,23 @@ WarpX::Evolve (int numsteps)
             t_new[i] = cur_time;
         }
 
+        CalibrateCostsHeuristicEndStep();
+
         /// reduced diags
         if (reduced_diags->m_plot_rd != 0)
         {
             reduced_diags->ComputeDiags(step);
             reduced_diags->WriteToFile(step);
+            // buffered rows are written with each checkpoint, for restarts
+            if (multi_diags->DoDumpCheckpoint(step)) reduced_diags->Flush();
+        }
+        {
+            // full diagnostics are timed on level 0
+            amrex::LayoutData<KernelCounterArray>* counters = getKernelCounters(0);
+            const KernelTimer t_kernel = StartKernelTimer(counters);
+            multi_diags->FilterComputePackFlush( step );
+            RecordKernelCounterAllBoxes(counters, KernelCounter::Diagnostics, t_kernel);
         }
-        multi_diags->FilterComputePackFlush( step );
 
         if (cur_time >= stop_time - 1.e-3*dt[0]) {
             break;
@@ -284,6 +303,7 @@ WarpX::Evolve (int numsteps)
         // End loop on time steps
     }
 
+    if (reduced_diags->m_plot_rd != 0) reduced_diags->Flush();
     multi_diags->FilterComputePackFlush( istep[0], true );
 
     if (do_back_transformed_diagnostics) {
@@ -365,9 +385,18 @@ WarpX::OneStep_nosub (Real cur_time)
         EvolveB(0.5_rt * dt[0]); // We now have B^{n+1/2}
 
         if (do_silver_mueller) ApplySilverMuellerBoundary( dt[0] );
-        FillBoundaryB(guard_cells.ng_FieldSolver);
-
-        if (WarpX::em_solver_medium == MediumForEM::Vacuum) {
+        const bool overlap_evolve_E = overlap_guard_cell_exchange
+            && WarpX::em_solver_medium == MediumForEM::Vacuum;
+        if (!overlap_evolve_E) FillBoundaryB(guard_cells.ng_FieldSolver);
+
+        if (overlap_evolve_E) {
+            // vacuum medium: the cells of E whose update does not use the guard
+            // cells of B are updated while these guard cells are exchanged
+            FillBoundaryB_nowait(guard_cells.ng_FieldSolver);
+            EvolveE(dt[0], FieldUpdateRegion::Interior);
+            FillBoundaryB_finish();
+            EvolveE(dt[0], FieldUpdateRegion::Boundary); // We now have E^{n+1}
+        } else if (WarpX::em_solver_medium == MediumForEM::Vacuum) {
             // vacuum medium
             EvolveE(dt[0]); // We now have E^{n+1}
         } else if (WarpX::em_solver_medium == MediumForEM::Macroscopic) {
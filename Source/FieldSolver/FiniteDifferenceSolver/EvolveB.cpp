@@ -71,6 +71,7 @@ void FiniteDifferenceSolver::EvolveBCartesian (
 #endif
 
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+    amrex::LayoutData<KernelCounterArray>* counters = WarpX::getKernelCounters(lev);
 
     Real constexpr c2 = PhysConst::c * PhysConst::c;
 
@@ -84,6 +85,7 @@ void FiniteDifferenceSolver::EvolveBCartesian (
             amrex::Gpu::synchronize();
         }
         Real wt = amrex::second();
+        const KernelTimer t_kernel = StartKernelTimer(counters);
 
         // Extract field data for this grid/tile
         Array4<Real> const& Bx = Bfield[0]->array(mfi);
@@ -167,6 +169,9 @@ void FiniteDifferenceSolver::EvolveBCartesian (
             );
         }
 
+        RecordKernelCounter(counters, mfi.index(), KernelCounter::FieldSolve, t_kernel,
+                            0, 6*mfi.tilebox().numPts()*static_cast<amrex::Long>(sizeof(Real)));
+
         if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
             amrex::Gpu::synchronize();
@@ -185,6 +190,7 @@ void FiniteDifferenceSolver::EvolveBCylindrical (
     int lev, amrex::Real const dt ) {
 
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+    amrex::LayoutData<KernelCounterArray>* counters = WarpX::getKernelCounters(lev);
 
     // Loop through the grids, and over the tiles within each grid
 #ifdef AMREX_USE_OMP
@@ -196,6 +202,7 @@ void FiniteDifferenceSolver::EvolveBCylindrical (
             amrex::Gpu::synchronize();
         }
         Real wt = amrex::second();
+        const KernelTimer t_kernel = StartKernelTimer(counters);
 
         // Extract field data for this grid/tile
         Array4<Real> const& Br = Bfield[0]->array(mfi);
@@ -284,6 +291,9 @@ void FiniteDifferenceSolver::EvolveBCylindrical (
 
         );
 
+        RecordKernelCounter(counters, mfi.index(), KernelCounter::FieldSolve, t_kernel,
+                            0, 6*mfi.tilebox().numPts()*static_cast<amrex::Long>(sizeof(Real)));
+
         if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
             amrex::Gpu::synchronize();
@@ -30,11 +30,13 @@ void FiniteDifferenceSolver::EvolveE (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Jfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& edge_lengths,
     std::unique_ptr<amrex::MultiFab> const& Ffield,
-    int lev, amrex::Real const dt ) {
+    int lev, amrex::Real const dt, FieldUpdateRegion region ) {
 
    // Select algorithm (The choice of algorithm is a runtime option,
    // but we compile code for each algorithm, using templates)
 #ifdef WARPX_DIM_RZ
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(region == FieldUpdateRegion::All,
+        "EvolveE: the update of a region of the cells is not implemented in RZ geometry");
     if (m_fdtd_algo == MaxwellSolverAlgo::Yee){
 
         EvolveECylindrical <CylindricalYeeAlgorithm> ( Efield, Bfield, Jfield, Ffield, lev, dt );
@@ -42,15 +44,15 @@ void FiniteDifferenceSolver::EvolveE (
 #else
     if (m_do_nodal) {
 
-        EvolveECartesian <CartesianNodalAlgorithm> ( Efield, Bfield, Jfield, edge_lengths, Ffield, lev, dt );
+        EvolveECartesian <CartesianNodalAlgorithm> ( Efield, Bfield, Jfield, edge_lengths, Ffield, lev, dt, region );
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::Yee) {
 
-        EvolveECartesian <CartesianYeeAlgorithm> ( Efield, Bfield, Jfield, edge_lengths, Ffield, lev, dt );
+        EvolveECartesian <CartesianYeeAlgorithm> ( Efield, Bfield, Jfield, edge_lengths, Ffield, lev, dt, region );
 
     } else if (m_fdtd_algo == MaxwellSolverAlgo::CKC) {
 
-        EvolveECartesian <CartesianCKCAlgorithm> ( Efield, Bfield, Jfield, edge_lengths, Ffield, lev, dt );
+        EvolveECartesian <CartesianCKCAlgorithm> ( Efield, Bfield, Jfield, edge_lengths, Ffield, lev, dt, region );
 
 #endif
     } else {
@@ -62,6 +64,23 @@ void FiniteDifferenceSolver::EvolveE (
 
 #ifndef WARPX_DIM_RZ
 
+namespace
+{
+    /** Boxes of the tile box tbx to update in region, where vbx is the valid box
+     *  (with the index type of tbx). All the Cartesian stencils use B up to one
+     *  cell away, so the update of the cells one cell inside vbx uses no guard cell. */
+    BoxList
+    RegionBoxes (Box const& tbx, Box const& vbx, FieldUpdateRegion region)
+    {
+        if (region == FieldUpdateRegion::All) return BoxList(tbx);
+        const Box interior = tbx & amrex::grow(vbx, -1);
+        if (region == FieldUpdateRegion::Interior) {
+            return interior.ok() ? BoxList(interior) : BoxList(tbx.ixType());
+        }
+        return interior.ok() ? amrex::boxDiff(tbx, interior) : BoxList(tbx);
+    }
+}
+
 template<typename T_Algo>
 void FiniteDifferenceSolver::EvolveECartesian (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 >& Efield,
@@ -69,13 +88,14 @@ void FiniteDifferenceSolver::EvolveECartesian (
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& Jfield,
     std::array< std::unique_ptr<amrex::MultiFab>, 3 > const& edge_lengths,
     std::unique_ptr<amrex::MultiFab> const& Ffield,
-    int lev, amrex::Real const dt ) {
+    int lev, amrex::Real const dt, FieldUpdateRegion region ) {
 
 #ifndef AMREX_USE_EB
     amrex::ignore_unused(edge_lengths);
 #endif
 
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+    amrex::LayoutData<KernelCounterArray>* counters = WarpX::getKernelCounters(lev);
     Real constexpr c2 = PhysConst::c * PhysConst::c;
 
     // Loop through the grids, and over the tiles within each grid
@@ -88,6 +108,7 @@ void FiniteDifferenceSolver::EvolveECartesian (
             amrex::Gpu::synchronize();
         }
         Real wt = amrex::second();
+        const KernelTimer t_kernel = StartKernelTimer(counters);
 
         // Extract field data for this grid/tile
         Array4<Real> const& Ex = Efield[0]->array(mfi);
@@ -119,43 +140,56 @@ void FiniteDifferenceSolver::EvolveECartesian (
         Box const& tey  = mfi.tilebox(Efield[1]->ixType().toIntVect());
         Box const& tez  = mfi.tilebox(Efield[2]->ixType().toIntVect());
 
-        // Loop over the cells and update the fields
-        amrex::ParallelFor(tex, tey, tez,
-
-            [=] AMREX_GPU_DEVICE (int i, int j, int k){
+        // Update of the fields in one cell
+        auto const update_Ex = [=] AMREX_GPU_DEVICE (int i, int j, int k){
 #ifdef AMREX_USE_EB
-                // Skip field push if this cell is fully covered by embedded boundaries
-                if (lx(i, j, k) <= 0) return;
+            // Skip field push if this cell is fully covered by embedded boundaries
+            if (lx(i, j, k) <= 0) return;
 #endif
-                Ex(i, j, k) += c2 * dt * (
-                    - T_Algo::DownwardDz(By, coefs_z, n_coefs_z, i, j, k)
-                    + T_Algo::DownwardDy(Bz, coefs_y, n_coefs_y, i, j, k)
-                    - PhysConst::mu0 * jx(i, j, k) );
-            },
-
-            [=] AMREX_GPU_DEVICE (int i, int j, int k){
+            Ex(i, j, k) += c2 * dt * (
+                - T_Algo::DownwardDz(By, coefs_z, n_coefs_z, i, j, k)
+                + T_Algo::DownwardDy(Bz, coefs_y, n_coefs_y, i, j, k)
+                - PhysConst::mu0 * jx(i, j, k) );
+        };
+        auto const update_Ey = [=] AMREX_GPU_DEVICE (int i, int j, int k){
 #ifdef AMREX_USE_EB
-                // Skip field push if this cell is fully covered by embedded boundaries
-                if (ly(i,j,k) <= 0) return;
+            // Skip field push if this cell is fully covered by embedded boundaries
+            if (ly(i,j,k) <= 0) return;
 #endif
-                Ey(i, j, k) += c2 * dt * (
-                    - T_Algo::DownwardDx(Bz, coefs_x, n_coefs_x, i, j, k)
-                    + T_Algo::DownwardDz(Bx, coefs_z, n_coefs_z, i, j, k)
-                    - PhysConst::mu0 * jy(i, j, k) );
-            },
-
-            [=] AMREX_GPU_DEVICE (int i, int j, int k){
+            Ey(i, j, k) += c2 * dt * (
+                - T_Algo::DownwardDx(Bz, coefs_x, n_coefs_x, i, j, k)
+                + T_Algo::DownwardDz(Bx, coefs_z, n_coefs_z, i, j, k)
+                - PhysConst::mu0 * jy(i, j, k) );
+        };
+        auto const update_Ez = [=] AMREX_GPU_DEVICE (int i, int j, int k){
 #ifdef AMREX_USE_EB
-                // Skip field push if this cell is fully covered by embedded boundaries
-                if (lz(i,j,k) <= 0) return;
+            // Skip field push if this cell is fully covered by embedded boundaries
+            if (lz(i,j,k) <= 0) return;
 #endif
-                Ez(i, j, k) += c2 * dt * (
-                    - T_Algo::DownwardDy(Bx, coefs_y, n_coefs_y, i, j, k)
-                    + T_Algo::DownwardDx(By, coefs_x, n_coefs_x, i, j, k)
-                    - PhysConst::mu0 * jz(i, j, k) );
-            }
+            Ez(i, j, k) += c2 * dt * (
+                - T_Algo::DownwardDy(Bx, coefs_y, n_coefs_y, i, j, k)
+                + T_Algo::DownwardDx(By, coefs_x, n_coefs_x, i, j, k)
+                - PhysConst::mu0 * jz(i, j, k) );
+        };
 
-        );
+        // Loop over the cells and update the fields
+        amrex::Long npts = 0;
+        if (region == FieldUpdateRegion::All) {
+            amrex::ParallelFor(tex, tey, tez, update_Ex, update_Ey, update_Ez);
+            npts = tex.numPts();
+        } else {
+            Box const& vbx = mfi.validbox();
+            for (Box const& bx : RegionBoxes(tex, amrex::convert(vbx, tex.ixType()), region)) {
+                amrex::ParallelFor(bx, update_Ex);
+                npts += bx.numPts();
+            }
+            for (Box const& bx : RegionBoxes(tey, amrex::convert(vbx, tey.ixType()), region)) {
+                amrex::ParallelFor(bx, update_Ey);
+            }
+            for (Box const& bx : RegionBoxes(tez, amrex::convert(vbx, tez.ixType()), region)) {
+                amrex::ParallelFor(bx, update_Ez);
+            }
+        }
 
         // If F is not a null pointer, further update E using the grad(F) term
         // (hyperbolic correction for errors in charge conservation)
@@ -164,23 +198,38 @@ void FiniteDifferenceSolver::EvolveECartesian (
             // Extract field data for this grid/tile
             Array4<Real> F = Ffield->array(mfi);
 
-            // Loop over the cells and update the fields
-            amrex::ParallelFor(tex, tey, tez,
+            auto const update_Ex_F = [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                Ex(i, j, k) += c2 * dt * T_Algo::UpwardDx(F, coefs_x, n_coefs_x, i, j, k);
+            };
+            auto const update_Ey_F = [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                Ey(i, j, k) += c2 * dt * T_Algo::UpwardDy(F, coefs_y, n_coefs_y, i, j, k);
+            };
+            auto const update_Ez_F = [=] AMREX_GPU_DEVICE (int i, int j, int k){
+                Ez(i, j, k) += c2 * dt * T_Algo::UpwardDz(F, coefs_z, n_coefs_z, i, j, k);
+            };
 
-                [=] AMREX_GPU_DEVICE (int i, int j, int k){
-                    Ex(i, j, k) += c2 * dt * T_Algo::UpwardDx(F, coefs_x, n_coefs_x, i, j, k);
-                },
-                [=] AMREX_GPU_DEVICE (int i, int j, int k){
-                    Ey(i, j, k) += c2 * dt * T_Algo::UpwardDy(F, coefs_y, n_coefs_y, i, j, k);
-                },
-                [=] AMREX_GPU_DEVICE (int i, int j, int k){
-                    Ez(i, j, k) += c2 * dt * T_Algo::UpwardDz(F, coefs_z, n_coefs_z, i, j, k);
+            // Loop over the cells and update the fields
+            // (F is exchanged before E is updated, so its guard cells can be used in any region)
+            if (region == FieldUpdateRegion::All) {
+                amrex::ParallelFor(tex, tey, tez, update_Ex_F, update_Ey_F, update_Ez_F);
+            } else {
+                Box const& vbx = mfi.validbox();
+                for (Box const& bx : RegionBoxes(tex, amrex::convert(vbx, tex.ixType()), region)) {
+                    amrex::ParallelFor(bx, update_Ex_F);
                 }
-
-            );
+                for (Box const& bx : RegionBoxes(tey, amrex::convert(vbx, tey.ixType()), region)) {
+                    amrex::ParallelFor(bx, update_Ey_F);
+                }
+                for (Box const& bx : RegionBoxes(tez, amrex::convert(vbx, tez.ixType()), region)) {
+                    amrex::ParallelFor(bx, update_Ez_F);
+                }
+            }
 
         }
 
+        RecordKernelCounter(counters, mfi.index(), KernelCounter::FieldSolve, t_kernel,
+                            0, 9*npts*static_cast<amrex::Long>(sizeof(Real)));
+
         if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
             amrex::Gpu::synchronize();
@@ -202,6 +251,7 @@ void FiniteDifferenceSolver::EvolveECylindrical (
     int lev, amrex::Real const dt ) {
 
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+    amrex::LayoutData<KernelCounterArray>* counters = WarpX::getKernelCounters(lev);
 
     // Loop through the grids, and over the tiles within each grid
 #ifdef AMREX_USE_OMP
@@ -213,6 +263,7 @@ void FiniteDifferenceSolver::EvolveECylindrical (
             amrex::Gpu::synchronize();
         }
         Real wt = amrex::second();
+        const KernelTimer t_kernel = StartKernelTimer(counters);
 
         // Extract field data for this grid/tile
         Array4<Real> const& Er = Efield[0]->array(mfi);
@@ -383,6 +434,9 @@ void FiniteDifferenceSolver::EvolveECylindrical (
 
         } // end of if condition for F
 
+        RecordKernelCounter(counters, mfi.index(), KernelCounter::FieldSolve, t_kernel,
+                            0, 9*mfi.tilebox().numPts()*static_cast<amrex::Long>(sizeof(Real)));
+
         if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
             amrex::Gpu::synchronize();
@@ -1,10 +1,225 @@
 #include "ComovingPsatdAlgorithm.H"
+#include "WarpX.H"
 #include "Utils/WarpXConst.H"
 
 #if WARPX_USE_PSATD
 
 using namespace amrex;
 
+namespace
+{
+    /** Coefficients of the comoving PSATD update equations at one point of the spectral grid */
+    struct ComovingPsatdCoefficients
+    {
+        amrex::Real C, S_ck;
+        Complex T2, X1, X2, X3, X4;
+    };
+
+    /**
+     * \brief Coefficients of the update equations for E and B at one point of the spectral grid
+     *
+     * \param[in] knorm_mod norm of the finite-order modified k vector
+     * \param[in] knorm norm of the infinite-order k vector
+     * \param[in] kv dot product of the infinite-order k vector with the comoving velocity
+     * \param[in] dt time step of the simulation
+     */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    ComovingPsatdCoefficients
+    ComputeCoefficients (const amrex::Real knorm_mod, const amrex::Real knorm,
+                         const amrex::Real kv, const amrex::Real dt) noexcept
+    {
+        ComovingPsatdCoefficients coef;
+
+        // Physical constants c, c**2, and epsilon_0, and imaginary unit
+        constexpr amrex::Real c   = PhysConst::c;
+        constexpr amrex::Real c2  = c*c;
+        constexpr amrex::Real ep0 = PhysConst::ep0;
+        constexpr Complex     I   = Complex{0._rt, 1._rt};
+
+        // Auxiliary coefficients used when update_with_rho=false
+        const amrex::Real dt2 = dt * dt;
+
+        if (knorm_mod != 0. && knorm != 0.) {
+
+            // Auxiliary coefficients
+            const amrex::Real om_mod  = c * knorm_mod;
+            const amrex::Real om2_mod = om_mod * om_mod;
+            const amrex::Real om  = c * knorm;
+            const amrex::Real om2 = om * om;
+            const Complex tmp1 = amrex::exp(  I * om_mod * dt);
+            const Complex tmp2 = amrex::exp(- I * om_mod * dt);
+            const Complex tmp1_sqrt = amrex::exp(  I * om_mod * dt * 0.5_rt);
+            const Complex tmp2_sqrt = amrex::exp(- I * om_mod * dt * 0.5_rt);
+
+            coef.C = std::cos(om_mod * dt);
+            coef.S_ck = std::sin(om_mod * dt) / om_mod;
+
+            const amrex::Real nu = - kv / om;
+            const Complex theta      = amrex::exp(  I * nu * om * dt * 0.5_rt);
+            const Complex theta_star = amrex::exp(- I * nu * om * dt * 0.5_rt);
+
+            coef.T2 = theta * theta;
+
+            if ( (nu != om_mod/om) && (nu != -om_mod/om) && (nu != 0.) ) {
+
+                Complex x1 = om2 / (om2_mod - nu * nu * om2)
+                    * (theta_star - theta * coef.C + I * nu * om * theta * coef.S_ck);
+
+                // X1 multiplies i*(k \times J) in the update equation for B
+                coef.X1 = x1 / (ep0 * om2);
+
+                // X2 multiplies rho_new in the update equation for E
+                // X3 multiplies rho_old in the update equation for E
+                coef.X2 = c2 * (x1 * om2_mod - theta * (1._rt - coef.C) * om2)
+                    / (theta_star - theta) / (ep0 * om2 * om2_mod);
+                coef.X3 = c2 * (x1 * om2_mod - theta_star * (1._rt - coef.C) * om2)
+                    / (theta_star - theta) / (ep0 * om2 * om2_mod);
+
+                // X4 multiplies J in the update equation for E
+                coef.X4 = I * nu * om * coef.X1 - theta * coef.S_ck / ep0;
+            }
+
+            // Limits for nu = 0
+            if (nu == 0.) {
+
+                // X1 multiplies i*(k \times J) in the update equation for B
+                coef.X1 = (1._rt - coef.C) / (ep0 * om2_mod);
+
+                // X2 multiplies rho_new in the update equation for E
+                // X3 multiplies rho_old in the update equation for E
+                coef.X2 = c2 * (1._rt - coef.S_ck / dt) / (ep0 * om2_mod);
+                coef.X3 = c2 * (coef.C - coef.S_ck / dt) / (ep0 * om2_mod);
+
+                // Coefficient multiplying J in update equation for E
+                coef.X4 = - coef.S_ck / ep0;
+            }
+
+            // Limits for nu = omega_mod/omega
+            if (nu == om_mod/om) {
+
+                // X1 multiplies i*(k \times J) in the update equation for B
+                coef.X1 = tmp1_sqrt * (1._rt - tmp2 * tmp2 - 2._rt * I * om_mod * dt) / (4._rt * ep0 * om2_mod);
+
+                // X2 multiplies rho_new in the update equation for E
+                // X3 multiplies rho_old in the update equation for E
+                coef.X2 = c2 * (- 4._rt + 3._rt * tmp1 + tmp2 - 2._rt * I * om_mod * dt * tmp1)
+                    / (4._rt * ep0 * om2_mod * (tmp1 - 1._rt));
+                coef.X3 = c2 * (2._rt - tmp2 - 3._rt * tmp1 + 2._rt * tmp1 * tmp1 - 2._rt * I * om_mod * dt * tmp1)
+                    / (4._rt * ep0 * om2_mod * (tmp1 - 1._rt));
+
+                // Coefficient multiplying J in update equation for E
+                coef.X4 = tmp1_sqrt * (I - I * tmp2 * tmp2 - 2._rt * om_mod * dt) / (4._rt * ep0 * om_mod);
+            }
+
+            // Limits for nu = -omega_mod/omega
+            if (nu == -om_mod/om) {
+
+                // X1 multiplies i*(k \times J) in the update equation for B
+                coef.X1 = tmp2_sqrt * (1._rt - tmp1 * tmp1 + 2._rt * I * om_mod * dt) / (4._rt * ep0 * om2_mod);
+
+                // X2 multiplies rho_new in the update equation for E
+                // X3 multiplies rho_old in the update equation for E
+                coef.X2 = c2 * (- 3._rt + 4._rt * tmp1 - tmp1 * tmp1 - 2._rt * I * om_mod * dt)
+                    / (4._rt * ep0 * om2_mod * (tmp1 - 1._rt));
+                coef.X3 = c2 * (3._rt - 2._rt * tmp2 - 2._rt * tmp1 + tmp1 * tmp1 - 2._rt * I * om_mod * dt)
+                    / (4._rt * ep0 * om2_mod * (tmp1 - 1._rt));
+
+                // Coefficient multiplying J in update equation for E
+                coef.X4 = tmp2_sqrt * (- I + I * tmp1 * tmp1 - 2._rt * om_mod * dt) / (4._rt * ep0 * om_mod);
+            }
+        }
+
+        // Limits for omega = 0 only
+        else if (knorm_mod != 0. && knorm == 0.) {
+
+            const amrex::Real om_mod  = c * knorm_mod;
+            const amrex::Real om2_mod = om_mod * om_mod;
+
+            coef.C = std::cos(om_mod * dt);
+            coef.S_ck = std::sin(om_mod * dt) / om_mod;
+            coef.T2 = 1._rt;
+
+            // X1 multiplies i*(k \times J) in the update equation for B
+            coef.X1 = (1._rt - coef.C) / (ep0 * om2_mod);
+
+            // X2 multiplies rho_new in the update equation for E
+            // X3 multiplies rho_old in the update equation for E
+            coef.X2 = c2 * (1._rt - coef.S_ck / dt) / (ep0 * om2_mod);
+            coef.X3 = c2 * (coef.C - coef.S_ck / dt) / (ep0 * om2_mod);
+
+            // Coefficient multiplying J in update equation for E
+            coef.X4 = - coef.S_ck / ep0;
+
+        }
+
+        // Limits for omega_mod = 0 only
+        else if (knorm_mod == 0. && knorm != 0.) {
+
+            const amrex::Real om  = c * knorm;
+            const amrex::Real om2 = om * om;
+            const amrex::Real nu = - kv / om;
+            const Complex theta      = amrex::exp(I * nu * om * dt * 0.5_rt);
+            const Complex theta_star = amrex::exp(- I * nu * om * dt * 0.5_rt);
+
+            coef.C = 1._rt;
+            coef.S_ck = dt;
+            coef.T2 = theta * theta;
+
+            if (nu != 0.) {
+                // X1 multiplies i*(k \times J) in the update equation for B
+                coef.X1 = (-theta_star + theta - I * nu * om * dt * theta)
+                    / (ep0 * nu * nu * om2);
+
+                // X2 multiplies rho_new in the update equation for E
+                // X3 multiplies rho_old in the update equation for E
+                coef.X2 = c2 * (1._rt - coef.T2 + I * nu * om * dt * coef.T2
+                    + 0.5_rt * nu * nu * om2 * dt * dt * coef.T2)
+                    / (ep0 * nu * nu * om2 * (coef.T2 - 1._rt));
+                coef.X3 = c2 * (1._rt - coef.T2 + I * nu * om * dt * coef.T2
+                    + 0.5_rt * nu * nu * om2 * dt * dt)
+                    / (ep0 * nu * nu * om2 * (coef.T2 - 1._rt));
+
+                // Coefficient multiplying J in update equation for E
+                coef.X4 = I * (theta - theta_star) / (ep0 * nu * om);
+            }
+
+            else {
+                // X1 multiplies i*(k \times J) in the update equation for B
+                coef.X1 = dt2 / (2._rt * ep0);
+
+                // X2 multiplies rho_new in the update equation for E
+                // X3 multiplies rho_old in the update equation for E
+                coef.X2 = c2 * dt2 / (6._rt * ep0);
+                coef.X3 = - c2 * dt2 / (3._rt * ep0);
+
+                // Coefficient multiplying J in update equation for E
+                coef.X4 = -dt / ep0;
+            }
+        }
+
+        // Limits for omega_mod = 0 and omega = 0
+        else if (knorm_mod == 0. && knorm == 0.) {
+
+            coef.C = 1._rt;
+            coef.S_ck = dt;
+            coef.T2 = 1._rt;
+
+            // X1 multiplies i*(k \times J) in the update equation for B
+            coef.X1 = dt2 / (2._rt * ep0);
+
+            // X2 multiplies rho_new in the update equation for E
+            // X3 multiplies rho_old in the update equation for E
+            coef.X2 = c2 * dt2 / (6._rt * ep0);
+            coef.X3 = - c2 * dt2 / (3._rt * ep0);
+
+            // Coefficient multiplying J in update equation for E
+            coef.X4 = -dt / ep0;
+        }
+
+        return coef;
+    }
+}
+
 ComovingPsatdAlgorithm::ComovingPsatdAlgorithm (const SpectralKSpace& spectral_kspace,
                                                 const DistributionMapping& dm,
                                                 const int norder_x, const int norder_y,
@@ -24,10 +239,15 @@ ComovingPsatdAlgorithm::ComovingPsatdAlgorithm (const SpectralKSpace& spectral_k
        kz_vec(spectral_kspace.getModifiedKComponent(dm, 1, -1, false)),
 #endif
        m_v_comoving(v_comoving),
-       m_dt(dt)
+       m_dt(dt),
+       m_on_the_fly_coefficients(WarpX::fft_on_the_fly_coefficients)
 {
     amrex::ignore_unused(update_with_rho);
 
+    // With on-the-fly coefficients, only the k vectors are stored
+    // and the coefficients are computed in pushSpectralFields
+    if (m_on_the_fly_coefficients) return;
+
     const BoxArray& ba = spectral_kspace.spectralspace_ba;
 
     // Allocate arrays of real spectral coefficients
@@ -48,6 +268,16 @@ ComovingPsatdAlgorithm::ComovingPsatdAlgorithm (const SpectralKSpace& spectral_k
 void
 ComovingPsatdAlgorithm::pushSpectralFields (SpectralFieldData& f) const
 {
+    const bool on_the_fly = m_on_the_fly_coefficients;
+    const amrex::Real dt  = m_dt;
+
+    // Store comoving velocity
+    const amrex::Real vx = m_v_comoving[0];
+#if (AMREX_SPACEDIM==3)
+    const amrex::Real vy = m_v_comoving[1];
+#endif
+    const amrex::Real vz = m_v_comoving[2];
+
     // Loop over boxes
     for (amrex::MFIter mfi(f.fields); mfi.isValid(); ++mfi){
 
@@ -56,20 +286,31 @@ ComovingPsatdAlgorithm::pushSpectralFields (SpectralFieldData& f) const
         // Extract arrays for the fields to be updated
         amrex::Array4<Complex> fields = f.fields[mfi].array();
 
-        // Extract arrays for the coefficients
-        amrex::Array4<const amrex::Real> C_arr    = C_coef   [mfi].array();
-        amrex::Array4<const amrex::Real> S_ck_arr = S_ck_coef[mfi].array();
-        amrex::Array4<const Complex>     X1_arr   = X1_coef  [mfi].array();
-        amrex::Array4<const Complex>     X2_arr   = X2_coef  [mfi].array();
-        amrex::Array4<const Complex>     X3_arr   = X3_coef  [mfi].array();
-        amrex::Array4<const Complex>     X4_arr   = X4_coef  [mfi].array();
+        // Extract arrays for the coefficients, unless they are computed on the fly
+        amrex::Array4<const amrex::Real> C_arr;
+        amrex::Array4<const amrex::Real> S_ck_arr;
+        amrex::Array4<const Complex>     X1_arr;
+        amrex::Array4<const Complex>     X2_arr;
+        amrex::Array4<const Complex>     X3_arr;
+        amrex::Array4<const Complex>     X4_arr;
+        if (!on_the_fly) {
+            C_arr    = C_coef   [mfi].array();
+            S_ck_arr = S_ck_coef[mfi].array();
+            X1_arr   = X1_coef  [mfi].array();
+            X2_arr   = X2_coef  [mfi].array();
+            X3_arr   = X3_coef  [mfi].array();
+            X4_arr   = X4_coef  [mfi].array();
+        }
 
         // Extract pointers for the k vectors
         const amrex::Real* modified_kx_arr = modified_kx_vec[mfi].dataPtr();
+        const amrex::Real* kx_arr          = kx_vec[mfi].dataPtr();
 #if (AMREX_SPACEDIM==3)
         const amrex::Real* modified_ky_arr = modified_ky_vec[mfi].dataPtr();
+        const amrex::Real* ky_arr          = ky_vec[mfi].dataPtr();
 #endif
         const amrex::Real* modified_kz_arr = modified_kz_vec[mfi].dataPtr();
+        const amrex::Real* kz_arr          = kz_vec[mfi].dataPtr();
 
         // Loop over indices within one box
         amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
@@ -105,13 +346,36 @@ ComovingPsatdAlgorithm::pushSpectralFields (SpectralFieldData& f) const
             constexpr Complex I = Complex{0._rt,1._rt};
 
             // The definition of these coefficients is explained in more detail
-            // in the function InitializeSpectralCoefficients below
-            const amrex::Real C    = C_arr(i,j,k);
-            const amrex::Real S_ck = S_ck_arr(i,j,k);
-            const Complex     X1   = X1_arr(i,j,k);
-            const Complex     X2   = X2_arr(i,j,k);
-            const Complex     X3   = X3_arr(i,j,k);
-            const Complex     X4   = X4_arr(i,j,k);
+            // in the function ComputeCoefficients above: they are either read from
+            // the arrays initialized in InitializeSpectralCoefficients, or computed here
+            ComovingPsatdCoefficients coef;
+            if (on_the_fly) {
+                // Norms of the finite-order and infinite-order k vectors,
+                // and dot product of the infinite-order k vector with the comoving velocity
+                const amrex::Real knorm_mod = std::sqrt(kx_mod*kx_mod + ky_mod*ky_mod + kz_mod*kz_mod);
+#if (AMREX_SPACEDIM==3)
+                const amrex::Real knorm = std::sqrt(
+                    kx_arr[i]*kx_arr[i] + ky_arr[j]*ky_arr[j] + kz_arr[k]*kz_arr[k]);
+                const amrex::Real kv = kx_arr[i]*vx + ky_arr[j]*vy + kz_arr[k]*vz;
+#else
+                const amrex::Real knorm = std::sqrt(kx_arr[i]*kx_arr[i] + kz_arr[j]*kz_arr[j]);
+                const amrex::Real kv = kx_arr[i]*vx + kz_arr[j]*vz;
+#endif
+                coef = ComputeCoefficients(knorm_mod, knorm, kv, dt);
+            } else {
+                coef.C    = C_arr(i,j,k);
+                coef.S_ck = S_ck_arr(i,j,k);
+                coef.X1   = X1_arr(i,j,k);
+                coef.X2   = X2_arr(i,j,k);
+                coef.X3   = X3_arr(i,j,k);
+                coef.X4   = X4_arr(i,j,k);
+            }
+            const amrex::Real C    = coef.C;
+            const amrex::Real S_ck = coef.S_ck;
+            const Complex     X1   = coef.X1;
+            const Complex     X2   = coef.X2;
+            const Complex     X3   = coef.X3;
+            const Complex     X4   = coef.X4;
 
             // Update E
             fields(i,j,k,Idx::Ex) = C*Ex_old + S_ck*c2*I*(ky_mod*Bz_old - kz_mod*By_old)
@@ -194,15 +458,6 @@ void ComovingPsatdAlgorithm::InitializeSpectralCoefficients (const SpectralKSpac
 #else
                 std::pow(kz[j], 2));
 #endif
-            // Physical constants c, c**2, and epsilon_0, and imaginary unit
-            constexpr amrex::Real c   = PhysConst::c;
-            constexpr amrex::Real c2  = c*c;
-            constexpr amrex::Real ep0 = PhysConst::ep0;
-            constexpr Complex     I   = Complex{0._rt, 1._rt};
-
-            // Auxiliary coefficients used when update_with_rho=false
-            const amrex::Real dt2 = dt * dt;
-
             // Calculate dot product of k vector with comoving velocity
             const amrex::Real kv = kx[i]*vx +
 #if (AMREX_SPACEDIM==3)
@@ -210,183 +465,15 @@ void ComovingPsatdAlgorithm::InitializeSpectralCoefficients (const SpectralKSpac
 #else
                 kz[j]*vz;
 #endif
-
-            if (knorm_mod != 0. && knorm != 0.) {
-
-                // Auxiliary coefficients
-                const amrex::Real om_mod  = c * knorm_mod;
-                const amrex::Real om2_mod = om_mod * om_mod;
-                const amrex::Real om  = c * knorm;
-                const amrex::Real om2 = om * om;
-                const Complex tmp1 = amrex::exp(  I * om_mod * dt);
-                const Complex tmp2 = amrex::exp(- I * om_mod * dt);
-                const Complex tmp1_sqrt = amrex::exp(  I * om_mod * dt * 0.5_rt);
-                const Complex tmp2_sqrt = amrex::exp(- I * om_mod * dt * 0.5_rt);
-
-                C   (i,j,k) = std::cos(om_mod * dt);
-                S_ck(i,j,k) = std::sin(om_mod * dt) / om_mod;
-
-                const amrex::Real nu = - kv / om;
-                const Complex theta      = amrex::exp(  I * nu * om * dt * 0.5_rt);
-                const Complex theta_star = amrex::exp(- I * nu * om * dt * 0.5_rt);
-
-                T2(i,j,k) = theta * theta;
-
-                if ( (nu != om_mod/om) && (nu != -om_mod/om) && (nu != 0.) ) {
-
-                    Complex x1 = om2 / (om2_mod - nu * nu * om2)
-                        * (theta_star - theta * C(i,j,k) + I * nu * om * theta * S_ck(i,j,k));
-
-                    // X1 multiplies i*(k \times J) in the update equation for B
-                    X1(i,j,k) = x1 / (ep0 * om2);
-
-                    // X2 multiplies rho_new in the update equation for E
-                    // X3 multiplies rho_old in the update equation for E
-                    X2(i,j,k) = c2 * (x1 * om2_mod - theta * (1._rt - C(i,j,k)) * om2)
-                        / (theta_star - theta) / (ep0 * om2 * om2_mod);
-                    X3(i,j,k) = c2 * (x1 * om2_mod - theta_star * (1._rt - C(i,j,k)) * om2)
-                        / (theta_star - theta) / (ep0 * om2 * om2_mod);
-
-                    // X4 multiplies J in the update equation for E
-                    X4(i,j,k) = I * nu * om * X1(i,j,k) - theta * S_ck(i,j,k) / ep0;
-                }
-
-                // Limits for nu = 0
-                if (nu == 0.) {
-
-                    // X1 multiplies i*(k \times J) in the update equation for B
-                    X1(i,j,k) = (1._rt - C(i,j,k)) / (ep0 * om2_mod);
-
-                    // X2 multiplies rho_new in the update equation for E
-                    // X3 multiplies rho_old in the update equation for E
-                    X2(i,j,k) = c2 * (1._rt - S_ck(i,j,k) / dt) / (ep0 * om2_mod);
-                    X3(i,j,k) = c2 * (C(i,j,k) - S_ck(i,j,k) / dt) / (ep0 * om2_mod);
-
-                    // Coefficient multiplying J in update equation for E
-                    X4(i,j,k) = - S_ck(i,j,k) / ep0;
-                }
-
-                // Limits for nu = omega_mod/omega
-                if (nu == om_mod/om) {
-
-                    // X1 multiplies i*(k \times J) in the update equation for B
-                    X1(i,j,k) = tmp1_sqrt * (1._rt - tmp2 * tmp2 - 2._rt * I * om_mod * dt) / (4._rt * ep0 * om2_mod);
-
-                    // X2 multiplies rho_new in the update equation for E
-                    // X3 multiplies rho_old in the update equation for E
-                    X2(i,j,k) = c2 * (- 4._rt + 3._rt * tmp1 + tmp2 - 2._rt * I * om_mod * dt * tmp1)
-                        / (4._rt * ep0 * om2_mod * (tmp1 - 1._rt));
-                    X3(i,j,k) = c2 * (2._rt - tmp2 - 3._rt * tmp1 + 2._rt * tmp1 * tmp1 - 2._rt * I * om_mod * dt * tmp1)
-                        / (4._rt * ep0 * om2_mod * (tmp1 - 1._rt));
-
-                    // Coefficient multiplying J in update equation for E
-                    X4(i,j,k) = tmp1_sqrt * (I - I * tmp2 * tmp2 - 2._rt * om_mod * dt) / (4._rt * ep0 * om_mod);
-                }
-
-                // Limits for nu = -omega_mod/omega
-                if (nu == -om_mod/om) {
-
-                    // X1 multiplies i*(k \times J) in the update equation for B
-                    X1(i,j,k) = tmp2_sqrt * (1._rt - tmp1 * tmp1 + 2._rt * I * om_mod * dt) / (4._rt * ep0 * om2_mod);
-
-                    // X2 multiplies rho_new in the update equation for E
-                    // X3 multiplies rho_old in the update equation for E
-                    X2(i,j,k) = c2 * (- 3._rt + 4._rt * tmp1 - tmp1 * tmp1 - 2._rt * I * om_mod * dt)
-                        / (4._rt * ep0 * om2_mod * (tmp1 - 1._rt));
-                    X3(i,j,k) = c2 * (3._rt - 2._rt * tmp2 - 2._rt * tmp1 + tmp1 * tmp1 - 2._rt * I * om_mod * dt)
-                        / (4._rt * ep0 * om2_mod * (tmp1 - 1._rt));
-
-                    // Coefficient multiplying J in update equation for E
-                    X4(i,j,k) = tmp2_sqrt * (- I + I * tmp1 * tmp1 - 2._rt * om_mod * dt) / (4._rt * ep0 * om_mod);
-                }
-            }
-
-            // Limits for omega = 0 only
-            else if (knorm_mod != 0. && knorm == 0.) {
-
-                const amrex::Real om_mod  = c * knorm_mod;
-                const amrex::Real om2_mod = om_mod * om_mod;
-
-                C   (i,j,k) = std::cos(om_mod * dt);
-                S_ck(i,j,k) = std::sin(om_mod * dt) / om_mod;
-                T2(i,j,k) = 1._rt;
-
-                // X1 multiplies i*(k \times J) in the update equation for B
-                X1(i,j,k) = (1._rt - C(i,j,k)) / (ep0 * om2_mod);
-
-                // X2 multiplies rho_new in the update equation for E
-                // X3 multiplies rho_old in the update equation for E
-                X2(i,j,k) = c2 * (1._rt - S_ck(i,j,k) / dt) / (ep0 * om2_mod);
-                X3(i,j,k) = c2 * (C(i,j,k) - S_ck(i,j,k) / dt) / (ep0 * om2_mod);
-
-                // Coefficient multiplying J in update equation for E
-                X4(i,j,k) = - S_ck(i,j,k) / ep0;
-
-            }
-
-            // Limits for omega_mod = 0 only
-            else if (knorm_mod == 0. && knorm != 0.) {
-
-                const amrex::Real om  = c * knorm;
-                const amrex::Real om2 = om * om;
-                const amrex::Real nu = - kv / om;
-                const Complex theta      = amrex::exp(I * nu * om * dt * 0.5_rt);
-                const Complex theta_star = amrex::exp(- I * nu * om * dt * 0.5_rt);
-
-                C(i,j,k) = 1._rt;
-                S_ck(i,j,k) = dt;
-                T2(i,j,k) = theta * theta;
-
-                if (nu != 0.) {
-                    // X1 multiplies i*(k \times J) in the update equation for B
-                    X1(i,j,k) = (-theta_star + theta - I * nu * om * dt * theta)
-                        / (ep0 * nu * nu * om2);
-
-                    // X2 multiplies rho_new in the update equation for E
-                    // X3 multiplies rho_old in the update equation for E
-                    X2(i,j,k) = c2 * (1._rt - T2(i,j,k) + I * nu * om * dt * T2(i,j,k)
-                        + 0.5_rt * nu * nu * om2 * dt * dt * T2(i,j,k))
-                        / (ep0 * nu * nu * om2 * (T2(i,j,k) - 1._rt));
-                    X3(i,j,k) = c2 * (1._rt - T2(i,j,k) + I * nu * om * dt * T2(i,j,k)
-                        + 0.5_rt * nu * nu * om2 * dt * dt)
-                        / (ep0 * nu * nu * om2 * (T2(i,j,k) - 1._rt));
-
-                    // Coefficient multiplying J in update equation for E
-                    X4(i,j,k) = I * (theta - theta_star) / (ep0 * nu * om);
-                }
-
-                else {
-                    // X1 multiplies i*(k \times J) in the update equation for B
-                    X1(i,j,k) = dt2 / (2._rt * ep0);
-
-                    // X2 multiplies rho_new in the update equation for E
-                    // X3 multiplies rho_old in the update equation for E
-                    X2(i,j,k) = c2 * dt2 / (6._rt * ep0);
-                    X3(i,j,k) = - c2 * dt2 / (3._rt * ep0);
-
-                    // Coefficient multiplying J in update equation for E
-                    X4(i,j,k) = -dt / ep0;
-                }
-            }
-
-            // Limits for omega_mod = 0 and omega = 0
-            else if (knorm_mod == 0. && knorm == 0.) {
-
-                C(i,j,k) = 1._rt;
-                S_ck(i,j,k) = dt;
-                T2(i,j,k) = 1._rt;
-
-                // X1 multiplies i*(k \times J) in the update equation for B
-                X1(i,j,k) = dt2 / (2._rt * ep0);
-
-                // X2 multiplies rho_new in the update equation for E
-                // X3 multiplies rho_old in the update equation for E
-                X2(i,j,k) = c2 * dt2 / (6._rt * ep0);
-                X3(i,j,k) = - c2 * dt2 / (3._rt * ep0);
-
-                // Coefficient multiplying J in update equation for E
-                X4(i,j,k) = -dt / ep0;
-            }
+            const ComovingPsatdCoefficients coef = ComputeCoefficients(knorm_mod, knorm, kv, dt);
+
+            C   (i,j,k) = coef.C;
+            S_ck(i,j,k) = coef.S_ck;
+            T2  (i,j,k) = coef.T2;
+            X1  (i,j,k) = coef.X1;
+            X2  (i,j,k) = coef.X2;
+            X3  (i,j,k) = coef.X3;
+            X4  (i,j,k) = coef.X4;
         });
     }
 }
@@ -13,6 +13,102 @@
 
 using namespace amrex::literals;
 
+namespace
+{
+    /** Coefficients of the Galilean PSATD update equations at one point of the spectral grid */
+    struct GalileanPsatdCoefficientsRZ
+    {
+        amrex::Real C, S_ck;
+        Complex Theta2, T_rho, X1, X2, X3, X4;
+    };
+
+    /**
+     * \brief Coefficients of the update equations for E and B at one point
+     * (radial wavenumber kr of one mode, modified kz) of the spectral grid,
+     * with Galilean velocity vz along z and time step dt
+     */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    GalileanPsatdCoefficientsRZ
+    ComputeCoefficients (amrex::Real const kr, amrex::Real const kz,
+                         amrex::Real const vz, amrex::Real const dt) noexcept
+    {
+        GalileanPsatdCoefficientsRZ coef;
+
+        constexpr amrex::Real c = PhysConst::c;
+        constexpr amrex::Real ep0 = PhysConst::ep0;
+        Complex const I = Complex{0._rt,1._rt};
+
+        amrex::Real const k_norm = std::sqrt(kr*kr + kz*kz);
+
+        // Calculate coefficients
+        if (k_norm != 0._rt){
+
+            coef.C = std::cos(c*k_norm*dt);
+            coef.S_ck = std::sin(c*k_norm*dt)/(c*k_norm);
+
+            // Calculate dot product with galilean velocity
+            amrex::Real const kv = kz*vz;
+
+            amrex::Real const nu = kv/(k_norm*c);
+            Complex const theta = amrex::exp( 0.5_rt*I*kv*dt );
+            Complex const theta_star = amrex::exp( -0.5_rt*I*kv*dt );
+            Complex const e_theta = amrex::exp( I*c*k_norm*dt );
+
+            coef.Theta2 = theta*theta;
+
+            if (kz == 0._rt) {
+                coef.T_rho = -dt;
+            } else {
+                coef.T_rho = (1._rt - theta*theta)/(I*kz*vz);
+            }
+
+            if ( (nu != 1._rt) && (nu != 0._rt) ) {
+
+                // Note: the coefficients X1, X2, X do not correspond
+                // exactly to the original Galilean paper, but the
+                // update equation have been modified accordingly so that
+                // the expressions below (with the update equations)
+                // are mathematically equivalent to those of the paper.
+                Complex x1 = 1._rt/(1._rt-nu*nu) *
+                    (theta_star - coef.C*theta + I*kv*coef.S_ck*theta);
+                // x1, above, is identical to the original paper
+                coef.X1 = theta*x1/(ep0*c*c*k_norm*k_norm);
+                // The difference betwen X2 and X3 below, and those
+                // from the original paper is the factor ep0*k_norm*k_norm
+                coef.X2 = (x1 - theta*(1._rt - coef.C))
+                          /(theta_star-theta)/(ep0*k_norm*k_norm);
+                coef.X3 = (x1 - theta_star*(1._rt - coef.C))
+                          /(theta_star-theta)/(ep0*k_norm*k_norm);
+                coef.X4 = I*kv*coef.X1 - theta*theta*coef.S_ck/ep0;
+
+            } else if (nu == 0._rt) {
+
+                coef.X1 = (1._rt - coef.C)/(ep0 * c*c * k_norm*k_norm);
+                coef.X2 = (1._rt - coef.S_ck/dt)/(ep0 * k_norm*k_norm);
+                coef.X3 = (coef.C - coef.S_ck/dt)/(ep0 * k_norm*k_norm);
+                coef.X4 = -coef.S_ck/ep0;
+
+            } else if ( nu == 1._rt) {
+                coef.X1 = (1._rt - e_theta*e_theta + 2._rt*I*c*k_norm*dt) / (4._rt*c*c*ep0*k_norm*k_norm);
+                coef.X2 = (3._rt - 4._rt*e_theta + e_theta*e_theta + 2._rt*I*c*k_norm*dt) / (4._rt*ep0*k_norm*k_norm*(1._rt - e_theta));
+                coef.X3 = (3._rt - 2._rt/e_theta - 2._rt*e_theta + e_theta*e_theta - 2._rt*I*c*k_norm*dt) / (4._rt*ep0*(e_theta - 1._rt)*k_norm*k_norm);
+                coef.X4 = I*(-1._rt + e_theta*e_theta + 2._rt*I*c*k_norm*dt) / (4._rt*ep0*c*k_norm);
+            }
+
+        } else { // Handle k_norm = 0, by using the analytical limit
+            coef.C = 1._rt;
+            coef.S_ck = dt;
+            coef.X1 = 0.5_rt * dt*dt / ep0;
+            coef.X2 = c*c * dt*dt / (6._rt*ep0);
+            coef.X3 = - c*c * dt*dt / (3._rt*ep0);
+            coef.X4 = -dt/ep0;
+            coef.Theta2 = 1._rt;
+            coef.T_rho = -dt;
+        }
+
+        return coef;
+    }
+}
 
 /* \brief Initialize coefficients for the update equation */
 GalileanPsatdAlgorithmRZ::GalileanPsatdAlgorithmRZ (SpectralKSpaceRZ const & spectral_kspace,
@@ -26,9 +122,16 @@ GalileanPsatdAlgorithmRZ::GalileanPsatdAlgorithmRZ (SpectralKSpaceRZ const & spe
      : SpectralBaseAlgorithmRZ(spectral_kspace, dm, norder_z, nodal),
        m_dt(dt),
        m_v_galilean(v_galilean),
-       m_update_with_rho(update_with_rho)
+       m_update_with_rho(update_with_rho),
+       m_on_the_fly_coefficients(WarpX::fft_on_the_fly_coefficients)
 {
 
+    coefficients_initialized = false;
+
+    // With on-the-fly coefficients, only the k vectors are stored
+    // and the coefficients are computed in pushSpectralFields
+    if (m_on_the_fly_coefficients) return;
+
     // Allocate the arrays of coefficients
     amrex::BoxArray const & ba = spectral_kspace.spectralspace_ba;
     C_coef = SpectralRealCoefficients(ba, dm, n_rz_azimuthal_modes, 0);
@@ -39,8 +142,6 @@ GalileanPsatdAlgorithmRZ::GalileanPsatdAlgorithmRZ (SpectralKSpaceRZ const & spe
     X4_coef = SpectralComplexCoefficients(ba, dm, n_rz_azimuthal_modes, 0);
     Theta2_coef = SpectralComplexCoefficients(ba, dm, n_rz_azimuthal_modes, 0);
     T_rho_coef = SpectralComplexCoefficients(ba, dm, n_rz_azimuthal_modes, 0);
-
-    coefficients_initialized = false;
 }
 
 /* Advance the E and B field in spectral space (stored in `f`)
@@ -52,8 +153,11 @@ GalileanPsatdAlgorithmRZ::pushSpectralFields (SpectralFieldDataRZ & f)
 {
 
     bool const update_with_rho = m_update_with_rho;
+    bool const on_the_fly = m_on_the_fly_coefficients;
+    amrex::Real const dt = m_dt;
+    amrex::Real const vz = m_v_galilean[2];
 
-    if (not coefficients_initialized) {
+    if (not coefficients_initialized && not on_the_fly) {
         // This is called from here since it needs the kr values
         // which can be obtained from the SpectralFieldDataRZ
         InitializeSpectralCoefficients(f);
@@ -67,15 +171,25 @@ GalileanPsatdAlgorithmRZ::pushSpectralFields (SpectralFieldDataRZ & f)
 
         // Extract arrays for the fields to be updated
         amrex::Array4<Complex> const& fields = f.fields[mfi].array();
-        // Extract arrays for the coefficients
-        amrex::Array4<const amrex::Real> const& C_arr = C_coef[mfi].array();
-        amrex::Array4<const amrex::Real> const& S_ck_arr = S_ck_coef[mfi].array();
-        amrex::Array4<const Complex> const& X1_arr = X1_coef[mfi].array();
-        amrex::Array4<const Complex> const& X2_arr = X2_coef[mfi].array();
-        amrex::Array4<const Complex> const& X3_arr = X3_coef[mfi].array();
-        amrex::Array4<const Complex> const& X4_arr = X4_coef[mfi].array();
-        amrex::Array4<const Complex> const& Theta2_arr = Theta2_coef[mfi].array();
-        amrex::Array4<const Complex> const& T_rho_arr = T_rho_coef[mfi].array();
+        // Extract arrays for the coefficients, unless they are computed on the fly
+        amrex::Array4<const amrex::Real> C_arr;
+        amrex::Array4<const amrex::Real> S_ck_arr;
+        amrex::Array4<const Complex> X1_arr;
+        amrex::Array4<const Complex> X2_arr;
+        amrex::Array4<const Complex> X3_arr;
+        amrex::Array4<const Complex> X4_arr;
+        amrex::Array4<const Complex> Theta2_arr;
+        amrex::Array4<const Complex> T_rho_arr;
+        if (not on_the_fly) {
+            C_arr = C_coef[mfi].array();
+            S_ck_arr = S_ck_coef[mfi].array();
+            X1_arr = X1_coef[mfi].array();
+            X2_arr = X2_coef[mfi].array();
+            X3_arr = X3_coef[mfi].array();
+            X4_arr = X4_coef[mfi].array();
+            Theta2_arr = Theta2_coef[mfi].array();
+            T_rho_arr = T_rho_coef[mfi].array();
+        }
 
         // Extract pointers for the k vectors
         auto const & kr_modes = f.getKrArray(mfi);
@@ -126,14 +240,27 @@ GalileanPsatdAlgorithmRZ::pushSpectralFields (SpectralFieldDataRZ & f)
 
             constexpr amrex::Real c2 = PhysConst::c*PhysConst::c;
             Complex const I = Complex{0._rt,1._rt};
-            amrex::Real const C = C_arr(i,j,k,mode);
-            amrex::Real const S_ck = S_ck_arr(i,j,k,mode);
-            Complex const X1 = X1_arr(i,j,k,mode);
-            Complex const X2 = X2_arr(i,j,k,mode);
-            Complex const X3 = X3_arr(i,j,k,mode);
-            Complex const X4 = X4_arr(i,j,k,mode);
-            Complex const T2 = Theta2_arr(i,j,k,mode);
-            Complex const T_rho = T_rho_arr(i,j,k,mode);
+            GalileanPsatdCoefficientsRZ coef;
+            if (on_the_fly) {
+                coef = ComputeCoefficients(kr, kz, vz, dt);
+            } else {
+                coef.C = C_arr(i,j,k,mode);
+                coef.S_ck = S_ck_arr(i,j,k,mode);
+                coef.X1 = X1_arr(i,j,k,mode);
+                coef.X2 = X2_arr(i,j,k,mode);
+                coef.X3 = X3_arr(i,j,k,mode);
+                coef.X4 = X4_arr(i,j,k,mode);
+                coef.Theta2 = Theta2_arr(i,j,k,mode);
+                coef.T_rho = T_rho_arr(i,j,k,mode);
+            }
+            amrex::Real const C = coef.C;
+            amrex::Real const S_ck = coef.S_ck;
+            Complex const X1 = coef.X1;
+            Complex const X2 = coef.X2;
+            Complex const X3 = coef.X3;
+            Complex const X4 = coef.X4;
+            Complex const T2 = coef.Theta2;
+            Complex const T_rho = coef.T_rho;
 
             Complex rho_diff;
             if (update_with_rho) {
@@ -207,80 +334,21 @@ void GalileanPsatdAlgorithmRZ::InitializeSpectralCoefficients (SpectralFieldData
         amrex::ParallelFor(bx, modes,
         [=] AMREX_GPU_DEVICE(int i, int j, int k, int mode) noexcept
         {
-            constexpr amrex::Real c = PhysConst::c;
-            constexpr amrex::Real ep0 = PhysConst::ep0;
-            Complex const I = Complex{0._rt,1._rt};
-
-            // Calculate norm of vector
+            // Radial and longitudinal k values
             int const ir = i + nr*mode;
             amrex::Real const kr = kr_arr[ir];
             amrex::Real const kz = modified_kz[j];
-            amrex::Real const k_norm = std::sqrt(kr*kr + kz*kz);
-
-            // Calculate coefficients
-            if (k_norm != 0._rt){
-
-                C(i,j,k,mode) = std::cos(c*k_norm*dt);
-                S_ck(i,j,k,mode) = std::sin(c*k_norm*dt)/(c*k_norm);
-
-                // Calculate dot product with galilean velocity
-                amrex::Real const kv = kz*vz;
-
-                amrex::Real const nu = kv/(k_norm*c);
-                Complex const theta = amrex::exp( 0.5_rt*I*kv*dt );
-                Complex const theta_star = amrex::exp( -0.5_rt*I*kv*dt );
-                Complex const e_theta = amrex::exp( I*c*k_norm*dt );
-
-                Theta2(i,j,k,mode) = theta*theta;
-
-                if (kz == 0._rt) {
-                    T_rho(i,j,k,mode) = -dt;
-                } else {
-                    T_rho(i,j,k,mode) = (1._rt - theta*theta)/(I*kz*vz);
-                }
-
-                if ( (nu != 1._rt) && (nu != 0._rt) ) {
-
-                    // Note: the coefficients X1, X2, X do not correspond
-                    // exactly to the original Galilean paper, but the
-                    // update equation have been modified accordingly so that
-                    // the expressions below (with the update equations)
-                    // are mathematically equivalent to those of the paper.
-                    Complex x1 = 1._rt/(1._rt-nu*nu) *
-                        (theta_star - C(i,j,k,mode)*theta + I*kv*S_ck(i,j,k,mode)*theta);
-                    // x1, above, is identical to the original paper
-                    X1(i,j,k,mode) = theta*x1/(ep0*c*c*k_norm*k_norm);
-                    // The difference betwen X2 and X3 below, and those
-                    // from the original paper is the factor ep0*k_norm*k_norm
-                    X2(i,j,k,mode) = (x1 - theta*(1._rt - C(i,j,k,mode)))
-                                     /(theta_star-theta)/(ep0*k_norm*k_norm);
-                    X3(i,j,k,mode) = (x1 - theta_star*(1._rt - C(i,j,k,mode)))
-                                     /(theta_star-theta)/(ep0*k_norm*k_norm);
-                    X4(i,j,k,mode) = I*kv*X1(i,j,k,mode) - theta*theta*S_ck(i,j,k,mode)/ep0;
-
-                } else if (nu == 0._rt) {
-
-                    X1(i,j,k,mode) = (1._rt - C(i,j,k,mode))/(ep0 * c*c * k_norm*k_norm);
-                    X2(i,j,k,mode) = (1._rt - S_ck(i,j,k,mode)/dt)/(ep0 * k_norm*k_norm);
-                    X3(i,j,k,mode) = (C(i,j,k,mode) - S_ck(i,j,k,mode)/dt)/(ep0 * k_norm*k_norm);
-                    X4(i,j,k,mode) = -S_ck(i,j,k,mode)/ep0;
-
-                } else if ( nu == 1._rt) {
-                    X1(i,j,k,mode) = (1._rt - e_theta*e_theta + 2._rt*I*c*k_norm*dt) / (4._rt*c*c*ep0*k_norm*k_norm);
-                    X2(i,j,k,mode) = (3._rt - 4._rt*e_theta + e_theta*e_theta + 2._rt*I*c*k_norm*dt) / (4._rt*ep0*k_norm*k_norm*(1._rt - e_theta));
-                    X3(i,j,k,mode) = (3._rt - 2._rt/e_theta - 2._rt*e_theta + e_theta*e_theta - 2._rt*I*c*k_norm*dt) / (4._rt*ep0*(e_theta - 1._rt)*k_norm*k_norm);
-                    X4(i,j,k,mode) = I*(-1._rt + e_theta*e_theta + 2._rt*I*c*k_norm*dt) / (4._rt*ep0*c*k_norm);
-                }
-
-            } else { // Handle k_norm = 0, by using the analytical limit
-                C(i,j,k,mode) = 1._rt;
-                S_ck(i,j,k,mode) = dt;
-                X1(i,j,k,mode) = 0.5_rt * dt*dt / ep0;
-                X2(i,j,k,mode) = c*c * dt*dt / (6._rt*ep0);
-                X3(i,j,k,mode) = - c*c * dt*dt / (3._rt*ep0);
-                X4(i,j,k,mode) = -dt/ep0;
-                Theta2(i,j,k,mode) = 1._rt;
-            }
+
+            GalileanPsatdCoefficientsRZ const coef = ComputeCoefficients(kr, kz, vz, dt);
+
+            C(i,j,k,mode) = coef.C;
+            S_ck(i,j,k,mode) = coef.S_ck;
+            X1(i,j,k,mode) = coef.X1;
+            X2(i,j,k,mode) = coef.X2;
+            X3(i,j,k,mode) = coef.X3;
+            X4(i,j,k,mode) = coef.X4;
+            Theta2(i,j,k,mode) = coef.Theta2;
+            T_rho(i,j,k,mode) = coef.T_rho;
         });
      }
 }
@@ -297,11 +365,10 @@ GalileanPsatdAlgorithmRZ::CurrentCorrection (const int lev,
     using Idx = SpectralFieldIndex;
 
     // Forward Fourier transform of J and rho
-    field_data.ForwardTransform( lev, *current[0], Idx::Jx,
-                                 *current[1], Idx::Jy);
-    field_data.ForwardTransform( lev, *current[2], Idx::Jz, 0);
-    field_data.ForwardTransform( lev, *rho, Idx::rho_old, 0 );
-    field_data.ForwardTransform( lev, *rho, Idx::rho_new, 1 );
+    using Input = SpectralFieldDataRZ::ForwardTransformInput;
+    field_data.ForwardTransform( lev, {
+        Input(*current[0], Idx::Jx, *current[1], Idx::Jy), Input(*current[2], Idx::Jz, 0),
+        Input(*rho, Idx::rho_old, 0), Input(*rho, Idx::rho_new, 1)});
 
     // Loop over boxes
     for (amrex::MFIter mfi(field_data.fields); mfi.isValid(); ++mfi){
@@ -365,11 +432,9 @@ GalileanPsatdAlgorithmRZ::CurrentCorrection (const int lev,
     }
 
     // Backward Fourier transform of J
-    field_data.BackwardTransform( lev,
-                                  *current[0], Idx::Jx,
-                                  *current[1], Idx::Jy);
-    field_data.BackwardTransform( lev, *current[2], Idx::Jz, 0 );
-
+    using Output = SpectralFieldDataRZ::BackwardTransformOutput;
+    field_data.BackwardTransform( lev, {
+        Output(*current[0], Idx::Jx, *current[1], Idx::Jy), Output(*current[2], Idx::Jz, 0)});
 }
 
 void
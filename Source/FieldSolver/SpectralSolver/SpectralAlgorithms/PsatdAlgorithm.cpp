@@ -5,6 +5,7 @@
  * License: BSD-3-Clause-LBNL
  */
 #include "PsatdAlgorithm.H"
+#include "WarpX.H"
 #include "Utils/WarpXConst.H"
 
 #include <cmath>
@@ -13,6 +14,309 @@
 
 using namespace amrex;
 
+namespace
+{
+    /** Coefficients of the PSATD update equations at one point of the spectral grid */
+    struct PsatdCoefficients
+    {
+        amrex::Real C, S_ck;
+        Complex T2, X1, X2, X3, X4;
+    };
+
+    /** Additional coefficients of the averaged Galilean PSATD update equations */
+    struct PsatdAveragingCoefficients
+    {
+        Complex Psi1, Psi2, Y1, Y2, Y3, Y4;
+    };
+
+    /**
+     * \brief Coefficients of the update equations for E and B at one point of the spectral grid
+     *
+     * \param[in] knorm_s norm of the (staggered) modified k vector
+     * \param[in] w_c dot product of the centered modified k vector with the Galilean velocity
+     * \param[in] dt time step of the simulation
+     * \param[in] update_with_rho whether the update equation for E uses rho or not
+     */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    PsatdCoefficients
+    ComputeCoefficients (const amrex::Real knorm_s, const amrex::Real w_c,
+                         const amrex::Real dt, const bool update_with_rho) noexcept
+    {
+        PsatdCoefficients coef;
+
+        // Physical constants and imaginary unit
+        constexpr amrex::Real c = PhysConst::c;
+        constexpr amrex::Real ep0 = PhysConst::ep0;
+        constexpr Complex I = Complex{0._rt, 1._rt};
+
+        const amrex::Real c2 = std::pow(c, 2);
+        const amrex::Real dt2 = std::pow(dt, 2);
+        const amrex::Real dt3 = std::pow(dt, 3);
+
+        const amrex::Real w2_c = std::pow(w_c, 2);
+
+        const amrex::Real om_s = c * knorm_s;
+        const amrex::Real om2_s = std::pow(om_s, 2);
+
+        const Complex theta_c      = amrex::exp( I * w_c * dt * 0.5_rt);
+        const Complex theta2_c     = amrex::exp( I * w_c * dt);
+        const Complex theta_c_star = amrex::exp(-I * w_c * dt * 0.5_rt);
+
+        // C
+        coef.C = std::cos(om_s * dt);
+
+        // S_ck
+        if (om_s != 0.)
+        {
+            coef.S_ck = std::sin(om_s * dt) / om_s;
+        }
+        else // om_s = 0
+        {
+            coef.S_ck = dt;
+        }
+
+        // Auxiliary variable
+        amrex::Real tmp;
+        if (om_s != 0.)
+        {
+            tmp = (1._rt - coef.C) / (ep0 * om2_s);
+        }
+        else // om_s = 0
+        {
+            tmp = 0.5_rt * dt2 / ep0;
+        }
+
+        // T2 (T2 = 1 with standard PSATD)
+        coef.T2 = theta_c * theta_c;
+
+        // X1 (multiplies i*([k] \times J) in the update equation for update B)
+        if ((om_s != 0.) || (w_c != 0.))
+        {
+            coef.X1 = (1._rt - theta2_c * coef.C + I * w_c * theta2_c * coef.S_ck)
+                      / (ep0 * (om2_s - w2_c));
+        }
+        else // om_s = 0 and w_c = 0
+        {
+            coef.X1 = 0.5_rt * dt2 / ep0;
+        }
+
+        // X2 (multiplies rho_new      if update_with_rho = 1 in the update equation for E)
+        // X2 (multiplies ([k] \dot E) if update_with_rho = 0 in the update equation for E)
+        if (update_with_rho)
+        {
+            if (w_c != 0.)
+            {
+                coef.X2 = c2 * (theta_c_star * coef.X1 - theta_c * tmp)
+                          / (theta_c_star - theta_c);
+            }
+            else // w_c = 0
+            {
+                if (om_s != 0.)
+                {
+                    coef.X2 = c2 * (dt - coef.S_ck) / (ep0 * dt * om2_s);
+                }
+                else // om_s = 0 and w_c = 0
+                {
+                    coef.X2 = c2 * dt2 / (6._rt * ep0);
+                }
+            }
+        }
+        else // update_with_rho = 0
+        {
+            coef.X2 = c2 * ep0 * theta2_c * tmp;
+        }
+
+        // X3 (multiplies rho_old      if update_with_rho = 1 in the update equation for E)
+        // X3 (multiplies ([k] \dot J) if update_with_rho = 0 in the update equation for E)
+        if (update_with_rho)
+        {
+            if (w_c != 0.)
+            {
+                coef.X3 = c2 * (theta_c_star * coef.X1 - theta_c_star * tmp)
+                          / (theta_c_star - theta_c);
+            }
+            else // w_c = 0
+            {
+                if (om_s != 0.)
+                {
+                    coef.X3 = c2 * (dt * coef.C - coef.S_ck) / (ep0 * dt * om2_s);
+                }
+                else // om_s = 0 and w_c = 0
+                {
+                    coef.X3 = - c2 * dt2 / (3._rt * ep0);
+                }
+            }
+        }
+        else // update_with_rho = 0
+        {
+            if (w_c != 0.)
+            {
+                coef.X3 = I * c2 * (theta2_c * tmp - coef.X1) / w_c;
+            }
+            else // w_c = 0
+            {
+                if (om_s != 0.)
+                {
+                    coef.X3 = c2 * (coef.S_ck - dt) / (ep0 * om2_s);
+                }
+                else // om_s = 0 and w_c = 0
+                {
+                    coef.X3 = - c2 * dt3 / (6._rt * ep0);
+                }
+            }
+        }
+
+        // X4 (multiplies J in the update equation for E)
+        coef.X4 = I * w_c * coef.X1 - theta2_c * coef.S_ck / ep0;
+
+        return coef;
+    }
+
+    /**
+     * \brief Coefficients of the update equations for the time-averaged E and B
+     * at one point of the spectral grid (arguments as in \c ComputeCoefficients)
+     */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    PsatdAveragingCoefficients
+    ComputeCoefficientsAveraging (const amrex::Real knorm_s, const amrex::Real w_c,
+                                  const amrex::Real dt) noexcept
+    {
+        PsatdAveragingCoefficients coef;
+
+        // Physical constants and imaginary unit
+        constexpr amrex::Real c = PhysConst::c;
+        constexpr amrex::Real ep0 = PhysConst::ep0;
+        constexpr Complex I = Complex{0._rt, 1._rt};
+
+        const amrex::Real c2 = std::pow(c, 2);
+        const amrex::Real dt2 = std::pow(dt, 2);
+
+        const amrex::Real w2_c = std::pow(w_c, 2);
+        const amrex::Real w3_c = std::pow(w_c, 3);
+
+        const amrex::Real om_s = c * knorm_s;
+        const amrex::Real om2_s = std::pow(om_s, 2);
+        const amrex::Real om4_s = std::pow(om_s, 4);
+
+        const Complex theta_c  = amrex::exp(I * w_c * dt * 0.5_rt);
+        const Complex theta2_c = amrex::exp(I * w_c * dt);
+        const Complex theta3_c = amrex::exp(I * w_c * dt * 1.5_rt);
+        const Complex theta5_c = amrex::exp(I * w_c * dt * 2.5_rt);
+
+        // C1,C3
+        const amrex::Real C1 = std::cos(0.5_rt * om_s * dt);
+        const amrex::Real C3 = std::cos(1.5_rt * om_s * dt);
+
+        // S1_om, S3_om
+        amrex::Real S1_om, S3_om;
+        if (om_s != 0.)
+        {
+            S1_om = std::sin(0.5_rt * om_s * dt) / om_s;
+            S3_om = std::sin(1.5_rt * om_s * dt) / om_s;
+        }
+        else // om_s = 0
+        {
+            S1_om = 0.5_rt * dt;
+            S3_om = 1.5_rt * dt;
+        }
+
+        // Psi1 (multiplies E in the update equation for <E>)
+        // Psi1 (multiplies B in the update equation for <B>)
+        if ((om_s != 0.) || (w_c != 0.))
+        {
+            coef.Psi1 = (theta3_c * (om2_s * S3_om + I * w_c * C3)
+                        - theta_c * (om2_s * S1_om + I * w_c * C1)) / (dt * (om2_s - w2_c));
+        }
+        else // om_s = 0 and w_c = 0
+        {
+            coef.Psi1 = 1._rt;
+        }
+
+        // Psi2 (multiplies i*([k] \times B) in the update equation for <E>)
+        // Psi2 (multiplies i*([k] \times E) in the update equation for <B>)
+        if ((om_s != 0.) || (w_c != 0.))
+        {
+            coef.Psi2 = (theta3_c * (C3 - I * w_c * S3_om)
+                        - theta_c * (C1 - I * w_c * S1_om)) / (dt * (om2_s - w2_c));
+        }
+        else // om_s = 0 and w_c = 0
+        {
+            coef.Psi2 = - dt;
+        }
+
+        // Psi3
+        Complex Psi3;
+        if (w_c != 0.)
+        {
+            Psi3 = - I * (theta3_c - theta_c) / (dt * w_c);
+        }
+        else // w_c = 0
+        {
+            Psi3 = 1._rt;
+        }
+
+        // Y1 (multiplies i*([k] \times J) in the update equation for <B>)
+        if ((om_s != 0.) || (w_c != 0.))
+        {
+            coef.Y1 = (1._rt - coef.Psi1 - I * w_c * coef.Psi2) / (ep0 * (om2_s - w2_c));
+        }
+        else // om_s = 0 and w_c = 0
+        {
+            coef.Y1 = 13._rt * dt2 / (24._rt * ep0);
+        }
+
+        // Y2 (multiplies rho_new in the update equation for <E>)
+        if ((om_s != 0.) && (w_c != 0.))
+        {
+            coef.Y2 = I * c2 * (ep0 * om2_s * coef.Y1 - Psi3 + coef.Psi1)
+                      / (ep0 * om2_s * (theta2_c - 1._rt));
+        }
+        else if ((om_s != 0.) && (w_c == 0.))
+        {
+            coef.Y2 = I * c2 * (C1 - C3 - dt2 * om2_s) / (ep0 * dt2 * om4_s);
+        }
+        else if ((om_s == 0.) && (w_c != 0.))
+        {
+            coef.Y2 = c2 * (9._rt * dt2 * w2_c * theta3_c - dt2 * w2_c * theta_c
+                      - 24._rt * theta3_c + 24._rt * theta_c + I * 8._rt * dt * w_c
+                      + I * 24._rt * dt * w_c * theta3_c - I * 8._rt * dt * w_c * theta_c)
+                      / (8._rt * ep0 * dt * w3_c * (1._rt - theta2_c));
+        }
+        else // om_s = 0 and w_c = 0
+        {
+            coef.Y2 = - I * 5._rt * c2 * dt2 / (24._rt * ep0);
+        }
+
+        // Y3 (multiplies rho_old in the update equation for <E>)
+        if ((om_s != 0.) && (w_c != 0.))
+        {
+            coef.Y3 = I * c2 * (Psi3 - coef.Psi1 - ep0 * theta2_c * om2_s * coef.Y1)
+                      / (ep0 * om2_s * (theta2_c - 1._rt));
+        }
+        else if ((om_s != 0.) && (w_c == 0.))
+        {
+            coef.Y3 = I * c2 * (C3 - C1 + dt * om2_s * (S3_om - S1_om)) / (ep0 * dt2 * om4_s);
+        }
+        else if ((om_s == 0.) && (w_c != 0.))
+        {
+            coef.Y3 = c2 * (9._rt * dt2 * w2_c * theta3_c - dt2 * w2_c * theta_c
+                      - 16._rt * theta5_c + 8._rt * theta3_c + 8._rt * theta_c
+                      + I * 12._rt * dt * w_c * theta5_c + I * 8._rt * dt * w_c * theta3_c
+                      - I * 4._rt * dt * w_c * theta_c + I * 8._rt * dt * w_c * theta2_c)
+                      / (8._rt * ep0 * dt * w3_c * (theta2_c - 1._rt));
+        }
+        else // om_s = 0 and w_c = 0
+        {
+            coef.Y3 = - I * c2 * dt2 / (3._rt * ep0);
+        }
+
+        // Y4 (multiplies J in the update equation for <E>)
+        coef.Y4 = (coef.Psi2 + I * ep0 * w_c * coef.Y1) / ep0;
+
+        return coef;
+    }
+}
+
 PsatdAlgorithm::PsatdAlgorithm(
     const SpectralKSpace& spectral_kspace,
     const DistributionMapping& dm,
@@ -39,12 +343,17 @@ PsatdAlgorithm::PsatdAlgorithm(
     m_v_galilean(v_galilean),
     m_dt(dt),
     m_update_with_rho(update_with_rho),
-    m_time_averaging(time_averaging)
+    m_time_averaging(time_averaging),
+    m_on_the_fly_coefficients(WarpX::fft_on_the_fly_coefficients)
 {
     const amrex::BoxArray& ba = spectral_kspace.spectralspace_ba;
 
     m_is_galilean = (v_galilean[0] != 0.) || (v_galilean[1] != 0.) || (v_galilean[2] != 0.);
 
+    // With on-the-fly coefficients, only the k vectors are stored
+    // and the coefficients are computed in pushSpectralFields
+    if (m_on_the_fly_coefficients) return;
+
     // Always allocate these coefficients
     C_coef = SpectralRealCoefficients(ba, dm, 1, 0);
     S_ck_coef = SpectralRealCoefficients(ba, dm, 1, 0);
@@ -80,6 +389,15 @@ PsatdAlgorithm::pushSpectralFields (SpectralFieldData& f) const
     const bool update_with_rho = m_update_with_rho;
     const bool time_averaging  = m_time_averaging;
     const bool is_galilean     = m_is_galilean;
+    const bool on_the_fly      = m_on_the_fly_coefficients;
+    const amrex::Real dt       = m_dt;
+
+    // Extract Galilean velocity
+    const amrex::Real vg_x = m_v_galilean[0];
+#if (AMREX_SPACEDIM == 3)
+    const amrex::Real vg_y = m_v_galilean[1];
+#endif
+    const amrex::Real vg_z = m_v_galilean[2];
 
     // Loop over boxes
     for (amrex::MFIter mfi(f.fields); mfi.isValid(); ++mfi)
@@ -89,20 +407,15 @@ PsatdAlgorithm::pushSpectralFields (SpectralFieldData& f) const
         // Extract arrays for the fields to be updated
         amrex::Array4<Complex> fields = f.fields[mfi].array();
 
-        // These coefficients are always allocated
-        amrex::Array4<const amrex::Real> C_arr = C_coef[mfi].array();
-        amrex::Array4<const amrex::Real> S_ck_arr = S_ck_coef[mfi].array();
-        amrex::Array4<const Complex> X1_arr = X1_coef[mfi].array();
-        amrex::Array4<const Complex> X2_arr = X2_coef[mfi].array();
-        amrex::Array4<const Complex> X3_arr = X3_coef[mfi].array();
+        // These coefficients are always allocated, unless they are computed on the fly
+        amrex::Array4<const amrex::Real> C_arr;
+        amrex::Array4<const amrex::Real> S_ck_arr;
+        amrex::Array4<const Complex> X1_arr;
+        amrex::Array4<const Complex> X2_arr;
+        amrex::Array4<const Complex> X3_arr;
 
         amrex::Array4<const Complex> X4_arr;
         amrex::Array4<const Complex> T2_arr;
-        if (is_galilean)
-        {
-            X4_arr = X4_coef[mfi].array();
-            T2_arr = T2_coef[mfi].array();
-        }
 
         // These coefficients are allocated only with averaged Galilean PSATD
         amrex::Array4<const Complex> Psi1_arr;
@@ -112,22 +425,40 @@ PsatdAlgorithm::pushSpectralFields (SpectralFieldData& f) const
         amrex::Array4<const Complex> Y3_arr;
         amrex::Array4<const Complex> Y4_arr;
 
-        if (time_averaging)
+        if (!on_the_fly)
         {
-            Psi1_arr = Psi1_coef[mfi].array();
-            Psi2_arr = Psi2_coef[mfi].array();
-            Y1_arr = Y1_coef[mfi].array();
-            Y2_arr = Y2_coef[mfi].array();
-            Y3_arr = Y3_coef[mfi].array();
-            Y4_arr = Y4_coef[mfi].array();
+            C_arr = C_coef[mfi].array();
+            S_ck_arr = S_ck_coef[mfi].array();
+            X1_arr = X1_coef[mfi].array();
+            X2_arr = X2_coef[mfi].array();
+            X3_arr = X3_coef[mfi].array();
+
+            if (is_galilean)
+            {
+                X4_arr = X4_coef[mfi].array();
+                T2_arr = T2_coef[mfi].array();
+            }
+
+            if (time_averaging)
+            {
+                Psi1_arr = Psi1_coef[mfi].array();
+                Psi2_arr = Psi2_coef[mfi].array();
+                Y1_arr = Y1_coef[mfi].array();
+                Y2_arr = Y2_coef[mfi].array();
+                Y3_arr = Y3_coef[mfi].array();
+                Y4_arr = Y4_coef[mfi].array();
+            }
         }
 
         // Extract pointers for the k vectors
         const amrex::Real* modified_kx_arr = modified_kx_vec[mfi].dataPtr();
+        const amrex::Real* kx_c = modified_kx_vec_centered[mfi].dataPtr();
 #if (AMREX_SPACEDIM == 3)
         const amrex::Real* modified_ky_arr = modified_ky_vec[mfi].dataPtr();
+        const amrex::Real* ky_c = modified_ky_vec_centered[mfi].dataPtr();
 #endif
         const amrex::Real* modified_kz_arr = modified_kz_vec[mfi].dataPtr();
+        const amrex::Real* kz_c = modified_kz_vec_centered[mfi].dataPtr();
 
         // Loop over indices within one box
         ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept
@@ -163,14 +494,44 @@ PsatdAlgorithm::pushSpectralFields (SpectralFieldData& f) const
             const amrex::Real c2 = std::pow(PhysConst::c, 2);
             constexpr Complex I = Complex{0._rt, 1._rt};
 
-            // These coefficients are initialized in the function InitializeSpectralCoefficients
-            const amrex::Real C = C_arr(i,j,k);
-            const amrex::Real S_ck = S_ck_arr(i,j,k);
-            const Complex X1 = X1_arr(i,j,k);
-            const Complex X2 = X2_arr(i,j,k);
-            const Complex X3 = X3_arr(i,j,k);
-            const Complex X4 = (is_galilean) ? X4_arr(i,j,k) : - S_ck / PhysConst::ep0;
-            const Complex T2 = (is_galilean) ? T2_arr(i,j,k) : 1.0_rt;
+            // Norm of the k vector and dot product of the centered k vector
+            // with the Galilean velocity, used only with on-the-fly coefficients
+            amrex::Real knorm_s = 0._rt;
+            amrex::Real w_c = 0._rt;
+            if (on_the_fly)
+            {
+                knorm_s = std::sqrt(kx*kx + ky*ky + kz*kz);
+#if (AMREX_SPACEDIM == 3)
+                w_c = kx_c[i]*vg_x + ky_c[j]*vg_y + kz_c[k]*vg_z;
+#else
+                w_c = kx_c[i]*vg_x + kz_c[j]*vg_z;
+#endif
+            }
+
+            // These coefficients are initialized in the function InitializeSpectralCoefficients,
+            // or computed here with the same formulas if they are not stored
+            PsatdCoefficients coef;
+            if (on_the_fly)
+            {
+                coef = ComputeCoefficients(knorm_s, w_c, dt, update_with_rho);
+            }
+            else
+            {
+                coef.C = C_arr(i,j,k);
+                coef.S_ck = S_ck_arr(i,j,k);
+                coef.X1 = X1_arr(i,j,k);
+                coef.X2 = X2_arr(i,j,k);
+                coef.X3 = X3_arr(i,j,k);
+                coef.X4 = (is_galilean) ? X4_arr(i,j,k) : - coef.S_ck / PhysConst::ep0;
+                coef.T2 = (is_galilean) ? T2_arr(i,j,k) : 1.0_rt;
+            }
+            const amrex::Real C = coef.C;
+            const amrex::Real S_ck = coef.S_ck;
+            const Complex X1 = coef.X1;
+            const Complex X2 = coef.X2;
+            const Complex X3 = coef.X3;
+            const Complex X4 = coef.X4;
+            const Complex T2 = coef.T2;
 
             // Update equations for E in the formulation with rho
             // T2 = 1 always with standard PSATD (zero Galilean velocity)
@@ -230,13 +591,28 @@ PsatdAlgorithm::pushSpectralFields (SpectralFieldData& f) const
 
             if (time_averaging)
             {
-                // These coefficients are initialized in the function InitializeSpectralCoefficients below
-                const Complex Psi1 = Psi1_arr(i,j,k);
-                const Complex Psi2 = Psi2_arr(i,j,k);
-                const Complex Y1 = Y1_arr(i,j,k);
-                const Complex Y3 = Y3_arr(i,j,k);
-                const Complex Y2 = Y2_arr(i,j,k);
-                const Complex Y4 = Y4_arr(i,j,k);
+                // These coefficients are initialized in the function InitializeSpectralCoefficientsAveraging,
+                // or computed here with the same formulas if they are not stored
+                PsatdAveragingCoefficients avg;
+                if (on_the_fly)
+                {
+                    avg = ComputeCoefficientsAveraging(knorm_s, w_c, dt);
+                }
+                else
+                {
+                    avg.Psi1 = Psi1_arr(i,j,k);
+                    avg.Psi2 = Psi2_arr(i,j,k);
+                    avg.Y1 = Y1_arr(i,j,k);
+                    avg.Y2 = Y2_arr(i,j,k);
+                    avg.Y3 = Y3_arr(i,j,k);
+                    avg.Y4 = Y4_arr(i,j,k);
+                }
+                const Complex Psi1 = avg.Psi1;
+                const Complex Psi2 = avg.Psi2;
+                const Complex Y1 = avg.Y1;
+                const Complex Y3 = avg.Y3;
+                const Complex Y2 = avg.Y2;
+                const Complex Y4 = avg.Y4;
 
                 fields(i,j,k,AvgIdx::Ex_avg) = Psi1 * Ex_old
                                                - I * c2 * Psi2 * (ky * Bz_old - kz * By_old)
@@ -324,15 +700,6 @@ void PsatdAlgorithm::InitializeSpectralCoefficients (
 #else
                 std::pow(kz_s[j], 2));
 #endif
-            // Physical constants and imaginary unit
-            constexpr amrex::Real c = PhysConst::c;
-            constexpr amrex::Real ep0 = PhysConst::ep0;
-            constexpr Complex I = Complex{0._rt, 1._rt};
-
-            const amrex::Real c2 = std::pow(c, 2);
-            const amrex::Real dt2 = std::pow(dt, 2);
-            const amrex::Real dt3 = std::pow(dt, 3);
-
             // Calculate the dot product of the k vector with the Galilean velocity.
             // This has to be computed always with the centered (that is, nodal) finite-order
             // modified k vectors, to work correctly for both nodal and staggered simulations.
@@ -343,126 +710,19 @@ void PsatdAlgorithm::InitializeSpectralCoefficients (
 #else
                 kz_c[j]*vg_z;
 #endif
-            const amrex::Real w2_c = std::pow(w_c, 2);
-
-            const amrex::Real om_s = c * knorm_s;
-            const amrex::Real om2_s = std::pow(om_s, 2);
+            const PsatdCoefficients coef = ComputeCoefficients(knorm_s, w_c, dt, update_with_rho);
 
-            const Complex theta_c      = amrex::exp( I * w_c * dt * 0.5_rt);
-            const Complex theta2_c     = amrex::exp( I * w_c * dt);
-            const Complex theta_c_star = amrex::exp(-I * w_c * dt * 0.5_rt);
-
-            // C
-            C(i,j,k) = std::cos(om_s * dt);
-
-            // S_ck
-            if (om_s != 0.)
-            {
-                S_ck(i,j,k) = std::sin(om_s * dt) / om_s;
-            }
-            else // om_s = 0
-            {
-                S_ck(i,j,k) = dt;
-            }
-
-            // Auxiliary variable
-            amrex::Real tmp;
-            if (om_s != 0.)
-            {
-                tmp = (1._rt - C(i,j,k)) / (ep0 * om2_s);
-            }
-            else // om_s = 0
-            {
-                tmp = 0.5_rt * dt2 / ep0;
-            }
-
-            // T2
-            if (is_galilean)
-            {
-                T2(i,j,k) = theta_c * theta_c;
-            }
-
-            // X1 (multiplies i*([k] \times J) in the update equation for update B)
-            if ((om_s != 0.) || (w_c != 0.))
-            {
-                X1(i,j,k) = (1._rt - theta2_c * C(i,j,k) + I * w_c * theta2_c * S_ck(i,j,k))
-                            / (ep0 * (om2_s - w2_c));
-            }
-            else // om_s = 0 and w_c = 0
-            {
-                X1(i,j,k) = 0.5_rt * dt2 / ep0;
-            }
-
-            // X2 (multiplies rho_new      if update_with_rho = 1 in the update equation for E)
-            // X2 (multiplies ([k] \dot E) if update_with_rho = 0 in the update equation for E)
-            if (update_with_rho)
-            {
-                if (w_c != 0.)
-                {
-                    X2(i,j,k) = c2 * (theta_c_star * X1(i,j,k) - theta_c * tmp)
-                                / (theta_c_star - theta_c);
-                }
-                else // w_c = 0
-                {
-                    if (om_s != 0.)
-                    {
-                        X2(i,j,k) = c2 * (dt - S_ck(i,j,k)) / (ep0 * dt * om2_s);
-                    }
-                    else // om_s = 0 and w_c = 0
-                    {
-                        X2(i,j,k) = c2 * dt2 / (6._rt * ep0);
-                    }
-                }
-            }
-            else // update_with_rho = 0
-            {
-                X2(i,j,k) = c2 * ep0 * theta2_c * tmp;
-            }
-
-            // X3 (multiplies rho_old      if update_with_rho = 1 in the update equation for E)
-            // X3 (multiplies ([k] \dot J) if update_with_rho = 0 in the update equation for E)
-            if (update_with_rho)
-            {
-                if (w_c != 0.)
-                {
-                    X3(i,j,k) = c2 * (theta_c_star * X1(i,j,k) - theta_c_star * tmp)
-                                / (theta_c_star - theta_c);
-                }
-                else // w_c = 0
-                {
-                    if (om_s != 0.)
-                    {
-                        X3(i,j,k) = c2 * (dt * C(i,j,k) - S_ck(i,j,k)) / (ep0 * dt * om2_s);
-                    }
-                    else // om_s = 0 and w_c = 0
-                    {
-                        X3(i,j,k) = - c2 * dt2 / (3._rt * ep0);
-                    }
-                }
-            }
-            else // update_with_rho = 0
-            {
-                if (w_c != 0.)
-                {
-                    X3(i,j,k) = I * c2 * (theta2_c * tmp - X1(i,j,k)) / w_c;
-                }
-                else // w_c = 0
-                {
-                    if (om_s != 0.)
-                    {
-                        X3(i,j,k) = c2 * (S_ck(i,j,k) - dt) / (ep0 * om2_s);
-                    }
-                    else // om_s = 0 and w_c = 0
-                    {
-                        X3(i,j,k) = - c2 * dt3 / (6._rt * ep0);
-                    }
-                }
-            }
+            C(i,j,k) = coef.C;
+            S_ck(i,j,k) = coef.S_ck;
+            X1(i,j,k) = coef.X1;
+            X2(i,j,k) = coef.X2;
+            X3(i,j,k) = coef.X3;
 
-            // X4 (multiplies J in the update equation for E)
+            // T2 and X4 are stored only with Galilean PSATD
             if (is_galilean)
             {
-                X4(i,j,k) = I * w_c * X1(i,j,k) - theta2_c * S_ck(i,j,k) / ep0;
+                T2(i,j,k) = coef.T2;
+                X4(i,j,k) = coef.X4;
             }
         });
     }
@@ -516,14 +776,6 @@ void PsatdAlgorithm::InitializeSpectralCoefficientsAveraging (
 #else
                 std::pow(kz_s[j], 2));
 #endif
-            // Physical constants and imaginary unit
-            constexpr amrex::Real c = PhysConst::c;
-            constexpr amrex::Real ep0 = PhysConst::ep0;
-            constexpr Complex I = Complex{0._rt, 1._rt};
-
-            const amrex::Real c2 = std::pow(c, 2);
-            const amrex::Real dt2 = std::pow(dt, 2);
-
             // Calculate the dot product of the k vector with the Galilean velocity.
             // This has to be computed always with the centered (that is, nodal) finite-order
             // modified k vectors, to work correctly for both nodal and staggered simulations.
@@ -534,127 +786,14 @@ void PsatdAlgorithm::InitializeSpectralCoefficientsAveraging (
 #else
                 kz_c[j]*vg_z;
 #endif
-            const amrex::Real w2_c = std::pow(w_c, 2);
-            const amrex::Real w3_c = std::pow(w_c, 3);
-
-            const amrex::Real om_s = c * knorm_s;
-            const amrex::Real om2_s = std::pow(om_s, 2);
-            const amrex::Real om4_s = std::pow(om_s, 4);
-
-            const Complex theta_c  = amrex::exp(I * w_c * dt * 0.5_rt);
-            const Complex theta2_c = amrex::exp(I * w_c * dt);
-            const Complex theta3_c = amrex::exp(I * w_c * dt * 1.5_rt);
-            const Complex theta5_c = amrex::exp(I * w_c * dt * 2.5_rt);
-
-            // C1,C3
-            const amrex::Real C1 = std::cos(0.5_rt * om_s * dt);
-            const amrex::Real C3 = std::cos(1.5_rt * om_s * dt);
-
-            // S1_om, S3_om
-            amrex::Real S1_om, S3_om;
-            if (om_s != 0.)
-            {
-                S1_om = std::sin(0.5_rt * om_s * dt) / om_s;
-                S3_om = std::sin(1.5_rt * om_s * dt) / om_s;
-            }
-            else // om_s = 0
-            {
-                S1_om = 0.5_rt * dt;
-                S3_om = 1.5_rt * dt;
-            }
-
-            // Psi1 (multiplies E in the update equation for <E>)
-            // Psi1 (multiplies B in the update equation for <B>)
-            if ((om_s != 0.) || (w_c != 0.))
-            {
-                Psi1(i,j,k) = (theta3_c * (om2_s * S3_om + I * w_c * C3)
-                              - theta_c * (om2_s * S1_om + I * w_c * C1)) / (dt * (om2_s - w2_c));
-            }
-            else // om_s = 0 and w_c = 0
-            {
-                Psi1(i,j,k) = 1._rt;
-            }
-
-            // Psi2 (multiplies i*([k] \times B) in the update equation for <E>)
-            // Psi2 (multiplies i*([k] \times E) in the update equation for <B>)
-            if ((om_s != 0.) || (w_c != 0.))
-            {
-                Psi2(i,j,k) = (theta3_c * (C3 - I * w_c * S3_om)
-                              - theta_c * (C1 - I * w_c * S1_om)) / (dt * (om2_s - w2_c));
-            }
-            else // om_s = 0 and w_c = 0
-            {
-                Psi2(i,j,k) = - dt;
-            }
-
-            // Psi3
-            Complex Psi3;
-            if (w_c != 0.)
-            {
-                Psi3 = - I * (theta3_c - theta_c) / (dt * w_c);
-            }
-            else // w_c = 0
-            {
-                Psi3 = 1._rt;
-            }
-
-            // Y1 (multiplies i*([k] \times J) in the update equation for <B>)
-            if ((om_s != 0.) || (w_c != 0.))
-            {
-                Y1(i,j,k) = (1._rt - Psi1(i,j,k) - I * w_c * Psi2(i,j,k)) / (ep0 * (om2_s - w2_c));
-            }
-            else // om_s = 0 and w_c = 0
-            {
-                Y1(i,j,k) = 13._rt * dt2 / (24._rt * ep0);
-            }
-
-            // Y2 (multiplies rho_new in the update equation for <E>)
-            if ((om_s != 0.) && (w_c != 0.))
-            {
-                Y2(i,j,k) = I * c2 * (ep0 * om2_s * Y1(i,j,k) - Psi3 + Psi1(i,j,k))
-                            / (ep0 * om2_s * (theta2_c - 1._rt));
-            }
-            else if ((om_s != 0.) && (w_c == 0.))
-            {
-                Y2(i,j,k) = I * c2 * (C1 - C3 - dt2 * om2_s) / (ep0 * dt2 * om4_s);
-            }
-            else if ((om_s == 0.) && (w_c != 0.))
-            {
-                Y2(i,j,k) = c2 * (9._rt * dt2 * w2_c * theta3_c - dt2 * w2_c * theta_c
-                            - 24._rt * theta3_c + 24._rt * theta_c + I * 8._rt * dt * w_c
-                            + I * 24._rt * dt * w_c * theta3_c - I * 8._rt * dt * w_c * theta_c)
-                            / (8._rt * ep0 * dt * w3_c * (1._rt - theta2_c));
-            }
-            else // om_s = 0 and w_c = 0
-            {
-                Y2(i,j,k) = - I * 5._rt * c2 * dt2 / (24._rt * ep0);
-            }
-
-            // Y3 (multiplies rho_old in the update equation for <E>)
-            if ((om_s != 0.) && (w_c != 0.))
-            {
-                Y3(i,j,k) = I * c2 * (Psi3 - Psi1(i,j,k) - ep0 * theta2_c * om2_s * Y1(i,j,k))
-                            / (ep0 * om2_s * (theta2_c - 1._rt));
-            }
-            else if ((om_s != 0.) && (w_c == 0.))
-            {
-                Y3(i,j,k) = I * c2 * (C3 - C1 + dt * om2_s * (S3_om - S1_om)) / (ep0 * dt2 * om4_s);
-            }
-            else if ((om_s == 0.) && (w_c != 0.))
-            {
-                Y3(i,j,k) = c2 * (9._rt * dt2 * w2_c * theta3_c - dt2 * w2_c * theta_c
-                            - 16._rt * theta5_c + 8._rt * theta3_c + 8._rt * theta_c
-                            + I * 12._rt * dt * w_c * theta5_c + I * 8._rt * dt * w_c * theta3_c
-                            - I * 4._rt * dt * w_c * theta_c + I * 8._rt * dt * w_c * theta2_c)
-                            / (8._rt * ep0 * dt * w3_c * (theta2_c - 1._rt));
-            }
-            else // om_s = 0 and w_c = 0
-            {
-                Y3(i,j,k) = - I * c2 * dt2 / (3._rt * ep0);
-            }
-
-            // Y4 (multiplies J in the update equation for <E>)
-            Y4(i,j,k) = (Psi2(i,j,k) + I * ep0 * w_c * Y1(i,j,k)) / ep0;
+            const PsatdAveragingCoefficients coef = ComputeCoefficientsAveraging(knorm_s, w_c, dt);
+
+            Psi1(i,j,k) = coef.Psi1;
+            Psi2(i,j,k) = coef.Psi2;
+            Y1(i,j,k) = coef.Y1;
+            Y2(i,j,k) = coef.Y2;
+            Y3(i,j,k) = coef.Y3;
+            Y4(i,j,k) = coef.Y4;
         });
     }
 }
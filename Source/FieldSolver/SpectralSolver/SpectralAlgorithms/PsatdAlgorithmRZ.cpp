@@ -13,6 +13,48 @@
 
 using amrex::operator""_rt;
 
+namespace
+{
+    /** Coefficients of the PSATD update equations at one point of the spectral grid */
+    struct PsatdCoefficientsRZ
+    {
+        amrex::Real C, S_ck, X1, X2, X3;
+    };
+
+    /**
+     * \brief Coefficients of the update equations for E and B at one point
+     * (radial wavenumber kr of one mode, modified kz) of the spectral grid,
+     * with time step dt
+     */
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    PsatdCoefficientsRZ
+    ComputeCoefficients (amrex::Real const kr, amrex::Real const kz,
+                         amrex::Real const dt) noexcept
+    {
+        PsatdCoefficientsRZ coef;
+
+        amrex::Real const k_norm = std::sqrt(kr*kr + kz*kz);
+
+        // Calculate coefficients
+        constexpr amrex::Real c = PhysConst::c;
+        constexpr amrex::Real ep0 = PhysConst::ep0;
+        if (k_norm != 0){
+            coef.C = std::cos(c*k_norm*dt);
+            coef.S_ck = std::sin(c*k_norm*dt)/(c*k_norm);
+            coef.X1 = (1._rt - coef.C)/(ep0 * c*c * k_norm*k_norm);
+            coef.X2 = (1._rt - coef.S_ck/dt)/(ep0 * k_norm*k_norm);
+            coef.X3 = (coef.C - coef.S_ck/dt)/(ep0 * k_norm*k_norm);
+        } else { // Handle k_norm = 0, by using the analytical limit
+            coef.C = 1._rt;
+            coef.S_ck = dt;
+            coef.X1 = 0.5_rt * dt*dt / ep0;
+            coef.X2 = c*c * dt*dt / (6._rt*ep0);
+            coef.X3 = - c*c * dt*dt / (3._rt*ep0);
+        }
+
+        return coef;
+    }
+}
 
 /* \brief Initialize coefficients for the update equation */
 PsatdAlgorithmRZ::PsatdAlgorithmRZ (SpectralKSpaceRZ const & spectral_kspace,
@@ -24,9 +66,16 @@ PsatdAlgorithmRZ::PsatdAlgorithmRZ (SpectralKSpaceRZ const & spectral_kspace,
      : SpectralBaseAlgorithmRZ(spectral_kspace, dm,
                                norder_z, nodal),
        m_dt(dt),
-       m_update_with_rho(update_with_rho)
+       m_update_with_rho(update_with_rho),
+       m_on_the_fly_coefficients(WarpX::fft_on_the_fly_coefficients)
 {
 
+    coefficients_initialized = false;
+
+    // With on-the-fly coefficients, only the k vectors are stored
+    // and the coefficients are computed in pushSpectralFields
+    if (m_on_the_fly_coefficients) return;
+
     // Allocate the arrays of coefficients
     amrex::BoxArray const & ba = spectral_kspace.spectralspace_ba;
     C_coef = SpectralRealCoefficients(ba, dm, n_rz_azimuthal_modes, 0);
@@ -34,8 +83,6 @@ PsatdAlgorithmRZ::PsatdAlgorithmRZ (SpectralKSpaceRZ const & spectral_kspace,
     X1_coef = SpectralRealCoefficients(ba, dm, n_rz_azimuthal_modes, 0);
     X2_coef = SpectralRealCoefficients(ba, dm, n_rz_azimuthal_modes, 0);
     X3_coef = SpectralRealCoefficients(ba, dm, n_rz_azimuthal_modes, 0);
-
-    coefficients_initialized = false;
 }
 
 /* Advance the E and B field in spectral space (stored in `f`)
@@ -45,8 +92,9 @@ PsatdAlgorithmRZ::pushSpectralFields(SpectralFieldDataRZ & f)
 {
 
     bool const update_with_rho = m_update_with_rho;
+    bool const on_the_fly = m_on_the_fly_coefficients;
 
-    if (not coefficients_initialized) {
+    if (not coefficients_initialized && not on_the_fly) {
         // This is called from here since it needs the kr values
         // which can be obtained from the SpectralFieldDataRZ
         InitializeSpectralCoefficients(f);
@@ -60,12 +108,19 @@ PsatdAlgorithmRZ::pushSpectralFields(SpectralFieldDataRZ & f)
 
         // Extract arrays for the fields to be updated
         amrex::Array4<Complex> const& fields = f.fields[mfi].array();
-        // Extract arrays for the coefficients
-        amrex::Array4<const amrex::Real> const& C_arr = C_coef[mfi].array();
-        amrex::Array4<const amrex::Real> const& S_ck_arr = S_ck_coef[mfi].array();
-        amrex::Array4<const amrex::Real> const& X1_arr = X1_coef[mfi].array();
-        amrex::Array4<const amrex::Real> const& X2_arr = X2_coef[mfi].array();
-        amrex::Array4<const amrex::Real> const& X3_arr = X3_coef[mfi].array();
+        // Extract arrays for the coefficients, unless they are computed on the fly
+        amrex::Array4<const amrex::Real> C_arr;
+        amrex::Array4<const amrex::Real> S_ck_arr;
+        amrex::Array4<const amrex::Real> X1_arr;
+        amrex::Array4<const amrex::Real> X2_arr;
+        amrex::Array4<const amrex::Real> X3_arr;
+        if (not on_the_fly) {
+            C_arr = C_coef[mfi].array();
+            S_ck_arr = S_ck_coef[mfi].array();
+            X1_arr = X1_coef[mfi].array();
+            X2_arr = X2_coef[mfi].array();
+            X3_arr = X3_coef[mfi].array();
+        }
 
         // Extract pointers for the k vectors
         auto const & kr_modes = f.getKrArray(mfi);
@@ -118,11 +173,21 @@ PsatdAlgorithmRZ::pushSpectralFields(SpectralFieldDataRZ & f)
             constexpr amrex::Real c2 = PhysConst::c*PhysConst::c;
             constexpr amrex::Real inv_ep0 = 1._rt/PhysConst::ep0;
             Complex const I = Complex{0._rt,1._rt};
-            amrex::Real const C = C_arr(i,j,k,mode);
-            amrex::Real const S_ck = S_ck_arr(i,j,k,mode);
-            amrex::Real const X1 = X1_arr(i,j,k,mode);
-            amrex::Real const X2 = X2_arr(i,j,k,mode);
-            amrex::Real const X3 = X3_arr(i,j,k,mode);
+            PsatdCoefficientsRZ coef;
+            if (on_the_fly) {
+                coef = ComputeCoefficients(kr, kz, dt);
+            } else {
+                coef.C = C_arr(i,j,k,mode);
+                coef.S_ck = S_ck_arr(i,j,k,mode);
+                coef.X1 = X1_arr(i,j,k,mode);
+                coef.X2 = X2_arr(i,j,k,mode);
+                coef.X3 = X3_arr(i,j,k,mode);
+            }
+            amrex::Real const C = coef.C;
+            amrex::Real const S_ck = coef.S_ck;
+            amrex::Real const X1 = coef.X1;
+            amrex::Real const X2 = coef.X2;
+            amrex::Real const X3 = coef.X3;
 
             Complex rho_diff;
             if (update_with_rho) {
@@ -188,28 +253,18 @@ void PsatdAlgorithmRZ::InitializeSpectralCoefficients (SpectralFieldDataRZ const
         amrex::ParallelFor(bx, modes,
         [=] AMREX_GPU_DEVICE(int i, int j, int k, int mode) noexcept
         {
-            // Calculate norm of vector
+            // Radial and longitudinal k values
             int const ir = i + nr*mode;
             amrex::Real const kr = kr_arr[ir];
             amrex::Real const kz = modified_kz[j];
-            amrex::Real const k_norm = std::sqrt(kr*kr + kz*kz);
-
-            // Calculate coefficients
-            constexpr amrex::Real c = PhysConst::c;
-            constexpr amrex::Real ep0 = PhysConst::ep0;
-            if (k_norm != 0){
-                C(i,j,k,mode) = std::cos(c*k_norm*dt);
-                S_ck(i,j,k,mode) = std::sin(c*k_norm*dt)/(c*k_norm);
-                X1(i,j,k,mode) = (1._rt - C(i,j,k,mode))/(ep0 * c*c * k_norm*k_norm);
-                X2(i,j,k,mode) = (1._rt - S_ck(i,j,k,mode)/dt)/(ep0 * k_norm*k_norm);
-                X3(i,j,k,mode) = (C(i,j,k,mode) - S_ck(i,j,k,mode)/dt)/(ep0 * k_norm*k_norm);
-            } else { // Handle k_norm = 0, by using the analytical limit
-                C(i,j,k,mode) = 1._rt;
-                S_ck(i,j,k,mode) = dt;
-                X1(i,j,k,mode) = 0.5_rt * dt*dt / ep0;
-                X2(i,j,k,mode) = c*c * dt*dt / (6._rt*ep0);
-                X3(i,j,k,mode) = - c*c * dt*dt / (3._rt*ep0);
-            }
+
+            PsatdCoefficientsRZ const coef = ComputeCoefficients(kr, kz, dt);
+
+            C(i,j,k,mode) = coef.C;
+            S_ck(i,j,k,mode) = coef.S_ck;
+            X1(i,j,k,mode) = coef.X1;
+            X2(i,j,k,mode) = coef.X2;
+            X3(i,j,k,mode) = coef.X3;
         });
      }
 }
@@ -226,12 +281,10 @@ PsatdAlgorithmRZ::CurrentCorrection (const int lev,
     using Idx = SpectralFieldIndex;
 
     // Forward Fourier transform of J and rho
-    field_data.ForwardTransform( lev,
-                                 *current[0], Idx::Jx,
-                                 *current[1], Idx::Jy);
-    field_data.ForwardTransform( lev, *current[2], Idx::Jz, 0);
-    field_data.ForwardTransform( lev, *rho, Idx::rho_old, 0 );
-    field_data.ForwardTransform( lev, *rho, Idx::rho_new, 1 );
+    using Input = SpectralFieldDataRZ::ForwardTransformInput;
+    field_data.ForwardTransform( lev, {
+        Input(*current[0], Idx::Jx, *current[1], Idx::Jy), Input(*current[2], Idx::Jz, 0),
+        Input(*rho, Idx::rho_old, 0), Input(*rho, Idx::rho_new, 1)});
 
     // Loop over boxes
     for (amrex::MFIter mfi(field_data.fields); mfi.isValid(); ++mfi){
@@ -291,11 +344,9 @@ PsatdAlgorithmRZ::CurrentCorrection (const int lev,
     }
 
     // Backward Fourier transform of J
-    field_data.BackwardTransform( lev,
-                                  *current[0], Idx::Jx,
-                                  *current[1], Idx::Jy);
-    field_data.BackwardTransform( lev,
-                                  *current[2], Idx::Jz, 0 );
+    using Output = SpectralFieldDataRZ::BackwardTransformOutput;
+    field_data.BackwardTransform( lev, {
+        Output(*current[0], Idx::Jx, *current[1], Idx::Jy), Output(*current[2], Idx::Jz, 0)});
 }
 
 void
@@ -24,11 +24,9 @@ SpectralBaseAlgorithmRZ::ComputeSpectralDivE (
     using Idx = SpectralFieldIndex;
 
     // Forward Fourier transform of E
-    field_data.ForwardTransform( lev,
-                                 *Efield[0], Idx::Ex,
-                                 *Efield[1], Idx::Ey );
-    field_data.ForwardTransform( lev,
-                                 *Efield[2], Idx::Ez, 0 );
+    using Input = SpectralFieldDataRZ::ForwardTransformInput;
+    field_data.ForwardTransform( lev, {
+        Input(*Efield[0], Idx::Ex, *Efield[1], Idx::Ey), Input(*Efield[2], Idx::Ez, 0)});
 
     // Loop over boxes
     for (MFIter mfi(field_data.fields); mfi.isValid(); ++mfi){
@@ -8,6 +8,7 @@
 #include "SpectralFieldData.H"
 #include "WarpX.H"
 
+#include <algorithm>
 #include <map>
 
 #if WARPX_USE_PSATD
@@ -32,10 +33,16 @@ SpectralFieldData::SpectralFieldData( const int lev,
     // (one component per field)
     fields = SpectralField(spectralspace_ba, dm, n_field_required, 0);
 
+    // Number of fields transformed by one batched FFT call
+    m_batch_size = std::min(WarpX::fft_batch_size, n_field_required);
+    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(m_batch_size >= 1 && m_batch_size <= max_batch_size,
+        "psatd.fft_batch_size must be between 1 and 16");
+
     // Allocate temporary arrays - in real space and spectral space
     // These arrays will store the data just before/after the FFT
-    tmpRealField = MultiFab(realspace_ba, dm, 1, 0);
-    tmpSpectralField = SpectralField(spectralspace_ba, dm, 1, 0);
+    // (one component per field of a batch)
+    tmpRealField = MultiFab(realspace_ba, dm, m_batch_size, 0);
+    tmpSpectralField = SpectralField(spectralspace_ba, dm, m_batch_size, 0);
 
     // By default, we assume the FFT is done from/to a nodal grid in real space
     // It the FFT is performed from/to a cell-centered grid in real space,
@@ -63,6 +70,10 @@ SpectralFieldData::SpectralFieldData( const int lev,
     // Allocate and initialize the FFT plans
     forward_plan = AnyFFT::FFTplans(spectralspace_ba, dm);
     backward_plan = AnyFFT::FFTplans(spectralspace_ba, dm);
+    if (m_batch_size > 1) {
+        forward_plan_batch = AnyFFT::FFTplans(spectralspace_ba, dm);
+        backward_plan_batch = AnyFFT::FFTplans(spectralspace_ba, dm);
+    }
     // Loop over boxes and allocate the corresponding plan
     // for each box owned by the local MPI proc
     for ( MFIter mfi(spectralspace_ba, dm); mfi.isValid(); ++mfi ){
@@ -87,6 +98,18 @@ SpectralFieldData::SpectralFieldData( const int lev,
             reinterpret_cast<AnyFFT::Complex*>( tmpSpectralField[mfi].dataPtr()),
             AnyFFT::direction::C2R, AMREX_SPACEDIM);
 
+        if (m_batch_size > 1) {
+            forward_plan_batch[mfi] = AnyFFT::CreatePlan(
+                fft_size, tmpRealField[mfi].dataPtr(),
+                reinterpret_cast<AnyFFT::Complex*>( tmpSpectralField[mfi].dataPtr()),
+                AnyFFT::direction::R2C, AMREX_SPACEDIM, m_batch_size);
+
+            backward_plan_batch[mfi] = AnyFFT::CreatePlan(
+                fft_size, tmpRealField[mfi].dataPtr(),
+                reinterpret_cast<AnyFFT::Complex*>( tmpSpectralField[mfi].dataPtr()),
+                AnyFFT::direction::C2R, AMREX_SPACEDIM, m_batch_size);
+        }
+
         if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
             amrex::Gpu::synchronize();
@@ -103,6 +126,10 @@ SpectralFieldData::~SpectralFieldData()
         for ( MFIter mfi(tmpRealField); mfi.isValid(); ++mfi ){
             AnyFFT::DestroyPlan(forward_plan[mfi]);
             AnyFFT::DestroyPlan(backward_plan[mfi]);
+            if (m_batch_size > 1) {
+                AnyFFT::DestroyPlan(forward_plan_batch[mfi]);
+                AnyFFT::DestroyPlan(backward_plan_batch[mfi]);
+            }
         }
     }
 }
@@ -114,88 +141,144 @@ void
 SpectralFieldData::ForwardTransform (const int lev,
                      const MultiFab& mf, const int field_index,
                                      const int i_comp, const IntVect& stag)
+{
+    ForwardTransform(lev, {ForwardTransformInput(mf, field_index, i_comp, stag)});
+}
+
+/* \brief Transform several real-space fields to spectral space,
+ *  by groups of `m_batch_size` fields */
+void
+SpectralFieldData::ForwardTransform (const int lev,
+                                     const std::vector<ForwardTransformInput>& inputs)
 {
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+    // the PML fields may be distributed differently: they are not counted
+    amrex::LayoutData<KernelCounterArray>* counters = WarpX::getKernelCounters(lev);
+    if (counters && counters->DistributionMap() != tmpRealField.DistributionMap()) counters = nullptr;
 
-    // Check field index type, in order to apply proper shift in spectral space
-    const bool is_nodal_x = (stag[0] == amrex::IndexType::NODE) ? true : false;
-#if (AMREX_SPACEDIM == 3)
-    const bool is_nodal_y = (stag[1] == amrex::IndexType::NODE) ? true : false;
-    const bool is_nodal_z = (stag[2] == amrex::IndexType::NODE) ? true : false;
-#else
-    const bool is_nodal_z = (stag[1] == amrex::IndexType::NODE) ? true : false;
-#endif
+    const int n_inputs = static_cast<int>(inputs.size());
 
     // Loop over boxes
-    for ( MFIter mfi(mf); mfi.isValid(); ++mfi ){
+    for ( MFIter mfi(tmpRealField); mfi.isValid(); ++mfi ){
         if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
             amrex::Gpu::synchronize();
         }
         Real wt = amrex::second();
+        const KernelTimer t_kernel = StartKernelTimer(counters);
 
-        // Copy the real-space field `mf` to the temporary field `tmpRealField`
-        // This ensures that all fields have the same number of points
-        // before the Fourier transform.
-        // As a consequence, the copy discards the *last* point of `mf`
-        // in any direction that has *nodal* index type.
-        {
-            Box realspace_bx;
-            if (m_periodic_single_box) {
-                realspace_bx = mfi.validbox(); // Discard guard cells
-            } else {
-                realspace_bx = mf[mfi].box(); // Keep guard cells
+        // Full batches of fields, then the remaining fields one by one
+        int n = 0;
+        if (m_batch_size > 1) {
+            for (; n + m_batch_size <= n_inputs; n += m_batch_size) {
+                ForwardTransformBatch(mfi, inputs.data() + n, m_batch_size, forward_plan_batch[mfi]);
             }
-            realspace_bx.enclosedCells(); // Discard last point in nodal direction
-            AMREX_ALWAYS_ASSERT( realspace_bx.contains(tmpRealField[mfi].box()) );
-            Array4<const Real> mf_arr = mf[mfi].array();
-            Array4<Real> tmp_arr = tmpRealField[mfi].array();
-            ParallelFor( tmpRealField[mfi].box(),
-            [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                tmp_arr(i,j,k) = mf_arr(i,j,k,i_comp);
-            });
+        }
+        for (; n < n_inputs; ++n) {
+            ForwardTransformBatch(mfi, inputs.data() + n, 1, forward_plan[mfi]);
         }
 
-        // Perform Fourier transform from `tmpRealField` to `tmpSpectralField`
-        AnyFFT::Execute(forward_plan[mfi]);
+        RecordKernelCounter(counters, mfi.index(), KernelCounter::FieldSolve, t_kernel,
+                            0, n_inputs*static_cast<amrex::Long>(tmpRealField[mfi].nBytes()));
 
-        // Copy the spectral-space field `tmpSpectralField` to the appropriate
-        // index of the FabArray `fields` (specified by `field_index`)
-        // and apply correcting shift factor if the real space data comes
-        // from a cell-centered grid in real space instead of a nodal grid.
+        if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
-            Array4<Complex> fields_arr = SpectralFieldData::fields[mfi].array();
-            Array4<const Complex> tmp_arr = tmpSpectralField[mfi].array();
-            const Complex* xshift_arr = xshift_FFTfromCell[mfi].dataPtr();
+            amrex::Gpu::synchronize();
+            wt = amrex::second() - wt;
+            amrex::HostDevice::Atomic::Add( &(*cost)[mfi.index()], wt);
+        }
+    }
+}
+
+/* \brief Transform `n_batch` real-space fields of the box `mfi` with the plan `plan`,
+ *  which transforms the first `n_batch` components of the temporary arrays */
+void
+SpectralFieldData::ForwardTransformBatch (const MFIter& mfi,
+                                          const ForwardTransformInput* inputs, const int n_batch,
+                                          AnyFFT::FFTplan& plan)
+{
+    AMREX_ASSERT(n_batch <= m_batch_size);
+
+    GpuArray<Array4<const Real>, max_batch_size> mf_arr;
+    GpuArray<int, max_batch_size> i_comp;
+    GpuArray<int, max_batch_size> field_index;
+    // Check field index type, in order to apply proper shift in spectral space
+    GpuArray<int, max_batch_size> is_nodal_x;
 #if (AMREX_SPACEDIM == 3)
-            const Complex* yshift_arr = yshift_FFTfromCell[mfi].dataPtr();
+    GpuArray<int, max_batch_size> is_nodal_y;
 #endif
-            const Complex* zshift_arr = zshift_FFTfromCell[mfi].dataPtr();
-            // Loop over indices within one box
-            const Box spectralspace_bx = tmpSpectralField[mfi].box();
-
-            ParallelFor( spectralspace_bx,
-            [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                Complex spectral_field_value = tmp_arr(i,j,k);
-                // Apply proper shift in each dimension
-                if (is_nodal_x==false) spectral_field_value *= xshift_arr[i];
+    GpuArray<int, max_batch_size> is_nodal_z;
+
+    for (int n = 0; n < n_batch; ++n) {
+        const MultiFab& mf = *inputs[n].mf;
+        const IntVect& stag = inputs[n].stag;
+        mf_arr[n] = mf[mfi].array();
+        i_comp[n] = inputs[n].i_comp;
+        field_index[n] = inputs[n].field_index;
+        is_nodal_x[n] = (stag[0] == amrex::IndexType::NODE);
 #if (AMREX_SPACEDIM == 3)
-                if (is_nodal_y==false) spectral_field_value *= yshift_arr[j];
-                if (is_nodal_z==false) spectral_field_value *= zshift_arr[k];
-#elif (AMREX_SPACEDIM == 2)
-                if (is_nodal_z==false) spectral_field_value *= zshift_arr[j];
+        is_nodal_y[n] = (stag[1] == amrex::IndexType::NODE);
+        is_nodal_z[n] = (stag[2] == amrex::IndexType::NODE);
+#else
+        is_nodal_z[n] = (stag[1] == amrex::IndexType::NODE);
 #endif
-                // Copy field into the right index
-                fields_arr(i,j,k,field_index) = spectral_field_value;
-            });
-        }
 
-        if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
-        {
-            amrex::Gpu::synchronize();
-            wt = amrex::second() - wt;
-            amrex::HostDevice::Atomic::Add( &(*cost)[mfi.index()], wt);
+        // The copy below discards the *last* point of `mf`
+        // in any direction that has *nodal* index type.
+        Box realspace_bx;
+        if (m_periodic_single_box) {
+            realspace_bx = mf.box(mfi.index()); // Discard guard cells
+        } else {
+            realspace_bx = mf[mfi].box(); // Keep guard cells
         }
+        realspace_bx.enclosedCells(); // Discard last point in nodal direction
+        AMREX_ALWAYS_ASSERT( realspace_bx.contains(tmpRealField[mfi].box()) );
+    }
+
+    // Copy the real-space fields to the temporary field `tmpRealField`
+    // (one component per field).
+    // This ensures that all fields have the same number of points
+    // before the Fourier transform.
+    {
+        Array4<Real> tmp_arr = tmpRealField[mfi].array();
+        ParallelFor( tmpRealField[mfi].box(), n_batch,
+        [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+            tmp_arr(i,j,k,n) = mf_arr[n](i,j,k,i_comp[n]);
+        });
+    }
+
+    // Perform Fourier transform from `tmpRealField` to `tmpSpectralField`
+    AnyFFT::Execute(plan);
+
+    // Copy the spectral-space fields `tmpSpectralField` to the appropriate
+    // index of the FabArray `fields` (specified by `field_index`)
+    // and apply correcting shift factor if the real space data comes
+    // from a cell-centered grid in real space instead of a nodal grid.
+    {
+        Array4<Complex> fields_arr = SpectralFieldData::fields[mfi].array();
+        Array4<const Complex> tmp_arr = tmpSpectralField[mfi].array();
+        const Complex* xshift_arr = xshift_FFTfromCell[mfi].dataPtr();
+#if (AMREX_SPACEDIM == 3)
+        const Complex* yshift_arr = yshift_FFTfromCell[mfi].dataPtr();
+#endif
+        const Complex* zshift_arr = zshift_FFTfromCell[mfi].dataPtr();
+        // Loop over indices within one box
+        const Box spectralspace_bx = tmpSpectralField[mfi].box();
+
+        ParallelFor( spectralspace_bx, n_batch,
+        [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+            Complex spectral_field_value = tmp_arr(i,j,k,n);
+            // Apply proper shift in each dimension
+            if (is_nodal_x[n]==false) spectral_field_value *= xshift_arr[i];
+#if (AMREX_SPACEDIM == 3)
+            if (is_nodal_y[n]==false) spectral_field_value *= yshift_arr[j];
+            if (is_nodal_z[n]==false) spectral_field_value *= zshift_arr[k];
+#elif (AMREX_SPACEDIM == 2)
+            if (is_nodal_z[n]==false) spectral_field_value *= zshift_arr[j];
+#endif
+            // Copy field into the right index
+            fields_arr(i,j,k,field_index[n]) = spectral_field_value;
+        });
     }
 }
 
@@ -207,107 +290,160 @@ SpectralFieldData::BackwardTransform( const int lev,
                                       MultiFab& mf,
                                       const int field_index,
                                       const int i_comp )
+{
+    BackwardTransform(lev, {BackwardTransformOutput(mf, field_index, i_comp)});
+}
+
+/* \brief Transform several spectral fields back to real space,
+ *  by groups of `m_batch_size` fields */
+void
+SpectralFieldData::BackwardTransform (const int lev,
+                                      const std::vector<BackwardTransformOutput>& outputs)
 {
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+    // the PML fields may be distributed differently: they are not counted
+    amrex::LayoutData<KernelCounterArray>* counters = WarpX::getKernelCounters(lev);
+    if (counters && counters->DistributionMap() != tmpRealField.DistributionMap()) counters = nullptr;
 
-    // Check field index type, in order to apply proper shift in spectral space
-    const bool is_nodal_x = mf.is_nodal(0);
-#if (AMREX_SPACEDIM == 3)
-    const bool is_nodal_y = mf.is_nodal(1);
-    const bool is_nodal_z = mf.is_nodal(2);
-#else
-    const bool is_nodal_z = mf.is_nodal(1);
-#endif
+    const int n_outputs = static_cast<int>(outputs.size());
 
     // Loop over boxes
-    for ( MFIter mfi(mf); mfi.isValid(); ++mfi ){
+    for ( MFIter mfi(tmpRealField); mfi.isValid(); ++mfi ){
         if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
             amrex::Gpu::synchronize();
         }
         Real wt = amrex::second();
+        const KernelTimer t_kernel = StartKernelTimer(counters);
+
+        // Full batches of fields, then the remaining fields one by one
+        int n = 0;
+        if (m_batch_size > 1) {
+            for (; n + m_batch_size <= n_outputs; n += m_batch_size) {
+                BackwardTransformBatch(mfi, outputs.data() + n, m_batch_size, backward_plan_batch[mfi]);
+            }
+        }
+        for (; n < n_outputs; ++n) {
+            BackwardTransformBatch(mfi, outputs.data() + n, 1, backward_plan[mfi]);
+        }
 
-        // Copy the spectral-space field `tmpSpectralField` to the appropriate
-        // field (specified by the input argument field_index)
-        // and apply correcting shift factor if the field is to be transformed
-        // to a cell-centered grid in real space instead of a nodal grid.
+        RecordKernelCounter(counters, mfi.index(), KernelCounter::FieldSolve, t_kernel,
+                            0, n_outputs*static_cast<amrex::Long>(tmpRealField[mfi].nBytes()));
+
+        if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
         {
-            Array4<const Complex> field_arr = SpectralFieldData::fields[mfi].array();
-            Array4<Complex> tmp_arr = tmpSpectralField[mfi].array();
-            const Complex* xshift_arr = xshift_FFTtoCell[mfi].dataPtr();
+            amrex::Gpu::synchronize();
+            wt = amrex::second() - wt;
+            amrex::HostDevice::Atomic::Add( &(*cost)[mfi.index()], wt);
+        }
+    }
+}
+
+/* \brief Transform `n_batch` spectral fields of the box `mfi` back to real space
+ *  with the plan `plan`, which transforms the first `n_batch` components
+ *  of the temporary arrays */
+void
+SpectralFieldData::BackwardTransformBatch (const MFIter& mfi,
+                                           const BackwardTransformOutput* outputs, const int n_batch,
+                                           AnyFFT::FFTplan& plan)
+{
+    AMREX_ASSERT(n_batch <= m_batch_size);
+
+    GpuArray<int, max_batch_size> field_index;
+    // Check field index type, in order to apply proper shift in spectral space
+    GpuArray<int, max_batch_size> is_nodal_x;
 #if (AMREX_SPACEDIM == 3)
-            const Complex* yshift_arr = yshift_FFTtoCell[mfi].dataPtr();
+    GpuArray<int, max_batch_size> is_nodal_y;
 #endif
-            const Complex* zshift_arr = zshift_FFTtoCell[mfi].dataPtr();
-            // Loop over indices within one box
-            const Box spectralspace_bx = tmpSpectralField[mfi].box();
+    GpuArray<int, max_batch_size> is_nodal_z;
 
-            ParallelFor( spectralspace_bx,
-            [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                Complex spectral_field_value = field_arr(i,j,k,field_index);
-                // Apply proper shift in each dimension
-                if (is_nodal_x==false) spectral_field_value *= xshift_arr[i];
+    for (int n = 0; n < n_batch; ++n) {
+        const MultiFab& mf = *outputs[n].mf;
+        field_index[n] = outputs[n].field_index;
+        is_nodal_x[n] = mf.is_nodal(0);
 #if (AMREX_SPACEDIM == 3)
-                if (is_nodal_y==false) spectral_field_value *= yshift_arr[j];
-                if (is_nodal_z==false) spectral_field_value *= zshift_arr[k];
-#elif (AMREX_SPACEDIM == 2)
-                if (is_nodal_z==false) spectral_field_value *= zshift_arr[j];
+        is_nodal_y[n] = mf.is_nodal(1);
+        is_nodal_z[n] = mf.is_nodal(2);
+#else
+        is_nodal_z[n] = mf.is_nodal(1);
 #endif
-                // Copy field into temporary array
-                tmp_arr(i,j,k) = spectral_field_value;
-            });
-
-        }
+    }
 
-        // Perform Fourier transform from `tmpSpectralField` to `tmpRealField`
-        AnyFFT::Execute(backward_plan[mfi]);
+    // Copy the spectral-space fields (specified by `field_index`)
+    // to `tmpSpectralField` (one component per field)
+    // and apply correcting shift factor if the field is to be transformed
+    // to a cell-centered grid in real space instead of a nodal grid.
+    {
+        Array4<const Complex> field_arr = SpectralFieldData::fields[mfi].array();
+        Array4<Complex> tmp_arr = tmpSpectralField[mfi].array();
+        const Complex* xshift_arr = xshift_FFTtoCell[mfi].dataPtr();
+#if (AMREX_SPACEDIM == 3)
+        const Complex* yshift_arr = yshift_FFTtoCell[mfi].dataPtr();
+#endif
+        const Complex* zshift_arr = zshift_FFTtoCell[mfi].dataPtr();
+        // Loop over indices within one box
+        const Box spectralspace_bx = tmpSpectralField[mfi].box();
+
+        ParallelFor( spectralspace_bx, n_batch,
+        [=] AMREX_GPU_DEVICE(int i, int j, int k, int n) noexcept {
+            Complex spectral_field_value = field_arr(i,j,k,field_index[n]);
+            // Apply proper shift in each dimension
+            if (is_nodal_x[n]==false) spectral_field_value *= xshift_arr[i];
+#if (AMREX_SPACEDIM == 3)
+            if (is_nodal_y[n]==false) spectral_field_value *= yshift_arr[j];
+            if (is_nodal_z[n]==false) spectral_field_value *= zshift_arr[k];
+#elif (AMREX_SPACEDIM == 2)
+            if (is_nodal_z[n]==false) spectral_field_value *= zshift_arr[j];
+#endif
+            // Copy field into temporary array
+            tmp_arr(i,j,k,n) = spectral_field_value;
+        });
+    }
 
-        // Copy the temporary field `tmpRealField` to the real-space field `mf`
-        // (only in the valid cells ; not in the guard cells)
-        // Normalize (divide by 1/N) since the FFT+IFFT results in a factor N
-        {
-            Array4<Real> mf_arr = mf[mfi].array();
-            Array4<const Real> tmp_arr = tmpRealField[mfi].array();
-            // Normalization: divide by the number of points in realspace
-            // (includes the guard cells)
-            const Box realspace_bx = tmpRealField[mfi].box();
-            const Real inv_N = 1./realspace_bx.numPts();
-
-            if (m_periodic_single_box) {
-                // Enforce periodicity on the nodes, by using modulo in indices
-                // This is because `tmp_arr` is cell-centered while `mf_arr` can be nodal
-                int const nx = realspace_bx.length(0);
-                int const ny = realspace_bx.length(1);
+    // Perform Fourier transform from `tmpSpectralField` to `tmpRealField`
+    AnyFFT::Execute(plan);
+
+    // Copy the temporary field `tmpRealField` to the real-space fields
+    // (only in the valid cells ; not in the guard cells)
+    // Normalize (divide by 1/N) since the FFT+IFFT results in a factor N
+    Array4<const Real> tmp_arr = tmpRealField[mfi].array();
+    // Normalization: divide by the number of points in realspace
+    // (includes the guard cells)
+    const Box realspace_bx = tmpRealField[mfi].box();
+    const Real inv_N = 1./realspace_bx.numPts();
+
+    for (int n = 0; n < n_batch; ++n) {
+        MultiFab& mf = *outputs[n].mf;
+        Array4<Real> mf_arr = mf[mfi].array();
+        const int i_comp = outputs[n].i_comp;
+        const Box valid_bx = mf.box(mfi.index());
+
+        if (m_periodic_single_box) {
+            // Enforce periodicity on the nodes, by using modulo in indices
+            // This is because `tmp_arr` is cell-centered while `mf_arr` can be nodal
+            int const nx = realspace_bx.length(0);
+            int const ny = realspace_bx.length(1);
 #if (AMREX_SPACEDIM == 3)
-                int const nz = realspace_bx.length(2);
+            int const nz = realspace_bx.length(2);
 #else
-                int constexpr nz = 1;
+            int constexpr nz = 1;
 #endif
-                ParallelFor(
-                    mfi.validbox(),
-                    /* GCC 8.1-8.2 work-around (ICE):
-                     *   named capture in nonexcept lambda needed for modulo operands
-                     *   https://godbolt.org/z/ppbAzd
-                     */
-                    [mf_arr, i_comp, inv_N, tmp_arr, nx, ny, nz]
-                    AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
-                        mf_arr(i,j,k,i_comp) = inv_N*tmp_arr(i%nx, j%ny, k%nz);
-                    });
-            } else {
-                ParallelFor( mfi.validbox(),
-                [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-                    // Copy and normalize field
-                    mf_arr(i,j,k,i_comp) = inv_N*tmp_arr(i,j,k);
+            ParallelFor(
+                valid_bx,
+                /* GCC 8.1-8.2 work-around (ICE):
+                 *   named capture in nonexcept lambda needed for modulo operands
+                 *   https://godbolt.org/z/ppbAzd
+                 */
+                [mf_arr, i_comp, inv_N, tmp_arr, nx, ny, nz, n]
+                AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+                    mf_arr(i,j,k,i_comp) = inv_N*tmp_arr(i%nx, j%ny, k%nz, n);
                 });
-            }
-
-        }
-
-        if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
-        {
-            amrex::Gpu::synchronize();
-            wt = amrex::second() - wt;
-            amrex::HostDevice::Atomic::Add( &(*cost)[mfi.index()], wt);
+        } else {
+            ParallelFor( valid_bx,
+            [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+                // Copy and normalize field
+                mf_arr(i,j,k,i_comp) = inv_N*tmp_arr(i,j,k,n);
+            });
         }
     }
 }
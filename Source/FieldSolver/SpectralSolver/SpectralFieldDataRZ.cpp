@@ -8,8 +8,32 @@
 
 #include "WarpX.H"
 
+#include <algorithm>
+#include <vector>
+
 using amrex::operator""_rt;
 
+namespace
+{
+    /** Call f on consecutive sublists of fields, each with at most max_slots
+     *  slots (a vector field takes two slots), in the order of the list */
+    template <typename T, typename F>
+    void ForEachBatch (std::vector<T> const & fields, int const max_slots, F const & f)
+    {
+        auto begin = fields.begin();
+        while (begin != fields.end()) {
+            auto end = begin;
+            int n_slots = 0;
+            while (end != fields.end() && n_slots + (end->isVector() ? 2 : 1) <= max_slots) {
+                n_slots += end->isVector() ? 2 : 1;
+                ++end;
+            }
+            f(std::vector<T>(begin, end));
+            begin = end;
+        }
+    }
+}
+
 /* \brief Initialize fields in spectral space, and FFT plans
  *
  * \param realspace_ba Box array that corresponds to the decomposition
@@ -37,11 +61,22 @@ SpectralFieldDataRZ::SpectralFieldDataRZ (const int lev,
     // field for a specific mode is given by field_index + mode*n_fields.
     fields = SpectralField(spectralspace_ba, dm, n_rz_azimuthal_modes*n_field_required, 0);
 
+    // The fields are transformed by batches of at most m_batch_slots slots
+    // (a vector field takes two slots), so that the size of the temporary arrays
+    // is bounded independently of the number of fields transformed together.
+    m_batch_slots = std::max(2, std::min(WarpX::fft_batch_size,
+                                         static_cast<int>(SpectralFieldIndex::n_fields)));
+
     // Allocate temporary arrays - in real space and spectral space.
-    // These complex arrays will store the data just before/after the z FFT.
+    // They hold all the slots and modes of a batch. The complex arrays contain
+    // the data just before/after the z FFT, and are used to create the FFT plans.
     // Note that the realspace_ba should not include the radial guard cells.
-    tempHTransformed = SpectralField(realspace_ba, dm, n_rz_azimuthal_modes, 0);
-    tmpSpectralField = SpectralField(spectralspace_ba, dm, n_rz_azimuthal_modes, 0);
+    tempHTransformed = SpectralField(realspace_ba, dm, n_rz_azimuthal_modes*m_batch_slots, 0);
+    tmpSpectralField = SpectralField(spectralspace_ba, dm, n_rz_azimuthal_modes*m_batch_slots, 0);
+    // The real and imaginary parts split, before and after the Hankel transform.
+    // They include the imaginary part of mode 0.
+    physicalSplit = amrex::MultiFab(realspace_ba, dm, 2*n_rz_azimuthal_modes*m_batch_slots, 0);
+    hankelSplit = amrex::MultiFab(realspace_ba, dm, 2*n_rz_azimuthal_modes*m_batch_slots, 0);
 
     // By default, we assume the z FFT is done from/to a nodal grid in real space.
     // It the FFT is performed from/to a cell-centered grid in real space,
@@ -67,7 +102,7 @@ SpectralFieldDataRZ::SpectralFieldDataRZ (const int lev,
 #if defined(AMREX_USE_CUDA)
         // Create cuFFT plan.
         // This is alway complex to complex.
-        // This plan is for one azimuthal mode only.
+        // This plan is for one component (field and azimuthal mode) only.
         cufftResult result;
         int fft_length[] = {grid_size[1]};
         int inembed[] = {grid_size[1]};
@@ -137,36 +172,36 @@ SpectralFieldDataRZ::SpectralFieldDataRZ (const int lev,
         }
 #else
         // Create FFTW plans.
+        // The plans are for one component (field and azimuthal mode) and are
+        // executed on each component of the temporary arrays of the transforms,
+        // which may not have the alignment of the arrays used for planning.
         fftw_iodim dims[1];
-        fftw_iodim howmany_dims[2];
+        fftw_iodim howmany_dims[1];
         dims[0].n = grid_size[1];
         dims[0].is = grid_size[0];
         dims[0].os = grid_size[0];
-        howmany_dims[0].n = n_rz_azimuthal_modes;
-        howmany_dims[0].is = grid_size[0]*grid_size[1];
-        howmany_dims[0].os = grid_size[0]*grid_size[1];
-        howmany_dims[1].n = grid_size[0];
-        howmany_dims[1].is = 1;
-        howmany_dims[1].os = 1;
+        howmany_dims[0].n = grid_size[0];
+        howmany_dims[0].is = 1;
+        howmany_dims[0].os = 1;
         forward_plan[mfi] =
             // Note that AMReX FAB are Fortran-order.
             fftw_plan_guru_dft(1, // int rank
                                dims,
-                               2, // int howmany_rank,
+                               1, // int howmany_rank,
                                howmany_dims,
                                reinterpret_cast<fftw_complex*>(tempHTransformed[mfi].dataPtr()), // fftw_complex *in
                                reinterpret_cast<fftw_complex*>(tmpSpectralField[mfi].dataPtr()), // fftw_complex *out
                                FFTW_FORWARD, // int sign
-                               FFTW_ESTIMATE); // unsigned flags
+                               AnyFFT::PlannerFlags() | FFTW_UNALIGNED); // unsigned flags
         backward_plan[mfi] =
             fftw_plan_guru_dft(1, // int rank
                                dims,
-                               2, // int howmany_rank,
+                               1, // int howmany_rank,
                                howmany_dims,
                                reinterpret_cast<fftw_complex*>(tmpSpectralField[mfi].dataPtr()), // fftw_complex *in
                                reinterpret_cast<fftw_complex*>(tempHTransformed[mfi].dataPtr()), // fftw_complex *out
                                FFTW_BACKWARD, // int sign
-                               FFTW_ESTIMATE); // unsigned flags
+                               AnyFFT::PlannerFlags() | FFTW_UNALIGNED); // unsigned flags
 #endif
 
         // Create the Hankel transformer for each box.
@@ -196,67 +231,55 @@ SpectralFieldDataRZ::~SpectralFieldDataRZ()
     }
 }
 
-/* \brief Z Transform the FAB to spectral space,
- *  and store the corresponding result internally
- *  (in the spectral field specified by `field_index`)
- *  The input, tempHTransformedSplit, is the complex, Hankel transformed
- *  data, which is stored wih the real and imaginary parts split.
- *  The input should include the imaginary component of mode 0
- *  (even though it is all zeros). */
+/* \brief Execute the z FFT of `ncomp` contiguous components of the box `mfi`,
+ *  from `in` (real space) to `out` (spectral space) if `forward` is true,
+ *  or from `out` to `in` otherwise. */
 void
-SpectralFieldDataRZ::FABZForwardTransform (amrex::MFIter const & mfi, amrex::Box const & realspace_bx,
-                                           amrex::MultiFab const & tempHTransformedSplit,
-                                           int const field_index, const bool is_nodal_z)
+SpectralFieldDataRZ::ZTransform (amrex::MFIter const & mfi, Complex* in, Complex* out,
+                                 int const ncomp, bool const forward)
 {
-    // Copy the split complex to the interleaved complex.
-
-    amrex::Array4<const amrex::Real> const& split_arr = tempHTransformedSplit[mfi].array();
-    amrex::Array4<Complex> const& complex_arr = tempHTransformed[mfi].array();
+    amrex::Long const npts = tempHTransformed[mfi].box().numPts();
 
-    int const modes = n_rz_azimuthal_modes;
-    ParallelFor(realspace_bx, modes,
-    [=] AMREX_GPU_DEVICE(int i, int j, int k, int mode) noexcept {
-        int const mode_r = 2*mode;
-        int const mode_i = 2*mode + 1;
-        complex_arr(i,j,k,mode) = Complex{split_arr(i,j,k,mode_r), split_arr(i,j,k,mode_i)};
-    });
-
-    // Perform Fourier transform from `tempHTransformed` to `tmpSpectralField`.
 #if defined(AMREX_USE_CUDA)
     // Perform Fast Fourier Transform on GPU using cuFFT.
     // Make sure that this is done on the same
-    // GPU stream as the above copy.
+    // GPU stream as the copies.
     cufftResult result;
     cudaStream_t stream = amrex::Gpu::Device::cudaStream();
     cufftSetStream(forward_plan[mfi], stream);
-    for (int mode=0 ; mode < n_rz_azimuthal_modes ; mode++) {
+    for (int icomp=0 ; icomp < ncomp ; icomp++) {
+        AnyFFT::Complex* in_comp = reinterpret_cast<AnyFFT::Complex*>(in + icomp*npts);
+        AnyFFT::Complex* out_comp = reinterpret_cast<AnyFFT::Complex*>(out + icomp*npts);
 #  ifdef AMREX_USE_FLOAT
         result = cufftExecC2C(forward_plan[mfi],
 #  else
         result = cufftExecZ2Z(forward_plan[mfi],
 #  endif
-                              reinterpret_cast<AnyFFT::Complex*>(tempHTransformed[mfi].dataPtr(mode)), // Complex *in
-                              reinterpret_cast<AnyFFT::Complex*>(tmpSpectralField[mfi].dataPtr(mode)), // Complex *out
-                              CUFFT_FORWARD);
+                              forward ? in_comp : out_comp, // Complex *in
+                              forward ? out_comp : in_comp, // Complex *out
+                              forward ? CUFFT_FORWARD : CUFFT_INVERSE);
         if (result != CUFFT_SUCCESS) {
-            amrex::AllPrint() << " forward transform using cufftExecZ2Z failed ! \n";
+            amrex::AllPrint() << " z transform using cufftExecZ2Z failed ! \n";
         }
     }
 #elif defined(AMREX_USE_HIP)
+    rocfft_plan& plan = forward ? forward_plan[mfi] : backward_plan[mfi];
     rocfft_execution_info execinfo = NULL;
     rocfft_status result = rocfft_execution_info_create(&execinfo);
     std::size_t buffersize = 0;
-    result = rocfft_plan_get_work_buffer_size(forward_plan[mfi], &buffersize);
+    result = rocfft_plan_get_work_buffer_size(plan, &buffersize);
     void* buffer = amrex::The_Arena()->alloc(buffersize);
     result = rocfft_execution_info_set_work_buffer(execinfo, buffer, buffersize);
     result = rocfft_execution_info_set_stream(execinfo, amrex::Gpu::gpuStream());
 
-    for (int mode=0 ; mode < n_rz_azimuthal_modes ; mode++) {
-        void* in_array[] = {(void*)(tempHTransformed[mfi].dataPtr(mode))};
-        void* out_array[] = {(void*)(tmpSpectralField[mfi].dataPtr(mode))};
-        result = rocfft_execute(forward_plan[mfi], in_array, out_array, execinfo);
+    for (int icomp=0 ; icomp < ncomp ; icomp++) {
+        void* in_comp = (void*)(in + icomp*npts);
+        void* out_comp = (void*)(out + icomp*npts);
+        void* in_array[] = {forward ? in_comp : out_comp};
+        void* out_array[] = {forward ? out_comp : in_comp};
+        result = rocfft_execute(plan, in_array, out_array, execinfo);
         if (result != rocfft_status_success) {
-            amrex::AllPrint() << " forward transform using rocfft_execute failed ! \n";
+            amrex::AllPrint() << " z transform using rocfft_execute failed ! \n";
         }
     }
 
@@ -264,130 +287,16 @@ SpectralFieldDataRZ::FABZForwardTransform (amrex::MFIter const & mfi, amrex::Box
     amrex::The_Arena()->free(buffer);
     result = rocfft_execution_info_destroy(execinfo);
 #else
-    fftw_execute(forward_plan[mfi]);
-#endif
-
-    // Copy the spectral-space field `tmpSpectralField` to the appropriate
-    // index of the FabArray `fields` (specified by `field_index`)
-    // and apply correcting shift factor if the real space data comes
-    // from a cell-centered grid in real space instead of a nodal grid.
-    amrex::Array4<const Complex> const& tmp_arr = tmpSpectralField[mfi].array();
-    amrex::Array4<Complex> const& fields_arr = fields[mfi].array();
-    Complex const* zshift_arr = zshift_FFTfromCell[mfi].dataPtr();
-
-    // Loop over indices within one box, all components.
-    // The fields are organized so that the fields for each mode
-    // are grouped together in memory.
-    amrex::Box const& spectralspace_bx = tmpSpectralField[mfi].box();
-    int const nz = spectralspace_bx.length(1);
-    amrex::Real inv_nz = 1._rt/nz;
-    constexpr int n_fields = SpectralFieldIndex::n_fields;
-
-    ParallelFor(spectralspace_bx, modes,
-    [=] AMREX_GPU_DEVICE(int i, int j, int k, int mode) noexcept {
-        Complex spectral_field_value = tmp_arr(i,j,k,mode);
-        // Apply proper shift.
-        if (is_nodal_z==false) spectral_field_value *= zshift_arr[j];
-        // Copy field into the correct index.
-        int const ic = field_index + mode*n_fields;
-        fields_arr(i,j,k,ic) = spectral_field_value*inv_nz;
-    });
-}
-
-/* \brief Backward Z Transform the data from the fields
- * (in the spectral field specified by `field_index`)
- * to physical space, and return the resulting FArrayBox.
- *  The output, tempHTransformedSplit, is the complex, Hankel transformed
- *  data, which is stored wih the real and imaginary parts split.
- *  The output includes the imaginary component of mode 0
- *  (even though it is all zeros). */
-void
-SpectralFieldDataRZ::FABZBackwardTransform (amrex::MFIter const & mfi, amrex::Box const & realspace_bx,
-                                            int const field_index,
-                                            amrex::MultiFab & tempHTransformedSplit,
-                                            const bool is_nodal_z)
-{
-    // Copy the spectral-space field from the appropriate index of the FabArray
-    // `fields` (specified by `field_index`) to field `tmpSpectralField`
-    // and apply correcting shift factor if the real space data is on
-    // a cell-centered grid in real space instead of a nodal grid.
-    amrex::Array4<const Complex> const& fields_arr = fields[mfi].array();
-    amrex::Array4<Complex> const& tmp_arr = tmpSpectralField[mfi].array();
-    Complex const* zshift_arr = zshift_FFTtoCell[mfi].dataPtr();
-
-    // Loop over indices within one box, all components.
-    amrex::Box const& spectralspace_bx = tmpSpectralField[mfi].box();
-
-    int const modes = n_rz_azimuthal_modes;
-    constexpr int n_fields = SpectralFieldIndex::n_fields;
-    ParallelFor(spectralspace_bx, modes,
-    [=] AMREX_GPU_DEVICE(int i, int j, int k, int mode) noexcept {
-        int const ic = field_index + mode*n_fields;
-        Complex spectral_field_value = fields_arr(i,j,k,ic);
-        // Apply proper shift.
-        if (is_nodal_z==false) spectral_field_value *= zshift_arr[j];
-        // Copy field into the right index.
-        tmp_arr(i,j,k,mode) = spectral_field_value;
-    });
-
-    // Perform Fourier transform from `tmpSpectralField` to `tempHTransformed`.
-#if defined(AMREX_USE_CUDA)
-    // Perform Fast Fourier Transform on GPU using cuFFT.
-    // Make sure that this is done on the same
-    // GPU stream as the above copy.
-    cufftResult result;
-    cudaStream_t stream = amrex::Gpu::Device::cudaStream();
-    cufftSetStream(forward_plan[mfi], stream);
-    for (int mode=0 ; mode < n_rz_azimuthal_modes ; mode++) {
-#  ifdef AMREX_USE_FLOAT
-        result = cufftExecC2C(forward_plan[mfi],
-#  else
-        result = cufftExecZ2Z(forward_plan[mfi],
-#  endif
-                              reinterpret_cast<AnyFFT::Complex*>(tmpSpectralField[mfi].dataPtr(mode)), // Complex *in
-                              reinterpret_cast<AnyFFT::Complex*>(tempHTransformed[mfi].dataPtr(mode)), // Complex *out
-                              CUFFT_INVERSE);
-        if (result != CUFFT_SUCCESS) {
-            amrex::AllPrint() << " backwardtransform using cufftExecZ2Z failed ! \n";
-        }
-    }
-#elif defined(AMREX_USE_HIP)
-    rocfft_execution_info execinfo = NULL;
-    rocfft_status result = rocfft_execution_info_create(&execinfo);
-    std::size_t buffersize = 0;
-    result = rocfft_plan_get_work_buffer_size(forward_plan[mfi], &buffersize);
-    void* buffer = amrex::The_Arena()->alloc(buffersize);
-    result = rocfft_execution_info_set_work_buffer(execinfo, buffer, buffersize);
-    result = rocfft_execution_info_set_stream(execinfo, amrex::Gpu::gpuStream());
-
-    for (int mode=0 ; mode < n_rz_azimuthal_modes ; mode++) {
-        void* in_array[] = {(void*)(tmpSpectralField[mfi].dataPtr(mode))};
-        void* out_array[] = {(void*)(tempHTransformed[mfi].dataPtr(mode))};
-        result = rocfft_execute(backward_plan[mfi], in_array, out_array, execinfo);
-        if (result != rocfft_status_success) {
-            amrex::AllPrint() << " forward transform using rocfft_execute failed ! \n";
+    for (int icomp=0 ; icomp < ncomp ; icomp++) {
+        fftw_complex* in_comp = reinterpret_cast<fftw_complex*>(in + icomp*npts);
+        fftw_complex* out_comp = reinterpret_cast<fftw_complex*>(out + icomp*npts);
+        if (forward) {
+            fftw_execute_dft(forward_plan[mfi], in_comp, out_comp);
+        } else {
+            fftw_execute_dft(backward_plan[mfi], out_comp, in_comp);
         }
     }
-
-    amrex::Gpu::streamSynchronize();
-    amrex::The_Arena()->free(buffer);
-    result = rocfft_execution_info_destroy(execinfo);
-#else
-    fftw_execute(backward_plan[mfi]);
 #endif
-
-    // Copy the interleaved complex to the split complex.
-    amrex::Array4<amrex::Real> const& split_arr = tempHTransformedSplit[mfi].array();
-    amrex::Array4<const Complex> const& complex_arr = tempHTransformed[mfi].array();
-
-    ParallelFor(realspace_bx, modes,
-    [=] AMREX_GPU_DEVICE(int i, int j, int k, int mode) noexcept {
-        int const mode_r = 2*mode;
-        int const mode_i = 2*mode + 1;
-        split_arr(i,j,k,mode_r) = complex_arr(i,j,k,mode).real();
-        split_arr(i,j,k,mode_i) = complex_arr(i,j,k,mode).imag();
-    });
-
 }
 
 /* \brief Transform the component `i_comp` of MultiFab `field_mf`
@@ -398,43 +307,7 @@ SpectralFieldDataRZ::ForwardTransform (const int lev,
                                        amrex::MultiFab const & field_mf, int const field_index,
                                        int const i_comp)
 {
-    // Check field index type, in order to apply proper shift in spectral space.
-    // Only cell centered in r is supported.
-    bool const is_nodal_z = field_mf.is_nodal(1);
-
-    int const ncomp = 2*n_rz_azimuthal_modes - 1;
-
-    // Create a copy of the input multifab since the shape of field_mf
-    // might not be what is needed in transform.
-    // For example, with periodic_single_box_fft, field_mf will have guard cells but
-    // the transformed array does not.
-    // Note that the copy will not include the imaginary part of mode 0 as
-    // PhysicalToSpectral_Scalar expects.
-    amrex::MultiFab field_mf_copy(tempHTransformed.boxArray(), field_mf.DistributionMap(), ncomp, 0);
-
-    // This will hold the Hankel transformed data, with the real and imaginary parts split.
-    // A full multifab is created so that each GPU stream has its own temp space.
-    amrex::MultiFab tempHTransformedSplit(tempHTransformed.boxArray(), tempHTransformed.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
-
-    // Loop over boxes.
-    for (amrex::MFIter mfi(field_mf); mfi.isValid(); ++mfi){
-
-        // Perform the Hankel transform first.
-        // tempHTransformedSplit includes the imaginary component of mode 0.
-        // field_mf does not.
-        amrex::Box const& realspace_bx = tempHTransformed[mfi].box();
-
-        if ( !(field_mf[mfi].box().contains(field_mf_copy[mfi].box())) ) {
-            // If field_mf[mfi] is smaller than field_mf_copy[mfi], then fill field_mf_copy[mfi] with
-            // zeros so that all of it is initialized.
-            field_mf_copy[mfi].setVal<amrex::RunOn::Device>(0._rt, realspace_bx, 0, ncomp);
-            }
-        field_mf_copy[mfi].copy<amrex::RunOn::Device>(field_mf[mfi], i_comp*ncomp, 0, ncomp);
-        multi_spectral_hankel_transformer[mfi].PhysicalToSpectral_Scalar(field_mf_copy[mfi], tempHTransformedSplit[mfi]);
-
-        FABZForwardTransform(mfi, realspace_bx, tempHTransformedSplit, field_index, is_nodal_z);
-
-    }
+    ForwardTransform(lev, {ForwardTransformInput(field_mf, field_index, i_comp)});
 }
 
 /* \brief Transform the coupled components of MultiFabs `field_mf_r` and `field_mf_t`
@@ -445,45 +318,213 @@ SpectralFieldDataRZ::ForwardTransform (const int lev,
                                        amrex::MultiFab const & field_mf_r, int const field_index_r,
                                        amrex::MultiFab const & field_mf_t, int const field_index_t)
 {
+    ForwardTransform(lev, {ForwardTransformInput(field_mf_r, field_index_r,
+                                                 field_mf_t, field_index_t)});
+}
+
+/* \brief Transform several real-space fields to spectral space,
+ * by batches of at most `m_batch_slots` slots. */
+void
+SpectralFieldDataRZ::ForwardTransform (const int lev,
+                                       std::vector<ForwardTransformInput> const & inputs)
+{
+    amrex::ignore_unused(lev);
+    ForEachBatch(inputs, m_batch_slots,
+        [this] (std::vector<ForwardTransformInput> const & batch) {
+            ForwardTransformBatch(batch);
+        });
+}
+
+/* \brief Transform one batch of real-space fields to spectral space.
+ *
+ * For each box, the real and imaginary parts of all the fields and modes
+ * are packed in one array. For each mode, the scalar fields come first,
+ * then the + parts and then the - parts of the vector fields, so that the
+ * Hankel transform of a mode is one matrix product per Hankel order.
+ * Each field of the packed array is called a slot. */
+void
+SpectralFieldDataRZ::ForwardTransformBatch (std::vector<ForwardTransformInput> const & inputs)
+{
+    int n_scalar = 0;
+    int n_vector = 0;
+    for (auto const & input : inputs) {
+        if (input.isVector()) {
+            n_vector++;
+        } else {
+            n_scalar++;
+        }
+    }
+    int const n_slots = n_scalar + 2*n_vector;
+    constexpr int n_fields = SpectralFieldIndex::n_fields;
+    AMREX_ALWAYS_ASSERT(n_slots <= m_batch_slots);
+
+    // Spectral field and z staggering of each slot.
     // Check field index type, in order to apply proper shift in spectral space.
     // Only cell centered in r is supported.
-    bool const is_nodal_z = field_mf_r.is_nodal(1);
-
-    // Create copies of the input multifabs. The copies will include the imaginary part of mode 0.
-    // Also note that the Hankel transform will overwrite the copies.
-    // Full multifabs are created for the temps so that each GPU stream has its own temp space.
-    amrex::MultiFab field_mf_r_copy(tempHTransformed.boxArray(), field_mf_r.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
-    amrex::MultiFab field_mf_t_copy(tempHTransformed.boxArray(), field_mf_t.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
+    amrex::GpuArray<int, n_fields> slot_field_index;
+    amrex::GpuArray<int, n_fields> slot_is_nodal_z;
+    {
+        int is = 0;
+        int iv = 0;
+        for (auto const & input : inputs) {
+            if (input.isVector()) {
+                slot_field_index[n_scalar + iv] = input.field_index;
+                slot_field_index[n_scalar + n_vector + iv] = input.field_index_t;
+                slot_is_nodal_z[n_scalar + iv] = input.mf->is_nodal(1);
+                slot_is_nodal_z[n_scalar + n_vector + iv] = input.mf->is_nodal(1);
+                iv++;
+            } else {
+                slot_field_index[is] = input.field_index;
+                slot_is_nodal_z[is] = input.mf->is_nodal(1);
+                is++;
+            }
+        }
+    }
 
-    amrex::MultiFab tempHTransformedSplit_p(tempHTransformed.boxArray(), tempHTransformed.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
-    amrex::MultiFab tempHTransformedSplit_m(tempHTransformed.boxArray(), tempHTransformed.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
+    int const modes = n_rz_azimuthal_modes;
+    // Number of components of each scalar field in real space
+    // (without the imaginary part of mode 0)
+    int const ncomp = 2*n_rz_azimuthal_modes - 1;
 
     // Loop over boxes.
-    for (amrex::MFIter mfi(field_mf_r); mfi.isValid(); ++mfi){
+    for (amrex::MFIter mfi(tempHTransformed); mfi.isValid(); ++mfi){
 
         amrex::Box const& realspace_bx = tempHTransformed[mfi].box();
-
-        if ( !(field_mf_r[mfi].box().contains(field_mf_r_copy[mfi].box())) ) {
-            // If field_mf_r[mfi] is smaller than field_mf_r_copy[mfi], then fill field_mf_r_copy[mfi] with
-            // zeros so that all of it is initialized.
-            field_mf_r_copy[mfi].setVal<amrex::RunOn::Device>(0._rt, realspace_bx, 0, 2*n_rz_azimuthal_modes);
-            field_mf_t_copy[mfi].setVal<amrex::RunOn::Device>(0._rt, realspace_bx, 0, 2*n_rz_azimuthal_modes);
+        amrex::Box const& spectralspace_bx = tmpSpectralField[mfi].box();
+        int const nz = realspace_bx.length(1);
+
+        // The packed fields before and after the Hankel transform, with the
+        // real and imaginary parts split, and before and after the z FFT.
+        // Only the first 2*modes*n_slots (split) or modes*n_slots (complex)
+        // components are used.
+        amrex::FArrayBox& physical_split = physicalSplit[mfi];
+        amrex::FArrayBox& hankel_split = hankelSplit[mfi];
+        amrex::BaseFab<Complex>& hankel_complex = tempHTransformed[mfi];
+        amrex::BaseFab<Complex>& spectral_complex = tmpSpectralField[mfi];
+
+        // Copy the fields to the packed array.
+        // If a field is smaller than realspace_bx, the missing values are zeros.
+        amrex::Array4<amrex::Real> const& physical_arr = physical_split.array();
+        int is = 0;
+        int iv = 0;
+        for (auto const & input : inputs) {
+            amrex::Box const field_bx = (*input.mf)[mfi].box();
+            amrex::Array4<const amrex::Real> const& field_arr = (*input.mf)[mfi].array();
+            if (input.isVector()) {
+                amrex::Array4<const amrex::Real> const& field_t_arr = (*input.mf_t)[mfi].array();
+                int const slot_p = n_scalar + iv;
+                int const slot_m = n_scalar + n_vector + iv;
+                ParallelFor(realspace_bx, modes,
+                [=] AMREX_GPU_DEVICE(int i, int j, int k, int mode) noexcept {
+                    amrex::Real r_real = 0._rt;
+                    amrex::Real r_imag = 0._rt;
+                    amrex::Real t_real = 0._rt;
+                    amrex::Real t_imag = 0._rt;
+                    if (field_bx.contains(amrex::IntVect(AMREX_D_DECL(i,j,k)))) {
+                        int const icomp = (mode == 0 ? 0 : 2*mode - 1);
+                        r_real = field_arr(i,j,k,icomp);
+                        t_real = field_t_arr(i,j,k,icomp);
+                        if (mode > 0) {
+                            r_imag = field_arr(i,j,k,icomp+1);
+                            t_imag = field_t_arr(i,j,k,icomp+1);
+                        }
+                    }
+                    // Combine the values
+                    // temp_p = (F_r - I*F_t)/2
+                    // temp_m = (F_r + I*F_t)/2
+                    int const ip = 2*(slot_p + mode*n_slots);
+                    int const im = 2*(slot_m + mode*n_slots);
+                    physical_arr(i,j,k,ip  ) = 0.5_rt*(r_real + t_imag);
+                    physical_arr(i,j,k,ip+1) = 0.5_rt*(r_imag - t_real);
+                    physical_arr(i,j,k,im  ) = 0.5_rt*(r_real - t_imag);
+                    physical_arr(i,j,k,im+1) = 0.5_rt*(r_imag + t_real);
+                });
+                iv++;
+            } else {
+                int const slot = is;
+                int const icomp0 = input.i_comp*ncomp;
+                ParallelFor(realspace_bx, modes,
+                [=] AMREX_GPU_DEVICE(int i, int j, int k, int mode) noexcept {
+                    amrex::Real f_real = 0._rt;
+                    amrex::Real f_imag = 0._rt;
+                    if (field_bx.contains(amrex::IntVect(AMREX_D_DECL(i,j,k)))) {
+                        int const icomp = icomp0 + (mode == 0 ? 0 : 2*mode - 1);
+                        f_real = field_arr(i,j,k,icomp);
+                        if (mode > 0) f_imag = field_arr(i,j,k,icomp+1);
+                    }
+                    int const ii = 2*(slot + mode*n_slots);
+                    physical_arr(i,j,k,ii  ) = f_real;
+                    physical_arr(i,j,k,ii+1) = f_imag;
+                });
+                is++;
             }
-        field_mf_r_copy[mfi].copy<amrex::RunOn::Device>(field_mf_r[mfi], 0, 0, 1); // Real part of mode 0
-        field_mf_t_copy[mfi].copy<amrex::RunOn::Device>(field_mf_t[mfi], 0, 0, 1); // Real part of mode 0
-        field_mf_r_copy[mfi].setVal<amrex::RunOn::Device>(0._rt, realspace_bx, 1, 1); // Imaginary part of mode 0
-        field_mf_t_copy[mfi].setVal<amrex::RunOn::Device>(0._rt, realspace_bx, 1, 1); // Imaginary part of mode 0
-        field_mf_r_copy[mfi].copy<amrex::RunOn::Device>(field_mf_r[mfi], 1, 2, 2*n_rz_azimuthal_modes-2);
-        field_mf_t_copy[mfi].copy<amrex::RunOn::Device>(field_mf_t[mfi], 1, 2, 2*n_rz_azimuthal_modes-2);
-
-        // Perform the Hankel transform first.
-        multi_spectral_hankel_transformer[mfi].PhysicalToSpectral_Vector(realspace_bx,
-                                                           field_mf_r_copy[mfi], field_mf_t_copy[mfi],
-                                                           tempHTransformedSplit_p[mfi], tempHTransformedSplit_m[mfi]);
-
-        FABZForwardTransform(mfi, realspace_bx, tempHTransformedSplit_p, field_index_r, is_nodal_z);
-        FABZForwardTransform(mfi, realspace_bx, tempHTransformedSplit_m, field_index_t, is_nodal_z);
+        }
 
+        SpectralHankelTransformer & hankel_transformer = multi_spectral_hankel_transformer[mfi];
+
+        // Hankel transform of all the fields of one mode
+        auto hankel_transform = [&] (int const mode) {
+            int const icomp = 2*mode*n_slots;
+            hankel_transformer.PhysicalToSpectral_Mode(mode,
+                                                       physical_split.dataPtr(icomp),
+                                                       hankel_split.dataPtr(icomp),
+                                                       2*n_scalar*nz, 2*n_vector*nz);
+        };
+
+        // z Fourier transform of all the fields of one mode, stored in `fields`
+        amrex::Array4<const amrex::Real> const& hankel_split_arr = hankel_split.array();
+        amrex::Array4<Complex> const& hankel_complex_arr = hankel_complex.array();
+        amrex::Array4<const Complex> const& spectral_complex_arr = spectral_complex.array();
+        amrex::Array4<Complex> const& fields_arr = fields[mfi].array();
+        Complex const* zshift_arr = zshift_FFTfromCell[mfi].dataPtr();
+        amrex::Real const inv_nz = 1._rt/spectralspace_bx.length(1);
+        auto z_transform = [&] (int const mode) {
+            // Copy the split complex to the interleaved complex.
+            ParallelFor(realspace_bx, n_slots,
+            [=] AMREX_GPU_DEVICE(int i, int j, int k, int slot) noexcept {
+                int const ii = slot + mode*n_slots;
+                hankel_complex_arr(i,j,k,ii) = Complex{hankel_split_arr(i,j,k,2*ii),
+                                                       hankel_split_arr(i,j,k,2*ii+1)};
+            });
+
+            ZTransform(mfi, hankel_complex.dataPtr(mode*n_slots),
+                       spectral_complex.dataPtr(mode*n_slots), n_slots, true);
+
+            // Copy the spectral-space fields to the appropriate index of the
+            // FabArray `fields` and apply correcting shift factor if the real space
+            // data comes from a cell-centered grid in real space instead of a nodal grid.
+            // The fields are organized so that the fields for each mode
+            // are grouped together in memory.
+            ParallelFor(spectralspace_bx, n_slots,
+            [=] AMREX_GPU_DEVICE(int i, int j, int k, int slot) noexcept {
+                Complex spectral_field_value = spectral_complex_arr(i,j,k,slot + mode*n_slots);
+                // Apply proper shift.
+                if (slot_is_nodal_z[slot] == false) spectral_field_value *= zshift_arr[j];
+                // Copy field into the correct index.
+                int const ic = slot_field_index[slot] + mode*n_fields;
+                fields_arr(i,j,k,ic) = spectral_field_value*inv_nz;
+            });
+        };
+
+        // With OpenMP on CPU, the z FFT of a mode runs in a task, which
+        // overlaps with the Hankel transform of the next mode.
+        // On GPU, all the kernels are launched asynchronously on the same stream.
+#if defined(AMREX_USE_OMP) && !defined(AMREX_USE_GPU)
+        std::vector<char> mode_done(modes);
+        char* const mode_done_ptr = mode_done.data();
+#pragma omp parallel
+#pragma omp single
+#endif
+        for (int mode=0 ; mode < modes ; mode++) {
+#if defined(AMREX_USE_OMP) && !defined(AMREX_USE_GPU)
+#pragma omp task depend(out: mode_done_ptr[mode])
+#endif
+            hankel_transform(mode);
+#if defined(AMREX_USE_OMP) && !defined(AMREX_USE_GPU)
+#pragma omp task depend(in: mode_done_ptr[mode])
+#endif
+            z_transform(mode);
+        }
     }
 }
 
@@ -494,32 +535,7 @@ SpectralFieldDataRZ::BackwardTransform (const int lev,
                                         amrex::MultiFab& field_mf, int const field_index,
                                         int const i_comp)
 {
-    // Check field index type, in order to apply proper shift in spectral space.
-    bool const is_nodal_z = field_mf.is_nodal(1);
-
-    int const ncomp = 2*n_rz_azimuthal_modes - 1;
-
-    // A full multifab is created so that each GPU stream has its own temp space.
-    amrex::MultiFab tempHTransformedSplit(tempHTransformed.boxArray(), tempHTransformed.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
-
-    // Create a temporary to hold the inverse Hankel transform field.
-    // This allows the final result to have a different shape than the transformed field.
-    amrex::MultiFab field_mf_copy(tempHTransformed.boxArray(), tempHTransformed.DistributionMap(), 2*n_rz_azimuthal_modes-1, 0);
-
-    // Loop over boxes.
-    for (amrex::MFIter mfi(field_mf); mfi.isValid(); ++mfi){
-
-        amrex::Box const& realspace_bx = tempHTransformed[mfi].box();
-
-        FABZBackwardTransform(mfi, realspace_bx, field_index, tempHTransformedSplit, is_nodal_z);
-
-        // Perform the Hankel inverse transform last.
-        // tempHTransformedSplit includes the imaginary component of mode 0.
-        // field_mf does not.
-        multi_spectral_hankel_transformer[mfi].SpectralToPhysical_Scalar(tempHTransformedSplit[mfi], field_mf_copy[mfi]);
-        field_mf[mfi].copy<amrex::RunOn::Device>(field_mf_copy[mfi], 0, i_comp*ncomp, ncomp);
-
-    }
+    BackwardTransform(lev, {BackwardTransformOutput(field_mf, field_index, i_comp)});
 }
 
 /* \brief Transform spectral fields specified by `field_index_r` and
@@ -529,51 +545,187 @@ SpectralFieldDataRZ::BackwardTransform (const int lev,
                                         amrex::MultiFab& field_mf_r, int const field_index_r,
                                         amrex::MultiFab& field_mf_t, int const field_index_t)
 {
-    // Check field index type, in order to apply proper shift in spectral space.
-    bool const is_nodal_z = field_mf_r.is_nodal(1);
+    BackwardTransform(lev, {BackwardTransformOutput(field_mf_r, field_index_r,
+                                                    field_mf_t, field_index_t)});
+}
 
-    // Full multifabs are created for the temps so that each GPU stream has its own temp space.
-    amrex::MultiFab tempHTransformedSplit_p(tempHTransformed.boxArray(), tempHTransformed.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
-    amrex::MultiFab tempHTransformedSplit_m(tempHTransformed.boxArray(), tempHTransformed.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
+/* \brief Transform several spectral fields back to real space,
+ * with the same batches as the batched ForwardTransform. */
+void
+SpectralFieldDataRZ::BackwardTransform (const int lev,
+                                        std::vector<BackwardTransformOutput> const & outputs)
+{
+    amrex::ignore_unused(lev);
+    ForEachBatch(outputs, m_batch_slots,
+        [this] (std::vector<BackwardTransformOutput> const & batch) {
+            BackwardTransformBatch(batch);
+        });
+}
 
-    // Create copies of the input multifabs. The copies will include the imaginary part of mode 0.
-    amrex::MultiFab field_mf_r_copy(tempHTransformed.boxArray(), field_mf_r.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
-    amrex::MultiFab field_mf_t_copy(tempHTransformed.boxArray(), field_mf_t.DistributionMap(), 2*n_rz_azimuthal_modes, 0);
+/* \brief Transform one batch of spectral fields back to real space,
+ * with the same packing as ForwardTransformBatch. */
+void
+SpectralFieldDataRZ::BackwardTransformBatch (std::vector<BackwardTransformOutput> const & outputs)
+{
+    int n_scalar = 0;
+    int n_vector = 0;
+    for (auto const & output : outputs) {
+        if (output.isVector()) {
+            n_vector++;
+        } else {
+            n_scalar++;
+        }
+    }
+    int const n_slots = n_scalar + 2*n_vector;
+    constexpr int n_fields = SpectralFieldIndex::n_fields;
+    AMREX_ALWAYS_ASSERT(n_slots <= m_batch_slots);
+
+    // Spectral field and z staggering of each slot
+    amrex::GpuArray<int, n_fields> slot_field_index;
+    amrex::GpuArray<int, n_fields> slot_is_nodal_z;
+    {
+        int is = 0;
+        int iv = 0;
+        for (auto const & output : outputs) {
+            if (output.isVector()) {
+                slot_field_index[n_scalar + iv] = output.field_index;
+                slot_field_index[n_scalar + n_vector + iv] = output.field_index_t;
+                slot_is_nodal_z[n_scalar + iv] = output.mf->is_nodal(1);
+                slot_is_nodal_z[n_scalar + n_vector + iv] = output.mf->is_nodal(1);
+                iv++;
+            } else {
+                slot_field_index[is] = output.field_index;
+                slot_is_nodal_z[is] = output.mf->is_nodal(1);
+                is++;
+            }
+        }
+    }
+
+    int const modes = n_rz_azimuthal_modes;
+    int const ncomp = 2*n_rz_azimuthal_modes - 1;
 
     // Loop over boxes.
-    for (amrex::MFIter mfi(field_mf_r); mfi.isValid(); ++mfi){
+    for (amrex::MFIter mfi(tempHTransformed); mfi.isValid(); ++mfi){
 
         amrex::Box const& realspace_bx = tempHTransformed[mfi].box();
+        amrex::Box const& spectralspace_bx = tmpSpectralField[mfi].box();
+        int const nz = realspace_bx.length(1);
+
+        // Same packing as in ForwardTransformBatch
+        amrex::FArrayBox& physical_split = physicalSplit[mfi];
+        amrex::FArrayBox& hankel_split = hankelSplit[mfi];
+        amrex::BaseFab<Complex>& hankel_complex = tempHTransformed[mfi];
+        amrex::BaseFab<Complex>& spectral_complex = tmpSpectralField[mfi];
+
+        // Backward z Fourier transform of all the fields of one mode
+        amrex::Array4<const Complex> const& fields_arr = fields[mfi].array();
+        amrex::Array4<Complex> const& spectral_complex_arr = spectral_complex.array();
+        amrex::Array4<const Complex> const& hankel_complex_arr = hankel_complex.array();
+        amrex::Array4<amrex::Real> const& hankel_split_arr = hankel_split.array();
+        Complex const* zshift_arr = zshift_FFTtoCell[mfi].dataPtr();
+        auto z_transform = [&] (int const mode) {
+            // Copy the spectral-space fields from the appropriate index of the
+            // FabArray `fields` and apply correcting shift factor if the real space
+            // data is on a cell-centered grid in real space instead of a nodal grid.
+            ParallelFor(spectralspace_bx, n_slots,
+            [=] AMREX_GPU_DEVICE(int i, int j, int k, int slot) noexcept {
+                int const ic = slot_field_index[slot] + mode*n_fields;
+                Complex spectral_field_value = fields_arr(i,j,k,ic);
+                // Apply proper shift.
+                if (slot_is_nodal_z[slot] == false) spectral_field_value *= zshift_arr[j];
+                // Copy field into the right index.
+                spectral_complex_arr(i,j,k,slot + mode*n_slots) = spectral_field_value;
+            });
+
+            ZTransform(mfi, hankel_complex.dataPtr(mode*n_slots),
+                       spectral_complex.dataPtr(mode*n_slots), n_slots, false);
+
+            // Copy the interleaved complex to the split complex.
+            ParallelFor(realspace_bx, n_slots,
+            [=] AMREX_GPU_DEVICE(int i, int j, int k, int slot) noexcept {
+                int const ii = slot + mode*n_slots;
+                hankel_split_arr(i,j,k,2*ii  ) = hankel_complex_arr(i,j,k,ii).real();
+                hankel_split_arr(i,j,k,2*ii+1) = hankel_complex_arr(i,j,k,ii).imag();
+            });
+        };
+
+        SpectralHankelTransformer & hankel_transformer = multi_spectral_hankel_transformer[mfi];
+
+        // Hankel inverse transform of all the fields of one mode
+        auto hankel_transform = [&] (int const mode) {
+            int const icomp = 2*mode*n_slots;
+            hankel_transformer.SpectralToPhysical_Mode(mode,
+                                                       hankel_split.dataPtr(icomp),
+                                                       physical_split.dataPtr(icomp),
+                                                       2*n_scalar*nz, 2*n_vector*nz);
+        };
+
+        // With OpenMP on CPU, the Hankel transform of a mode runs in a task,
+        // which overlaps with the z FFT of the next mode.
+        // On GPU, all the kernels are launched asynchronously on the same stream.
+#if defined(AMREX_USE_OMP) && !defined(AMREX_USE_GPU)
+        std::vector<char> mode_done(modes);
+        char* const mode_done_ptr = mode_done.data();
+#pragma omp parallel
+#pragma omp single
+#endif
+        for (int mode=0 ; mode < modes ; mode++) {
+#if defined(AMREX_USE_OMP) && !defined(AMREX_USE_GPU)
+#pragma omp task depend(out: mode_done_ptr[mode])
+#endif
+            z_transform(mode);
+#if defined(AMREX_USE_OMP) && !defined(AMREX_USE_GPU)
+#pragma omp task depend(in: mode_done_ptr[mode])
+#endif
+            hankel_transform(mode);
+        }
 
-        FABZBackwardTransform(mfi, realspace_bx, field_index_r, tempHTransformedSplit_p, is_nodal_z);
-        FABZBackwardTransform(mfi, realspace_bx, field_index_t, tempHTransformedSplit_m, is_nodal_z);
-
-        // Perform the Hankel inverse transform last.
-        // tempHTransformedSplit includes the imaginary component of mode 0.
-        // field_mf_[ri] do not.
-        multi_spectral_hankel_transformer[mfi].SpectralToPhysical_Vector(realspace_bx,
-                                                           tempHTransformedSplit_p[mfi], tempHTransformedSplit_m[mfi],
-                                                           field_mf_r_copy[mfi], field_mf_t_copy[mfi]);
-
-        amrex::Array4<amrex::Real> const & field_mf_r_array = field_mf_r[mfi].array();
-        amrex::Array4<amrex::Real> const & field_mf_t_array = field_mf_t[mfi].array();
-        amrex::Array4<amrex::Real> const & field_mf_r_copy_array = field_mf_r_copy[mfi].array();
-        amrex::Array4<amrex::Real> const & field_mf_t_copy_array = field_mf_t_copy[mfi].array();
-
-        ParallelFor(realspace_bx, 2*n_rz_azimuthal_modes-1,
-        [=] AMREX_GPU_DEVICE(int i, int j, int k, int icomp) noexcept {
-            if (icomp == 0) {
-                // mode 0
-                field_mf_r_array(i,j,k,icomp) = field_mf_r_copy_array(i,j,k,icomp);
-                field_mf_t_array(i,j,k,icomp) = field_mf_t_copy_array(i,j,k,icomp);
+        // Copy the packed fields to the outputs.
+        // The imaginary part of mode 0 is not copied.
+        amrex::Array4<const amrex::Real> const& physical_arr = physical_split.array();
+        int is = 0;
+        int iv = 0;
+        for (auto const & output : outputs) {
+            amrex::Box const bx = realspace_bx & (*output.mf)[mfi].box();
+            amrex::Array4<amrex::Real> const& field_arr = (*output.mf)[mfi].array();
+            if (output.isVector()) {
+                amrex::Array4<amrex::Real> const& field_t_arr = (*output.mf_t)[mfi].array();
+                int const slot_p = n_scalar + iv;
+                int const slot_m = n_scalar + n_vector + iv;
+                ParallelFor(bx, modes,
+                [=] AMREX_GPU_DEVICE(int i, int j, int k, int mode) noexcept {
+                    int const ip = 2*(slot_p + mode*n_slots);
+                    int const im = 2*(slot_m + mode*n_slots);
+                    amrex::Real const p_real = physical_arr(i,j,k,ip  );
+                    amrex::Real const p_imag = physical_arr(i,j,k,ip+1);
+                    amrex::Real const m_real = physical_arr(i,j,k,im  );
+                    amrex::Real const m_imag = physical_arr(i,j,k,im+1);
+                    // Combine the values
+                    // F_r =    G_p + G_m
+                    // F_t = I*(G_p - G_m)
+                    int const icomp = (mode == 0 ? 0 : 2*mode - 1);
+                    field_arr(i,j,k,icomp) = p_real + m_real;
+                    field_t_arr(i,j,k,icomp) = -p_imag + m_imag;
+                    if (mode > 0) {
+                        field_arr(i,j,k,icomp+1) = p_imag + m_imag;
+                        field_t_arr(i,j,k,icomp+1) = p_real - m_real;
+                    }
+                });
+                iv++;
             } else {
-                field_mf_r_array(i,j,k,icomp) = field_mf_r_copy_array(i,j,k,icomp+1);
-                field_mf_t_array(i,j,k,icomp) = field_mf_t_copy_array(i,j,k,icomp+1);
+                int const slot = is;
+                int const icomp0 = output.i_comp*ncomp;
+                ParallelFor(bx, modes,
+                [=] AMREX_GPU_DEVICE(int i, int j, int k, int mode) noexcept {
+                    int const ii = 2*(slot + mode*n_slots);
+                    int const icomp = icomp0 + (mode == 0 ? 0 : 2*mode - 1);
+                    field_arr(i,j,k,icomp) = physical_arr(i,j,k,ii);
+                    if (mode > 0) field_arr(i,j,k,icomp+1) = physical_arr(i,j,k,ii+1);
+                });
+                is++;
             }
-        });
-
+        }
     }
-
 }
 
 /* \brief Initialize arrays used for filtering */
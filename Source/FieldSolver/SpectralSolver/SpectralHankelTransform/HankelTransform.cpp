@@ -279,3 +279,71 @@ HankelTransform::HankelInverseTransform (amrex::FArrayBox const& G, int const G_
 #endif
 
 }
+
+void
+HankelTransform::HankelForwardTransform (amrex::Real const* F, amrex::Real* G, int const ncols)
+{
+    if (ncols == 0) return;
+
+#ifndef AMREX_USE_GPU
+    // A single matrix product for all the columns
+    blas::gemm(blas::Layout::ColMajor, blas::Op::Trans, blas::Op::NoTrans,
+               m_nk, ncols, m_nr, 1._rt,
+               m_M.dataPtr(), m_nk,
+               F, m_nr, 0._rt,
+               G, m_nk);
+
+#else
+    amrex::Real const * M_arr = m_M.dataPtr();
+
+    int const nr = m_nr;
+    int const nk = m_nk;
+
+    amrex::ParallelFor(nk*ncols,
+    [=] AMREX_GPU_DEVICE(int ii) noexcept {
+        int const ik = ii % nk;
+        int const icol = ii / nk;
+        amrex::Real sum = 0.;
+        for (int ir=0 ; ir < nr ; ir++) {
+            sum += M_arr[ir + ik*nr]*F[ir + icol*nr];
+        }
+        G[ii] = sum;
+    });
+
+#endif
+
+}
+
+void
+HankelTransform::HankelInverseTransform (amrex::Real const* G, amrex::Real* F, int const ncols)
+{
+    if (ncols == 0) return;
+
+#ifndef AMREX_USE_GPU
+    // A single matrix product for all the columns
+    blas::gemm(blas::Layout::ColMajor, blas::Op::Trans, blas::Op::NoTrans,
+               m_nr, ncols, m_nk, 1._rt,
+               m_invM.dataPtr(), m_nr,
+               G, m_nk, 0._rt,
+               F, m_nr);
+
+#else
+    amrex::Real const * invM_arr = m_invM.dataPtr();
+
+    int const nr = m_nr;
+    int const nk = m_nk;
+
+    amrex::ParallelFor(nr*ncols,
+    [=] AMREX_GPU_DEVICE(int ii) noexcept {
+        int const ir = ii % nr;
+        int const icol = ii / nr;
+        amrex::Real sum = 0.;
+        for (int ik=0 ; ik < nk ; ik++) {
+            sum += invM_arr[ik + ir*nk]*G[ik + icol*nk];
+        }
+        F[ii] = sum;
+    });
+
+#endif
+
+}
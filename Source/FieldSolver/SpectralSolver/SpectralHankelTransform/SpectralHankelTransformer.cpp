@@ -198,3 +198,37 @@ SpectralHankelTransformer::SpectralToPhysical_Vector (amrex::Box const & box,
 
     }
 }
+
+/* \brief Converts the packed fields of one mode from the physical to the spectral space.
+ * The columns that use the same Hankel transform are contiguous, so that
+ * each transform is done with a single matrix product. */
+void
+SpectralHankelTransformer::PhysicalToSpectral_Mode (int const mode,
+                                                    amrex::Real const * F_physical,
+                                                    amrex::Real       * G_spectral,
+                                                    int const ncols_scalar, int const ncols_vector)
+{
+    dht0[mode]->HankelForwardTransform(F_physical, G_spectral, ncols_scalar);
+    F_physical += m_nr*ncols_scalar;
+    G_spectral += m_nr*ncols_scalar;
+    dhtp[mode]->HankelForwardTransform(F_physical, G_spectral, ncols_vector);
+    F_physical += m_nr*ncols_vector;
+    G_spectral += m_nr*ncols_vector;
+    dhtm[mode]->HankelForwardTransform(F_physical, G_spectral, ncols_vector);
+}
+
+/* \brief Converts the packed fields of one mode from the spectral to the physical space */
+void
+SpectralHankelTransformer::SpectralToPhysical_Mode (int const mode,
+                                                    amrex::Real const * G_spectral,
+                                                    amrex::Real       * F_physical,
+                                                    int const ncols_scalar, int const ncols_vector)
+{
+    dht0[mode]->HankelInverseTransform(G_spectral, F_physical, ncols_scalar);
+    G_spectral += m_nr*ncols_scalar;
+    F_physical += m_nr*ncols_scalar;
+    dhtp[mode]->HankelInverseTransform(G_spectral, F_physical, ncols_vector);
+    G_spectral += m_nr*ncols_vector;
+    F_physical += m_nr*ncols_vector;
+    dhtm[mode]->HankelInverseTransform(G_spectral, F_physical, ncols_vector);
+}
@@ -100,6 +100,22 @@ SpectralSolver::BackwardTransform( const int lev,
     field_data.BackwardTransform( lev, mf, field_index, i_comp );
 }
 
+void
+SpectralSolver::ForwardTransform( const int lev,
+                                  const std::vector<SpectralFieldData::ForwardTransformInput>& inputs )
+{
+    WARPX_PROFILE("SpectralSolver::ForwardTransform");
+    field_data.ForwardTransform( lev, inputs );
+}
+
+void
+SpectralSolver::BackwardTransform( const int lev,
+                                   const std::vector<SpectralFieldData::BackwardTransformOutput>& outputs )
+{
+    WARPX_PROFILE("SpectralSolver::BackwardTransform");
+    field_data.BackwardTransform( lev, outputs );
+}
+
 void
 SpectralSolver::pushSpectralFields(){
     WARPX_PROFILE("SpectralSolver::pushSpectralFields");
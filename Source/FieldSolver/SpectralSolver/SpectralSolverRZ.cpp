@@ -106,6 +106,22 @@ SpectralSolverRZ::BackwardTransform (const int lev,
                                  field_mf2, field_index2);
 }
 
+/* \brief Transform several real-space fields to spectral space */
+void
+SpectralSolverRZ::ForwardTransform (const int lev,
+                                    std::vector<SpectralFieldDataRZ::ForwardTransformInput> const & inputs) {
+    WARPX_PROFILE("SpectralSolverRZ::ForwardTransform");
+    field_data.ForwardTransform(lev, inputs);
+}
+
+/* \brief Transform several spectral fields back to real space */
+void
+SpectralSolverRZ::BackwardTransform (const int lev,
+                                     std::vector<SpectralFieldDataRZ::BackwardTransformOutput> const & outputs) {
+    WARPX_PROFILE("SpectralSolverRZ::BackwardTransform");
+    field_data.BackwardTransform(lev, outputs);
+}
+
 /* \brief Update the fields in spectral space, over one timestep */
 void
 SpectralSolverRZ::pushSpectralFields () {
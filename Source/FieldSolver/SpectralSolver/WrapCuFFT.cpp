@@ -20,14 +20,47 @@ namespace AnyFFT
 
     std::string cufftErrorToString (const cufftResult& err);
 
+    void Initialize(const PlannerRigor rigor, const int nthreads, const std::string& wisdom_file)
+    {
+        // cuFFT does not have planner options or wisdom
+        amrex::ignore_unused(rigor, nthreads, wisdom_file);
+    }
+
+    void Finalize() {}
+
     FFTplan CreatePlan(const amrex::IntVect& real_size, amrex::Real * const real_array,
-                       Complex * const complex_array, const direction dir, const int dim)
+                       Complex * const complex_array, const direction dir, const int dim,
+                       const int howmany)
     {
         FFTplan fft_plan;
 
         // Initialize fft_plan.m_plan with the vendor fft plan.
         cufftResult result;
-        if (dir == direction::R2C){
+        if (howmany > 1) {
+            if (dim != 2 && dim != 3) {
+                amrex::Abort("only dim=2 and dim=3 have been implemented");
+            }
+            // Swap dimensions: AMReX FAB are Fortran-order but cuFFT is C-order
+            int n[3];
+            int complex_n[3];
+            int real_dist = 1;
+            for (int idim = 0; idim < dim; ++idim) {
+                n[idim] = real_size[dim-1-idim];
+                complex_n[idim] = n[idim];
+                real_dist *= real_size[idim];
+            }
+            complex_n[dim-1] = real_size[0]/2 + 1;
+            const int complex_dist = real_dist / real_size[0] * complex_n[dim-1];
+            if (dir == direction::R2C){
+                result = cufftPlanMany(&(fft_plan.m_plan), dim, n,
+                                       n, 1, real_dist, complex_n, 1, complex_dist,
+                                       VendorR2C, howmany);
+            } else {
+                result = cufftPlanMany(&(fft_plan.m_plan), dim, n,
+                                       complex_n, 1, complex_dist, n, 1, real_dist,
+                                       VendorC2R, howmany);
+            }
+        } else if (dir == direction::R2C){
             if (dim == 3) {
                 result = cufftPlan3d(
                     &(fft_plan.m_plan), real_size[2], real_size[1], real_size[0], VendorR2C);
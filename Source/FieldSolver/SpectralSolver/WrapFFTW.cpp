@@ -7,6 +7,15 @@
 
 #include "AnyFFT.H"
 
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
 namespace AnyFFT
 {
 #ifdef AMREX_USE_FLOAT
@@ -14,37 +23,193 @@ namespace AnyFFT
     const auto VendorCreatePlanC2R3D = fftwf_plan_dft_c2r_3d;
     const auto VendorCreatePlanR2C2D = fftwf_plan_dft_r2c_2d;
     const auto VendorCreatePlanC2R2D = fftwf_plan_dft_c2r_2d;
+    const auto VendorCreatePlanManyR2C = fftwf_plan_many_dft_r2c;
+    const auto VendorCreatePlanManyC2R = fftwf_plan_many_dft_c2r;
+    const auto VendorImportWisdom = fftwf_import_wisdom_from_string;
+    const auto VendorExportWisdom = fftwf_export_wisdom_to_string;
+#  ifdef WARPX_USE_FFTW_THREADS
+    const auto VendorInitThreads = fftwf_init_threads;
+    const auto VendorPlanWithNThreads = fftwf_plan_with_nthreads;
+    const auto VendorCleanupThreads = fftwf_cleanup_threads;
+#  endif
 #else
     const auto VendorCreatePlanR2C3D = fftw_plan_dft_r2c_3d;
     const auto VendorCreatePlanC2R3D = fftw_plan_dft_c2r_3d;
     const auto VendorCreatePlanR2C2D = fftw_plan_dft_r2c_2d;
     const auto VendorCreatePlanC2R2D = fftw_plan_dft_c2r_2d;
+    const auto VendorCreatePlanManyR2C = fftw_plan_many_dft_r2c;
+    const auto VendorCreatePlanManyC2R = fftw_plan_many_dft_c2r;
+    const auto VendorImportWisdom = fftw_import_wisdom_from_string;
+    const auto VendorExportWisdom = fftw_export_wisdom_to_string;
+#  ifdef WARPX_USE_FFTW_THREADS
+    const auto VendorInitThreads = fftw_init_threads;
+    const auto VendorPlanWithNThreads = fftw_plan_with_nthreads;
+    const auto VendorCleanupThreads = fftw_cleanup_threads;
+#  endif
 #endif
 
+    namespace
+    {
+        unsigned planner_flags = FFTW_ESTIMATE;
+        std::string wisdom_filename;
+        bool initialized = false;
+        bool threads_initialized = false;
+
+        /** Read the wisdom file on the I/O rank, broadcast it and import it on all ranks */
+        void LoadWisdom ()
+        {
+            int file_exists = 0;
+            if (amrex::ParallelDescriptor::IOProcessor()) {
+                file_exists = amrex::FileExists(wisdom_filename);
+            }
+            amrex::ParallelDescriptor::Bcast(&file_exists, 1,
+                                             amrex::ParallelDescriptor::IOProcessorNumber());
+            if (!file_exists) return;
+
+            amrex::Vector<char> file_chars;
+            amrex::ParallelDescriptor::ReadAndBcastFile(wisdom_filename, file_chars);
+            if (!VendorImportWisdom(file_chars.dataPtr())) {
+                amrex::Print() << "Warning: could not import FFTW wisdom from "
+                               << wisdom_filename << "\n";
+            }
+        }
+
+        /** Gather the wisdom of all ranks on the I/O rank and write it to the wisdom file */
+        void SaveWisdom ()
+        {
+            char* wisdom = VendorExportWisdom();
+            // Send the terminating null character too, so that the strings can be imported in place
+            int my_size = static_cast<int>(std::strlen(wisdom)) + 1;
+
+            const int nprocs = amrex::ParallelDescriptor::NProcs();
+            const int ioproc = amrex::ParallelDescriptor::IOProcessorNumber();
+            std::vector<int> sizes(nprocs, 0);
+            amrex::ParallelDescriptor::Gather(&my_size, 1, sizes.data(), ioproc);
+
+            std::vector<int> offsets(nprocs, 0);
+            for (int i = 1; i < nprocs; ++i) {
+                offsets[i] = offsets[i-1] + sizes[i-1];
+            }
+            std::vector<char> all_wisdom;
+            if (amrex::ParallelDescriptor::IOProcessor()) {
+                all_wisdom.resize(offsets[nprocs-1] + sizes[nprocs-1]);
+            }
+            amrex::ParallelDescriptor::Gatherv(wisdom, my_size, all_wisdom.data(),
+                                               sizes, offsets, ioproc);
+            std::free(wisdom);
+
+            if (amrex::ParallelDescriptor::IOProcessor()) {
+                // Merge the wisdom of all ranks: the I/O rank already has its own
+                for (int i = 0; i < nprocs; ++i) {
+                    if (i != ioproc) VendorImportWisdom(all_wisdom.data() + offsets[i]);
+                }
+                char* merged_wisdom = VendorExportWisdom();
+                std::ofstream ofs(wisdom_filename, std::ios::trunc);
+                if (ofs) {
+                    ofs << merged_wisdom;
+                } else {
+                    amrex::Print() << "Warning: could not write FFTW wisdom to "
+                                   << wisdom_filename << "\n";
+                }
+                std::free(merged_wisdom);
+            }
+        }
+    }
+
+    void Initialize(const PlannerRigor rigor, const int nthreads, const std::string& wisdom_file)
+    {
+        if (initialized) return;
+        initialized = true;
+
+        switch (rigor) {
+            case PlannerRigor::Estimate: planner_flags = FFTW_ESTIMATE; break;
+            case PlannerRigor::Measure: planner_flags = FFTW_MEASURE; break;
+            case PlannerRigor::Patient: planner_flags = FFTW_PATIENT; break;
+        }
+
+#ifdef WARPX_USE_FFTW_THREADS
+        // Must be called before any other FFTW function
+        if (nthreads > 1) {
+            threads_initialized = VendorInitThreads();
+            if (threads_initialized) {
+                VendorPlanWithNThreads(nthreads);
+            } else {
+                amrex::Print() << "Warning: FFTW threads could not be initialized\n";
+            }
+        }
+#else
+        amrex::ignore_unused(nthreads);
+#endif
+
+        wisdom_filename = wisdom_file;
+        if (!wisdom_filename.empty()) LoadWisdom();
+    }
+
+    void Finalize()
+    {
+        if (!initialized) return;
+        initialized = false;
+
+        if (!wisdom_filename.empty()) SaveWisdom();
+#ifdef WARPX_USE_FFTW_THREADS
+        if (threads_initialized) {
+            VendorCleanupThreads();
+            threads_initialized = false;
+        }
+#endif
+    }
+
+    unsigned PlannerFlags()
+    {
+        return planner_flags;
+    }
+
     FFTplan CreatePlan(const amrex::IntVect& real_size, amrex::Real * const real_array,
-                       Complex * const complex_array, const direction dir, const int dim)
+                       Complex * const complex_array, const direction dir, const int dim,
+                       const int howmany)
     {
         FFTplan fft_plan;
 
         // Initialize fft_plan.m_plan with the vendor fft plan.
         // Swap dimensions: AMReX FAB are Fortran-order but FFTW is C-order
-        if (dir == direction::R2C){
+        if (howmany > 1) {
+            if (dim != 2 && dim != 3) {
+                amrex::Abort("only dim=2 and dim=3 have been implemented");
+            }
+            int n[3];
+            int real_dist = 1;
+            for (int idim = 0; idim < dim; ++idim) {
+                n[idim] = real_size[dim-1-idim];
+                real_dist *= real_size[idim];
+            }
+            // The last (fastest) dimension of the complex array has n/2+1 points
+            const int complex_dist = real_dist / real_size[0] * (real_size[0]/2 + 1);
+            if (dir == direction::R2C){
+                fft_plan.m_plan = VendorCreatePlanManyR2C(
+                    dim, n, howmany, real_array, nullptr, 1, real_dist,
+                    complex_array, nullptr, 1, complex_dist, planner_flags);
+            } else if (dir == direction::C2R){
+                fft_plan.m_plan = VendorCreatePlanManyC2R(
+                    dim, n, howmany, complex_array, nullptr, 1, complex_dist,
+                    real_array, nullptr, 1, real_dist, planner_flags);
+            }
+        } else if (dir == direction::R2C){
             if (dim == 3) {
                 fft_plan.m_plan = VendorCreatePlanR2C3D(
-                    real_size[2], real_size[1], real_size[0], real_array, complex_array, FFTW_ESTIMATE);
+                    real_size[2], real_size[1], real_size[0], real_array, complex_array, planner_flags);
             } else if (dim == 2) {
                 fft_plan.m_plan = VendorCreatePlanR2C2D(
-                    real_size[1], real_size[0], real_array, complex_array, FFTW_ESTIMATE);
+                    real_size[1], real_size[0], real_array, complex_array, planner_flags);
             } else {
                 amrex::Abort("only dim=2 and dim=3 have been implemented");
             }
         } else if (dir == direction::C2R){
             if (dim == 3) {
                 fft_plan.m_plan = VendorCreatePlanC2R3D(
-                    real_size[2], real_size[1], real_size[0], complex_array, real_array, FFTW_ESTIMATE);
+                    real_size[2], real_size[1], real_size[0], complex_array, real_array, planner_flags);
             } else if (dim == 2) {
                 fft_plan.m_plan = VendorCreatePlanC2R2D(
-                    real_size[1], real_size[0], complex_array, real_array, FFTW_ESTIMATE);
+                    real_size[1], real_size[0], complex_array, real_array, planner_flags);
             } else {
                 amrex::Abort("only dim=2 and dim=3 have been implemented. Should be easy to add dim=1.");
             }
@@ -21,8 +21,17 @@ namespace AnyFFT
         }
     }
 
+    void Initialize (const PlannerRigor rigor, const int nthreads, const std::string& wisdom_file)
+    {
+        // rocFFT does not have planner options or wisdom
+        amrex::ignore_unused(rigor, nthreads, wisdom_file);
+    }
+
+    void Finalize () {}
+
     FFTplan CreatePlan (const amrex::IntVect& real_size, amrex::Real * const real_array,
-                        Complex * const complex_array, const direction dir, const int dim)
+                        Complex * const complex_array, const direction dir, const int dim,
+                        const int howmany)
     {
         FFTplan fft_plan;
 
@@ -42,8 +51,8 @@ namespace AnyFFT
                                                   rocfft_precision_double,
 #endif
                                                   dim, lengths,
-                                                  1, // number of transforms,
-                                                  nullptr);
+                                                  howmany, // number of transforms,
+                                                  nullptr); // contiguous transforms
         assert_rocfft_status("rocfft_plan_create", result);
 
         // Store meta-data in fft_plan
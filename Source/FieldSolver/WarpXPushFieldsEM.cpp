@@ -19,6 +19,7 @@
 #include <AMReX.H>
 #include <AMReX_Math.H>
 #include <limits>
+#include <vector>
 
 
 using namespace amrex;
@@ -48,76 +49,59 @@ namespace {
 
         // Perform forward Fourier transform
 #ifdef WARPX_DIM_RZ
-        solver.ForwardTransform(lev,
-                                *Efield[0], Idx::Ex,
-                                *Efield[1], Idx::Ey);
-#else
-        solver.ForwardTransform(lev, *Efield[0], Idx::Ex);
-        solver.ForwardTransform(lev, *Efield[1], Idx::Ey);
-#endif
-        solver.ForwardTransform(lev, *Efield[2], Idx::Ez);
-#ifdef WARPX_DIM_RZ
-        solver.ForwardTransform(lev,
-                                *Bfield[0], Idx::Bx,
-                                *Bfield[1], Idx::By);
-#else
-        solver.ForwardTransform(lev, *Bfield[0], Idx::Bx);
-        solver.ForwardTransform(lev, *Bfield[1], Idx::By);
-#endif
-        solver.ForwardTransform(lev, *Bfield[2], Idx::Bz);
-#ifdef WARPX_DIM_RZ
-        solver.ForwardTransform(lev,
-                                *current[0], Idx::Jx,
-                                *current[1], Idx::Jy);
-#else
-        solver.ForwardTransform(lev, *current[0], Idx::Jx);
-        solver.ForwardTransform(lev, *current[1], Idx::Jy);
-#endif
-        solver.ForwardTransform(lev, *current[2], Idx::Jz);
-
+        // All the fields and modes of a box are Hankel transformed together
+        using Input = SpectralFieldDataRZ::ForwardTransformInput;
+        std::vector<Input> inputs {
+            Input(*Efield[0], Idx::Ex, *Efield[1], Idx::Ey), Input(*Efield[2], Idx::Ez),
+            Input(*Bfield[0], Idx::Bx, *Bfield[1], Idx::By), Input(*Bfield[2], Idx::Bz),
+            Input(*current[0], Idx::Jx, *current[1], Idx::Jy), Input(*current[2], Idx::Jz)};
         if (rho) {
-            solver.ForwardTransform(lev, *rho, Idx::rho_old, 0);
-            solver.ForwardTransform(lev, *rho, Idx::rho_new, 1);
+            inputs.emplace_back(*rho, Idx::rho_old, 0);
+            inputs.emplace_back(*rho, Idx::rho_new, 1);
         }
-#ifdef WARPX_DIM_RZ
+        solver.ForwardTransform(lev, inputs);
+
         if (WarpX::use_kspace_filter) {
             solver.ApplyFilter(Idx::rho_old);
             solver.ApplyFilter(Idx::rho_new);
             solver.ApplyFilter(Idx::Jx, Idx::Jy, Idx::Jz);
         }
+#else
+        // All the fields of a box are transformed with batched FFTs
+        using Input = SpectralFieldData::ForwardTransformInput;
+        std::vector<Input> inputs {
+            Input(*Efield[0], Idx::Ex), Input(*Efield[1], Idx::Ey), Input(*Efield[2], Idx::Ez),
+            Input(*Bfield[0], Idx::Bx), Input(*Bfield[1], Idx::By), Input(*Bfield[2], Idx::Bz),
+            Input(*current[0], Idx::Jx), Input(*current[1], Idx::Jy), Input(*current[2], Idx::Jz)};
+        if (rho) {
+            inputs.emplace_back(*rho, Idx::rho_old, 0);
+            inputs.emplace_back(*rho, Idx::rho_new, 1);
+        }
+        solver.ForwardTransform(lev, inputs);
 #endif
         // Advance fields in spectral space
         solver.pushSpectralFields();
         // Perform backward Fourier Transform
 #ifdef WARPX_DIM_RZ
-        solver.BackwardTransform(lev,
-                                 *Efield[0], Idx::Ex,
-                                 *Efield[1], Idx::Ey);
-#else
-        solver.BackwardTransform(lev, *Efield[0], Idx::Ex);
-        solver.BackwardTransform(lev, *Efield[1], Idx::Ey);
-#endif
-        solver.BackwardTransform(lev, *Efield[2], Idx::Ez);
-#ifdef WARPX_DIM_RZ
-        solver.BackwardTransform(lev,
-                                 *Bfield[0], Idx::Bx,
-                                 *Bfield[1], Idx::By);
+        using Output = SpectralFieldDataRZ::BackwardTransformOutput;
+        solver.BackwardTransform(lev, {
+            Output(*Efield[0], Idx::Ex, *Efield[1], Idx::Ey), Output(*Efield[2], Idx::Ez),
+            Output(*Bfield[0], Idx::Bx, *Bfield[1], Idx::By), Output(*Bfield[2], Idx::Bz)});
 #else
-        solver.BackwardTransform(lev, *Bfield[0], Idx::Bx);
-        solver.BackwardTransform(lev, *Bfield[1], Idx::By);
-#endif
-        solver.BackwardTransform(lev, *Bfield[2], Idx::Bz);
-
-#ifndef WARPX_DIM_RZ
+        using Output = SpectralFieldData::BackwardTransformOutput;
+        std::vector<Output> outputs {
+            Output(*Efield[0], Idx::Ex), Output(*Efield[1], Idx::Ey), Output(*Efield[2], Idx::Ez),
+            Output(*Bfield[0], Idx::Bx), Output(*Bfield[1], Idx::By), Output(*Bfield[2], Idx::Bz)};
         if (WarpX::fft_do_time_averaging){
-            solver.BackwardTransform(lev, *Efield_avg[0], Idx::Ex_avg);
-            solver.BackwardTransform(lev, *Efield_avg[1], Idx::Ey_avg);
-            solver.BackwardTransform(lev, *Efield_avg[2], Idx::Ez_avg);
+            outputs.emplace_back(*Efield_avg[0], Idx::Ex_avg);
+            outputs.emplace_back(*Efield_avg[1], Idx::Ey_avg);
+            outputs.emplace_back(*Efield_avg[2], Idx::Ez_avg);
 
-            solver.BackwardTransform(lev, *Bfield_avg[0], Idx::Bx_avg);
-            solver.BackwardTransform(lev, *Bfield_avg[1], Idx::By_avg);
-            solver.BackwardTransform(lev, *Bfield_avg[2], Idx::Bz_avg);
+            outputs.emplace_back(*Bfield_avg[0], Idx::Bx_avg);
+            outputs.emplace_back(*Bfield_avg[1], Idx::By_avg);
+            outputs.emplace_back(*Bfield_avg[2], Idx::Bz_avg);
         }
+        solver.BackwardTransform(lev, outputs);
 #endif
     }
 }
@@ -220,41 +204,42 @@ WarpX::ApplySilverMuellerBoundary (amrex::Real a_dt) {
 }
 
 void
-WarpX::EvolveE (amrex::Real a_dt)
+WarpX::EvolveE (amrex::Real a_dt, FieldUpdateRegion region)
 {
     for (int lev = 0; lev <= finest_level; ++lev)
     {
-        EvolveE(lev, a_dt);
+        EvolveE(lev, a_dt, region);
     }
 }
 
 void
-WarpX::EvolveE (int lev, amrex::Real a_dt)
+WarpX::EvolveE (int lev, amrex::Real a_dt, FieldUpdateRegion region)
 {
     WARPX_PROFILE("WarpX::EvolveE()");
-    EvolveE(lev, PatchType::fine, a_dt);
+    EvolveE(lev, PatchType::fine, a_dt, region);
     if (lev > 0)
     {
-        EvolveE(lev, PatchType::coarse, a_dt);
+        EvolveE(lev, PatchType::coarse, a_dt, region);
     }
 }
 
 void
-WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real a_dt)
+WarpX::EvolveE (int lev, PatchType patch_type, amrex::Real a_dt, FieldUpdateRegion region)
 {
     // Evolve E field in regular cells
     if (patch_type == PatchType::fine) {
         m_fdtd_solver_fp[lev]->EvolveE(Efield_fp[lev], Bfield_fp[lev],
                                        current_fp[lev], m_edge_lengths[lev],
-                                       F_fp[lev], lev, a_dt );
+                                       F_fp[lev], lev, a_dt, region );
     } else {
         m_fdtd_solver_cp[lev]->EvolveE(Efield_cp[lev], Bfield_cp[lev],
                                        current_cp[lev], m_edge_lengths[lev],
-                                       F_cp[lev], lev, a_dt );
+                                       F_cp[lev], lev, a_dt, region );
     }
 
-    // Evolve E field in PML cells
-    if (do_pml && pml[lev]->ok()) {
+    // Evolve E field in PML cells (with the boundary cells of the regular grid,
+    // since the PML fields are exchanged with the guard cells)
+    if (do_pml && pml[lev]->ok() && region != FieldUpdateRegion::Interior) {
         if (patch_type == PatchType::fine) {
             m_fdtd_solver_fp[lev]->EvolveEPML(
                 pml[lev]->GetE_fp(), pml[lev]->GetB_fp(),
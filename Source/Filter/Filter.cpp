@@ -15,6 +15,75 @@
 
 using namespace amrex;
 
+namespace {
+    /* \brief Apply the 1D symmetric stencil s of length len along direction
+     * dir: dst(p) = sum_m s[m]*(src(p-m)+src(p+m)), for all cells p of bx.
+     */
+    void FilterAlongDirection (const Box& bx, int dir,
+                               amrex::Real const* AMREX_RESTRICT s, int len,
+                               Array4<Real const> const& src,
+                               Array4<Real      > const& dst,
+                               int scomp, int dcomp, int ncomp)
+    {
+        const int di = (dir == 0) ? 1 : 0;
+        const int dj = (dir == 1) ? 1 : 0;
+        const int dk = (dir == 2) ? 1 : 0;
+        amrex::ParallelFor(bx, ncomp,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            Real d = 0.0;
+            for (int m = 0; m < len; ++m) {
+                d += s[m]*( src(i-m*di,j-m*dj,k-m*dk,scomp+n)
+                           +src(i+m*di,j+m*dj,k+m*dk,scomp+n));
+            }
+            dst(i,j,k,dcomp+n) = d;
+        });
+    }
+}
+
+/* \brief Apply stencil one direction after the other (2D/3D, CPU/GPU).
+ * The intermediate buffers only cover the tile (grown by the remaining
+ * stencil lengths), so on CPU they stay in cache.
+ */
+void Filter::DoFilterSeparable (const Box& tbx,
+                                Array4<Real const> const& tmp,
+                                Array4<Real      > const& dst,
+                                int scomp, int dcomp, int ncomp)
+{
+    amrex::Real const* AMREX_RESTRICT sx = stencil_x.data();
+    amrex::Real const* AMREX_RESTRICT sz = stencil_z.data();
+#if (AMREX_SPACEDIM == 3)
+    amrex::Real const* AMREX_RESTRICT sy = stencil_y.data();
+
+    // Filter along x, on the tile grown by the y and z stencils
+    const Box& bx_x = amrex::grow(amrex::grow(tbx, 1, slen.y-1), 2, slen.z-1);
+    FArrayBox fab_x(bx_x, ncomp);
+    Elixir eli_x = fab_x.elixir();
+    FilterAlongDirection(bx_x, 0, sx, slen.x, tmp, fab_x.array(), scomp, 0, ncomp);
+
+    // Filter along y, on the tile grown by the z stencil
+    const Box& bx_y = amrex::grow(tbx, 2, slen.z-1);
+    FArrayBox fab_y(bx_y, ncomp);
+    Elixir eli_y = fab_y.elixir();
+    FilterAlongDirection(bx_y, 1, sy, slen.y, fab_x.const_array(), fab_y.array(), 0, 0, ncomp);
+
+    // Filter along z, into dst
+    FilterAlongDirection(tbx, 2, sz, slen.z, fab_y.const_array(), dst, 0, dcomp, ncomp);
+#else
+    // In 2D, the second direction (z) is stored in j, and its stencil
+    // length in slen.y
+
+    // Filter along x, on the tile grown by the z stencil
+    const Box& bx_x = amrex::grow(tbx, 1, slen.y-1);
+    FArrayBox fab_x(bx_x, ncomp);
+    Elixir eli_x = fab_x.elixir();
+    FilterAlongDirection(bx_x, 0, sx, slen.x, tmp, fab_x.array(), scomp, 0, ncomp);
+
+    // Filter along z, into dst
+    FilterAlongDirection(tbx, 1, sz, slen.y, fab_x.const_array(), dst, 0, dcomp, ncomp);
+#endif
+}
+
 #ifdef AMREX_USE_GPU
 
 /* \brief Apply stencil on MultiFab (GPU version, 2D/3D).
@@ -103,6 +172,10 @@ void Filter::DoFilter (const Box& tbx,
                        Array4<Real      > const& dst,
                        int scomp, int dcomp, int ncomp)
 {
+    if (use_separable) {
+        DoFilterSeparable(tbx, tmp, dst, scomp, dcomp, ncomp);
+        return;
+    }
     amrex::Real const* AMREX_RESTRICT sx = stencil_x.data();
 #if (AMREX_SPACEDIM == 3)
     amrex::Real const* AMREX_RESTRICT sy = stencil_y.data();
@@ -222,6 +295,10 @@ void Filter::DoFilter (const Box& tbx,
                        Array4<Real      > const& dst,
                        int scomp, int dcomp, int ncomp)
 {
+    if (use_separable) {
+        DoFilterSeparable(tbx, tmp, dst, scomp, dcomp, ncomp);
+        return;
+    }
     const auto lo = amrex::lbound(tbx);
     const auto hi = amrex::ubound(tbx);
     // tmp and dst are of type Array4 (Fortran ordering)
@@ -22,7 +22,11 @@
 #   include <AMReX_AmrMeshInSituBridge.H>
 #endif
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
+#include <sstream>
 
 using namespace amrex;
 
@@ -120,6 +124,8 @@ WarpX::InitData ()
     // (example: a box with 16 valid cells and 32 guard cells in z will not be considered valid)
     CheckGuardCells();
 
+    CheckParticlePrecision();
+
     if (restart_chkfile.empty())
     {
         multi_diags->FilterComputePackFlush( -1, true );
@@ -303,6 +309,7 @@ WarpX::InitFilter (){
     if (WarpX::use_filter){
         WarpX::bilinear_filter.npass_each_dir = WarpX::filter_npass_each_dir.toArray<unsigned int>();
         WarpX::bilinear_filter.ComputeStencils();
+        WarpX::bilinear_filter.use_separable = WarpX::use_separable_filter;
     }
 }
 
@@ -637,6 +644,46 @@ WarpX::PerformanceHints ()
     // TODO: CPU tiling hints with OpenMP
 }
 
+void
+WarpX::CheckParticlePrecision () const
+{
+    const Real eps = std::numeric_limits<ParticleReal>::epsilon();
+
+    // Distance travelled by the moving window, if the end of the simulation is known
+    Real window_travel = 0._rt;
+    if (do_moving_window) {
+        Real t_end = stop_time;
+        if (max_step < std::numeric_limits<int>::max()) t_end = std::min(t_end, max_step*dt[0]);
+        if (t_end < std::numeric_limits<Real>::max()) window_travel = std::abs(moving_window_v)*t_end;
+    }
+
+    for (int lev = 0; lev <= finest_level; ++lev) {
+        for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+            Real xmax = std::max(std::abs(Geom(lev).ProbLo(idim)), std::abs(Geom(lev).ProbHi(idim)));
+            if (do_moving_window && idim == moving_window_dir) xmax += window_travel;
+            // Spacing of the representable positions, in number of cells
+            const Real resolution = xmax*eps/Geom(lev).CellSize(idim);
+            if (resolution < 1.e-3_rt) continue;
+
+            std::stringstream msg;
+            msg << "The particle positions are stored in absolute coordinates with "
+                << sizeof(ParticleReal)*8 << "-bit floating point numbers: at "
+                << xmax << " m from the origin in direction " << idim
+                << " on level " << lev << ", they are resolved to " << resolution
+                << " cell.";
+            // Only builds with particles in lower precision than the fields are
+            // stopped, so that existing all-single-precision runs are unchanged
+            if (sizeof(ParticleReal) < sizeof(Real)) {
+                WarpXUtilMsg::AlwaysAssert(resolution < 0.1_rt,
+                    msg.str() + " Use double precision particles (WarpX_PARTICLE_PRECISION=DOUBLE)"
+                    " or a domain closer to the origin.");
+            }
+            amrex::Print() << "\n[Warning] [Precision] " << msg.str()
+                           << " Consider using double precision particles.\n";
+        }
+    }
+}
+
 void WarpX::CheckGuardCells()
 {
     for (int lev = 0; lev <= finest_level; ++lev)
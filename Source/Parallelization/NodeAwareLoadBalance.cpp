@@ -0,0 +1,221 @@
+/* This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "NodeAwareLoadBalance.H"
+
+#include <AMReX_ParallelContext.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_ParallelReduce.H>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+using namespace amrex;
+
+namespace
+{
+    /** Whether the most significant bit of x is lower than that of y */
+    bool LessMsb (unsigned int x, unsigned int y)
+    {
+        return x < y && x < (x ^ y);
+    }
+
+    /** Order of the boxes of ba along a Morton space-filling curve */
+    Vector<int> MortonOrder (const BoxArray& ba)
+    {
+        const IntVect domain_lo = ba.minimalBox().smallEnd();
+        Vector<int> order(ba.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+            [&] (int a, int b) {
+                const IntVect ia = ba[a].smallEnd() - domain_lo;
+                const IntVect ib = ba[b].smallEnd() - domain_lo;
+                // compare along the dimension with the highest differing bit
+                int msd = AMREX_SPACEDIM-1;
+                for (int d = AMREX_SPACEDIM-2; d >= 0; --d) {
+                    if (LessMsb(static_cast<unsigned int>(ia[msd] ^ ib[msd]),
+                                static_cast<unsigned int>(ia[d] ^ ib[d]))) {
+                        msd = d;
+                    }
+                }
+                if (ia[msd] != ib[msd]) return ia[msd] < ib[msd];
+                return a < b;
+            });
+        return order;
+    }
+
+    /**
+     * Split boxes (in the given order) in contiguous chunks whose costs are
+     * proportional to fractions; returns the chunk of each box of the list
+     */
+    Vector<int> SplitContiguous (const Vector<int>& boxes, const Vector<Real>& cost,
+                                 const Vector<Real>& fractions)
+    {
+        Real total = 0.;
+        for (int i : boxes) total += cost[i];
+        const Real fractions_sum = std::accumulate(fractions.begin(), fractions.end(), Real(0.));
+
+        Vector<int> chunk(boxes.size());
+        int k = 0;
+        Real boundary = total*fractions[0]/fractions_sum;
+        Real cumulative = 0.;
+        for (std::size_t n = 0; n < boxes.size(); ++n)
+        {
+            // a box goes to the chunk that contains its middle
+            const Real middle = cumulative + 0.5*cost[boxes[n]];
+            while (middle > boundary && k+1 < static_cast<int>(fractions.size())) {
+                ++k;
+                boundary += total*fractions[k]/fractions_sum;
+            }
+            chunk[n] = k;
+            cumulative += cost[boxes[n]];
+        }
+        return chunk;
+    }
+
+    /** Mean over max cost per rank */
+    Real Efficiency (const Vector<Real>& cost, const Vector<int>& pmap, int nprocs)
+    {
+        Vector<Real> rank_cost(nprocs, 0.);
+        for (int i = 0; i < static_cast<int>(cost.size()); ++i) {
+            rank_cost[pmap[i]] += cost[i];
+        }
+        const Real max_cost = *std::max_element(rank_cost.begin(), rank_cost.end());
+        const Real mean_cost = std::accumulate(rank_cost.begin(), rank_cost.end(), Real(0.))/nprocs;
+        return (max_cost > 0.) ? mean_cost/max_cost : Real(1.);
+    }
+}
+
+const Vector<int>&
+NodeOfRanks ()
+{
+    static Vector<int> node_of_rank;
+    const int nprocs = ParallelContext::NProcsSub();
+    if (static_cast<int>(node_of_rank.size()) == nprocs) return node_of_rank;
+
+    node_of_rank.assign(nprocs, 0);
+#ifdef AMREX_USE_MPI
+    // each node is identified by its first rank
+    MPI_Comm comm = ParallelContext::CommunicatorSub();
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, ParallelContext::MyProcSub(),
+                        MPI_INFO_NULL, &node_comm);
+    int first_rank = ParallelContext::MyProcSub();
+    MPI_Bcast(&first_rank, 1, MPI_INT, 0, node_comm);
+    MPI_Comm_free(&node_comm);
+
+    Vector<int> first_rank_of(nprocs);
+    MPI_Allgather(&first_rank, 1, MPI_INT, first_rank_of.data(), 1, MPI_INT, comm);
+
+    int nnodes = 0;
+    for (int r = 0; r < nprocs; ++r) {
+        // the first rank of a node comes before the other ranks of the node
+        node_of_rank[r] = (first_rank_of[r] == r) ? nnodes++ : node_of_rank[first_rank_of[r]];
+    }
+#endif
+    return node_of_rank;
+}
+
+DistributionMapping
+MakeNodeAwareDistributionMapping (const LayoutData<Real>& costs,
+                                  bool intra_node_sfc, int nmax,
+                                  Real& currentEfficiency,
+                                  Real& proposedEfficiency)
+{
+    const BoxArray& ba = costs.boxArray();
+    const int nboxes = ba.size();
+    const int nprocs = ParallelContext::NProcsSub();
+    const int myproc = ParallelContext::MyProcSub();
+    const Vector<int>& node_of_rank = NodeOfRanks();
+    // nodes are numbered by their first rank, so the last rank is not always on the last node
+    const int nnodes = node_of_rank.empty() ? 1
+        : *std::max_element(node_of_rank.begin(), node_of_rank.end()) + 1;
+
+    // costs of all the boxes, on all ranks
+    Vector<Real> cost(nboxes, 0.);
+    for (int i : costs.IndexArray()) cost[i] = costs[i];
+    ParallelAllReduce::Sum(cost.data(), nboxes, ParallelContext::CommunicatorSub());
+
+    // ranks of each node
+    Vector<Vector<int>> node_ranks(nnodes);
+    for (int r = 0; r < nprocs; ++r) node_ranks[node_of_rank[r]].push_back(r);
+
+    // level 1: contiguous chunks of the space-filling curve between the nodes,
+    // with costs proportional to the number of ranks of the nodes
+    const Vector<int> sfc_order = MortonOrder(ba);
+    Vector<Real> node_fractions(nnodes);
+    for (int n = 0; n < nnodes; ++n) node_fractions[n] = node_ranks[n].size();
+    const Vector<int> node_of_box_in_order = SplitContiguous(sfc_order, cost, node_fractions);
+
+    // level 2: the first rank of each node distributes the boxes of its node
+    const int mynode = node_of_rank[myproc];
+    Vector<int> pmap(nboxes, 0);
+    if (node_ranks[mynode][0] == myproc)
+    {
+        Vector<int> boxes; // in the order of the curve
+        for (int n = 0; n < nboxes; ++n) {
+            if (node_of_box_in_order[n] == mynode) boxes.push_back(sfc_order[n]);
+        }
+        const Vector<int>& ranks = node_ranks[mynode];
+        const int nranks = ranks.size();
+
+        if (intra_node_sfc)
+        {
+            const Vector<int> chunk = SplitContiguous(boxes, cost, Vector<Real>(nranks, 1.));
+            for (std::size_t n = 0; n < boxes.size(); ++n) pmap[boxes[n]] = ranks[chunk[n]];
+        } else
+        {
+            // largest boxes first, to the least loaded rank with less than nmax boxes
+            std::stable_sort(boxes.begin(), boxes.end(),
+                             [&] (int a, int b) { return cost[a] > cost[b]; });
+            Vector<Real> rank_cost(nranks, 0.);
+            Vector<int> rank_nboxes(nranks, 0);
+            for (int i : boxes)
+            {
+                int best = -1;
+                for (int k = 0; k < nranks; ++k) {
+                    if (rank_nboxes[k] < nmax && (best < 0 || rank_cost[k] < rank_cost[best])) best = k;
+                }
+                if (best < 0) {
+                    best = static_cast<int>(std::min_element(rank_cost.begin(), rank_cost.end())
+                                            - rank_cost.begin());
+                }
+                rank_cost[best] += cost[i];
+                ++rank_nboxes[best];
+                pmap[i] = ranks[best];
+            }
+        }
+    }
+    // each box is set by exactly one rank
+    ParallelAllReduce::Sum(pmap.data(), nboxes, ParallelContext::CommunicatorSub());
+
+    currentEfficiency = Efficiency(cost, costs.DistributionMap().ProcessorMap(), nprocs);
+    proposedEfficiency = Efficiency(cost, pmap, nprocs);
+
+    return DistributionMapping(pmap);
+}
+
+Long
+InterNodeGuardCells (const BoxArray& ba, const DistributionMapping& dm, const IntVect& ng)
+{
+    const Vector<int>& node_of_rank = NodeOfRanks();
+    const int nprocs = ParallelContext::NProcsSub();
+    const int myproc = ParallelContext::MyProcSub();
+
+    Long ncells = 0;
+    // the boxes are split between the ranks in a round-robin way
+    for (int i = myproc; i < static_cast<int>(ba.size()); i += nprocs)
+    {
+        const int node_i = node_of_rank[dm[i]];
+        for (const auto& isect : ba.intersections(amrex::grow(ba[i], ng)))
+        {
+            if (isect.first != i && node_of_rank[dm[isect.first]] != node_i) {
+                ncells += isect.second.numPts();
+            }
+        }
+    }
+    ParallelAllReduce::Sum(ncells, ParallelContext::CommunicatorSub());
+    return ncells;
+}
@@ -485,124 +485,190 @@ WarpX::FillBoundaryE_avg (IntVect ng)
 
 
 void
-WarpX::FillBoundaryE(int lev, IntVect ng)
+WarpX::FillBoundaryE (int lev, IntVect ng)
 {
+    amrex::LayoutData<KernelCounterArray>* counters = getKernelCounters(lev);
+    const KernelTimer t_kernel = StartKernelTimer(counters);
+
     FillBoundaryE(lev, PatchType::fine, ng);
     if (lev > 0) FillBoundaryE(lev, PatchType::coarse, ng);
+
+    RecordKernelCounterAllBoxes(counters, KernelCounter::FillBoundary, t_kernel,
+                                { Efield_fp[lev][0].get(), Efield_fp[lev][1].get(),
+                                  Efield_fp[lev][2].get() }, ng);
 }
 
 void
 WarpX::FillBoundaryE (int lev, PatchType patch_type, IntVect ng)
 {
-    if (patch_type == PatchType::fine)
+    FillBoundaryE_nowait(lev, patch_type, ng);
+    FillBoundaryE_finish(lev, patch_type);
+}
+
+void
+WarpX::FillBoundaryE_nowait (IntVect ng)
+{
+    for (int lev = 0; lev <= finest_level; ++lev)
     {
-        if (do_pml && pml[lev]->ok())
-        {
-            pml[lev]->ExchangeE(patch_type,
-                                { Efield_fp[lev][0].get(),
-                                  Efield_fp[lev][1].get(),
-                                  Efield_fp[lev][2].get() },
-                                do_pml_in_domain);
-            pml[lev]->FillBoundaryE(patch_type);
-        }
+        amrex::LayoutData<KernelCounterArray>* counters = getKernelCounters(lev);
+        const KernelTimer t_kernel = StartKernelTimer(counters);
 
-        const auto& period = Geom(lev).periodicity();
-        if ( safe_guard_cells ){
-            Vector<MultiFab*> mf{Efield_fp[lev][0].get(),Efield_fp[lev][1].get(),Efield_fp[lev][2].get()};
-            amrex::FillBoundary(mf, period);
-        } else {
-            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
-                ng <= Efield_fp[lev][0]->nGrowVect(),
-                "Error: in FillBoundaryE, requested more guard cells than allocated");
-            Efield_fp[lev][0]->FillBoundary(ng, period);
-            Efield_fp[lev][1]->FillBoundary(ng, period);
-            Efield_fp[lev][2]->FillBoundary(ng, period);
-        }
+        FillBoundaryE_nowait(lev, PatchType::fine, ng);
+        if (lev > 0) FillBoundaryE_nowait(lev, PatchType::coarse, ng);
+
+        RecordKernelCounterAllBoxes(counters, KernelCounter::FillBoundary, t_kernel,
+                                    { Efield_fp[lev][0].get(), Efield_fp[lev][1].get(),
+                                      Efield_fp[lev][2].get() }, ng);
     }
-    else if (patch_type == PatchType::coarse)
+}
+
+void
+WarpX::FillBoundaryE_finish ()
+{
+    for (int lev = 0; lev <= finest_level; ++lev)
     {
-        if (do_pml && pml[lev]->ok())
-        {
-            pml[lev]->ExchangeE(patch_type,
-                                { Efield_cp[lev][0].get(),
-                                  Efield_cp[lev][1].get(),
-                                  Efield_cp[lev][2].get() },
-                                do_pml_in_domain);
-            pml[lev]->FillBoundaryE(patch_type);
-        }
-        const auto& cperiod = Geom(lev-1).periodicity();
-        if ( safe_guard_cells ) {
-            Vector<MultiFab*> mf{Efield_cp[lev][0].get(),Efield_cp[lev][1].get(),Efield_cp[lev][2].get()};
-            amrex::FillBoundary(mf, cperiod);
+        // only the time spent waiting for the communication is counted here
+        amrex::LayoutData<KernelCounterArray>* counters = getKernelCounters(lev);
+        const KernelTimer t_kernel = StartKernelTimer(counters);
 
-        } else {
-            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
-                ng <= Efield_cp[lev][0]->nGrowVect(),
-                "Error: in FillBoundaryE, requested more guard cells than allocated");
-            Efield_cp[lev][0]->FillBoundary(ng, cperiod);
-            Efield_cp[lev][1]->FillBoundary(ng, cperiod);
-            Efield_cp[lev][2]->FillBoundary(ng, cperiod);
+        FillBoundaryE_finish(lev, PatchType::fine);
+        if (lev > 0) FillBoundaryE_finish(lev, PatchType::coarse);
+
+        RecordKernelCounterAllBoxes(counters, KernelCounter::FillBoundary, t_kernel);
+    }
+}
+
+void
+WarpX::FillBoundaryE_nowait (int lev, PatchType patch_type, IntVect ng)
+{
+    const auto& Efield = (patch_type == PatchType::fine) ? Efield_fp[lev] : Efield_cp[lev];
+
+    if (do_pml && pml[lev]->ok())
+    {
+        pml[lev]->ExchangeE(patch_type,
+                            { Efield[0].get(), Efield[1].get(), Efield[2].get() },
+                            do_pml_in_domain);
+        pml[lev]->FillBoundaryE(patch_type);
+    }
+
+    const auto& period = (patch_type == PatchType::fine) ? Geom(lev).periodicity()
+                                                         : Geom(lev-1).periodicity();
+    if ( safe_guard_cells ){
+        // all the guard cells are exchanged at once, without overlap
+        Vector<MultiFab*> mf{Efield[0].get(),Efield[1].get(),Efield[2].get()};
+        amrex::FillBoundary(mf, period);
+    } else {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+            ng <= Efield[0]->nGrowVect(),
+            "Error: in FillBoundaryE, requested more guard cells than allocated");
+        for (int i = 0; i < 3; ++i) {
+            Efield[i]->FillBoundary_nowait(0, Efield[i]->nComp(), ng, period);
         }
     }
 }
 
+void
+WarpX::FillBoundaryE_finish (int lev, PatchType patch_type)
+{
+    if ( safe_guard_cells ) return;
+
+    const auto& Efield = (patch_type == PatchType::fine) ? Efield_fp[lev] : Efield_cp[lev];
+    for (int i = 0; i < 3; ++i) {
+        Efield[i]->FillBoundary_finish();
+    }
+}
+
 void
 WarpX::FillBoundaryB (int lev, IntVect ng)
 {
+    amrex::LayoutData<KernelCounterArray>* counters = getKernelCounters(lev);
+    const KernelTimer t_kernel = StartKernelTimer(counters);
+
     FillBoundaryB(lev, PatchType::fine, ng);
     if (lev > 0) FillBoundaryB(lev, PatchType::coarse, ng);
+
+    RecordKernelCounterAllBoxes(counters, KernelCounter::FillBoundary, t_kernel,
+                                { Bfield_fp[lev][0].get(), Bfield_fp[lev][1].get(),
+                                  Bfield_fp[lev][2].get() }, ng);
 }
 
 void
 WarpX::FillBoundaryB (int lev, PatchType patch_type, IntVect ng)
 {
-    if (patch_type == PatchType::fine)
+    FillBoundaryB_nowait(lev, patch_type, ng);
+    FillBoundaryB_finish(lev, patch_type);
+}
+
+void
+WarpX::FillBoundaryB_nowait (IntVect ng)
+{
+    for (int lev = 0; lev <= finest_level; ++lev)
     {
-        if (do_pml && pml[lev]->ok())
-        {
-            pml[lev]->ExchangeB(patch_type,
-                            { Bfield_fp[lev][0].get(),
-                              Bfield_fp[lev][1].get(),
-                              Bfield_fp[lev][2].get() },
-                              do_pml_in_domain);
-        pml[lev]->FillBoundaryB(patch_type);
-        }
-        const auto& period = Geom(lev).periodicity();
-        if ( safe_guard_cells ) {
-            Vector<MultiFab*> mf{Bfield_fp[lev][0].get(),Bfield_fp[lev][1].get(),Bfield_fp[lev][2].get()};
-            amrex::FillBoundary(mf, period);
-        } else {
-            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
-                ng <= Bfield_fp[lev][0]->nGrowVect(),
-                "Error: in FillBoundaryB, requested more guard cells than allocated");
-            Bfield_fp[lev][0]->FillBoundary(ng, period);
-            Bfield_fp[lev][1]->FillBoundary(ng, period);
-            Bfield_fp[lev][2]->FillBoundary(ng, period);
-        }
+        amrex::LayoutData<KernelCounterArray>* counters = getKernelCounters(lev);
+        const KernelTimer t_kernel = StartKernelTimer(counters);
+
+        FillBoundaryB_nowait(lev, PatchType::fine, ng);
+        if (lev > 0) FillBoundaryB_nowait(lev, PatchType::coarse, ng);
+
+        RecordKernelCounterAllBoxes(counters, KernelCounter::FillBoundary, t_kernel,
+                                    { Bfield_fp[lev][0].get(), Bfield_fp[lev][1].get(),
+                                      Bfield_fp[lev][2].get() }, ng);
     }
-    else if (patch_type == PatchType::coarse)
+}
+
+void
+WarpX::FillBoundaryB_finish ()
+{
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        // only the time spent waiting for the communication is counted here
+        amrex::LayoutData<KernelCounterArray>* counters = getKernelCounters(lev);
+        const KernelTimer t_kernel = StartKernelTimer(counters);
+
+        FillBoundaryB_finish(lev, PatchType::fine);
+        if (lev > 0) FillBoundaryB_finish(lev, PatchType::coarse);
+
+        RecordKernelCounterAllBoxes(counters, KernelCounter::FillBoundary, t_kernel);
+    }
+}
+
+void
+WarpX::FillBoundaryB_nowait (int lev, PatchType patch_type, IntVect ng)
+{
+    const auto& Bfield = (patch_type == PatchType::fine) ? Bfield_fp[lev] : Bfield_cp[lev];
+
+    if (do_pml && pml[lev]->ok())
     {
-        if (do_pml && pml[lev]->ok())
-        {
         pml[lev]->ExchangeB(patch_type,
-                      { Bfield_cp[lev][0].get(),
-                        Bfield_cp[lev][1].get(),
-                        Bfield_cp[lev][2].get() },
-                        do_pml_in_domain);
+                            { Bfield[0].get(), Bfield[1].get(), Bfield[2].get() },
+                            do_pml_in_domain);
         pml[lev]->FillBoundaryB(patch_type);
+    }
+
+    const auto& period = (patch_type == PatchType::fine) ? Geom(lev).periodicity()
+                                                         : Geom(lev-1).periodicity();
+    if ( safe_guard_cells ){
+        // all the guard cells are exchanged at once, without overlap
+        Vector<MultiFab*> mf{Bfield[0].get(),Bfield[1].get(),Bfield[2].get()};
+        amrex::FillBoundary(mf, period);
+    } else {
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+            ng <= Bfield[0]->nGrowVect(),
+            "Error: in FillBoundaryB, requested more guard cells than allocated");
+        for (int i = 0; i < 3; ++i) {
+            Bfield[i]->FillBoundary_nowait(0, Bfield[i]->nComp(), ng, period);
         }
-        const auto& cperiod = Geom(lev-1).periodicity();
-        if ( safe_guard_cells ){
-            Vector<MultiFab*> mf{Bfield_cp[lev][0].get(),Bfield_cp[lev][1].get(),Bfield_cp[lev][2].get()};
-            amrex::FillBoundary(mf, cperiod);
-        } else {
-            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
-                ng <= Bfield_cp[lev][0]->nGrowVect(),
-                "Error: in FillBoundaryB, requested more guard cells than allocated");
-            Bfield_cp[lev][0]->FillBoundary(ng, cperiod);
-            Bfield_cp[lev][1]->FillBoundary(ng, cperiod);
-            Bfield_cp[lev][2]->FillBoundary(ng, cperiod);
-        }
+    }
+}
+
+void
+WarpX::FillBoundaryB_finish (int lev, PatchType patch_type)
+{
+    if ( safe_guard_cells ) return;
+
+    const auto& Bfield = (patch_type == PatchType::fine) ? Bfield_fp[lev] : Bfield_cp[lev];
+    for (int i = 0; i < 3; ++i) {
+        Bfield[i]->FillBoundary_finish();
     }
 }
 
@@ -823,6 +889,9 @@ WarpX::FillBoundaryAux (IntVect ng)
 void
 WarpX::FillBoundaryAux (int lev, IntVect ng)
 {
+    amrex::LayoutData<KernelCounterArray>* counters = getKernelCounters(lev);
+    const KernelTimer t_kernel = StartKernelTimer(counters);
+
     const auto& period = Geom(lev).periodicity();
     Efield_aux[lev][0]->FillBoundary(ng, period);
     Efield_aux[lev][1]->FillBoundary(ng, period);
@@ -830,6 +899,11 @@ WarpX::FillBoundaryAux (int lev, IntVect ng)
     Bfield_aux[lev][0]->FillBoundary(ng, period);
     Bfield_aux[lev][1]->FillBoundary(ng, period);
     Bfield_aux[lev][2]->FillBoundary(ng, period);
+
+    RecordKernelCounterAllBoxes(counters, KernelCounter::FillBoundary, t_kernel,
+                                { Efield_aux[lev][0].get(), Efield_aux[lev][1].get(),
+                                  Efield_aux[lev][2].get(), Bfield_aux[lev][0].get(),
+                                  Bfield_aux[lev][1].get(), Bfield_aux[lev][2].get() }, ng);
 }
 
 void
@@ -7,6 +7,7 @@
  * License: BSD-3-Clause-LBNL
  */
 #include "WarpX.H"
+#include "NodeAwareLoadBalance.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 
 #include <AMReX_BLProfiler.H>
@@ -16,6 +17,30 @@
 
 using namespace amrex;
 
+namespace
+{
+    /** Sum of the kernel counters of all the boxes of this rank, on levels 0 to finest_level */
+    KernelCounterArray
+    SumLocalKernelCounters (int finest_level)
+    {
+        FlushKernelTimers();
+        KernelCounterArray sums{};
+        for (int lev = 0; lev <= finest_level; ++lev)
+        {
+            const LayoutData<KernelCounterArray>* counters = WarpX::getKernelCounters(lev);
+            if (!counters) continue;
+            for (int i : counters->IndexArray())
+            {
+                for (std::size_t k = 0; k < sums.size(); ++k)
+                {
+                    sums[k] += (*counters)[i][k];
+                }
+            }
+        }
+        return sums;
+    }
+}
+
 void
 WarpX::LoadBalance ()
 {
@@ -50,45 +75,75 @@ WarpX::LoadBalance ()
         amrex::Real currentEfficiency = 0.0;
         amrex::Real proposedEfficiency = 0.0;
 
-        newdm = (load_balance_with_sfc)
-            ? DistributionMapping::makeSFC(*costs[lev],
-                                           currentEfficiency, proposedEfficiency,
-                                           false,
-                                           ParallelDescriptor::IOProcessorNumber())
-            : DistributionMapping::makeKnapSack(*costs[lev],
-                                                currentEfficiency, proposedEfficiency,
-                                                nmax,
-                                                false,
-                                                ParallelDescriptor::IOProcessorNumber());
-        // As specified in the above calls to makeSFC and makeKnapSack, the new
-        // distribution mapping is NOT communicated to all ranks; the loadbalanced
-        // dm is up-to-date only on root, and we can decide whether to broadcast
-        if ((load_balance_efficiency_ratio_threshold > 0.0)
-            && (ParallelDescriptor::MyProc() == ParallelDescriptor::IOProcessorNumber()))
+        if (load_balance_node_aware)
         {
-            doLoadBalance = (proposedEfficiency > load_balance_efficiency_ratio_threshold*currentEfficiency);
-        }
+            // The new distribution mapping is computed in parallel and known on all ranks
+            newdm = MakeNodeAwareDistributionMapping(*costs[lev], load_balance_with_sfc, nmax,
+                                                     currentEfficiency, proposedEfficiency);
+            doLoadBalance = (load_balance_efficiency_ratio_threshold > 0.0)
+                && (proposedEfficiency > load_balance_efficiency_ratio_threshold*currentEfficiency);
 
-        ParallelDescriptor::Bcast(&doLoadBalance, 1,
-                                  ParallelDescriptor::IOProcessorNumber());
-
-        if (doLoadBalance)
-        {
-            Vector<int> pmap;
-            if (ParallelDescriptor::MyProc() == ParallelDescriptor::IOProcessorNumber())
+            if (verbose)
             {
-                pmap = newdm.ProcessorMap();
-            } else
+                // E and B guard cells exchanged between nodes at each FillBoundary
+                const IntVect& ng = Efield_fp[lev][0]->nGrowVect();
+                const Long bytes_per_cell = 6*sizeof(Real);
+                const Long current_bytes
+                    = bytes_per_cell*InterNodeGuardCells(costs[lev]->boxArray(),
+                                                         costs[lev]->DistributionMap(), ng);
+                const Long proposed_bytes
+                    = bytes_per_cell*InterNodeGuardCells(costs[lev]->boxArray(), newdm, ng);
+                amrex::Print() << "Load balance on level " << lev
+                               << ": efficiency " << currentEfficiency
+                               << " (current), " << proposedEfficiency << " (proposed); "
+                               << "inter-node E and B guard cell data " << current_bytes
+                               << " B (current), " << proposed_bytes << " B (proposed)\n";
+            }
+        } else
+        {
+            newdm = (load_balance_with_sfc)
+                ? DistributionMapping::makeSFC(*costs[lev],
+                                               currentEfficiency, proposedEfficiency,
+                                               false,
+                                               ParallelDescriptor::IOProcessorNumber())
+                : DistributionMapping::makeKnapSack(*costs[lev],
+                                                    currentEfficiency, proposedEfficiency,
+                                                    nmax,
+                                                    false,
+                                                    ParallelDescriptor::IOProcessorNumber());
+            // As specified in the above calls to makeSFC and makeKnapSack, the new
+            // distribution mapping is NOT communicated to all ranks; the loadbalanced
+            // dm is up-to-date only on root, and we can decide whether to broadcast
+            if ((load_balance_efficiency_ratio_threshold > 0.0)
+                && (ParallelDescriptor::MyProc() == ParallelDescriptor::IOProcessorNumber()))
             {
-                pmap.resize(static_cast<std::size_t>(nboxes));
+                doLoadBalance = (proposedEfficiency > load_balance_efficiency_ratio_threshold*currentEfficiency);
             }
-            ParallelDescriptor::Bcast(&pmap[0], pmap.size(), ParallelDescriptor::IOProcessorNumber());
 
-            if (ParallelDescriptor::MyProc() != ParallelDescriptor::IOProcessorNumber())
+            ParallelDescriptor::Bcast(&doLoadBalance, 1,
+                                      ParallelDescriptor::IOProcessorNumber());
+
+            if (doLoadBalance)
             {
-                newdm = DistributionMapping(pmap);
+                Vector<int> pmap;
+                if (ParallelDescriptor::MyProc() == ParallelDescriptor::IOProcessorNumber())
+                {
+                    pmap = newdm.ProcessorMap();
+                } else
+                {
+                    pmap.resize(static_cast<std::size_t>(nboxes));
+                }
+                ParallelDescriptor::Bcast(&pmap[0], pmap.size(), ParallelDescriptor::IOProcessorNumber());
+
+                if (ParallelDescriptor::MyProc() != ParallelDescriptor::IOProcessorNumber())
+                {
+                    newdm = DistributionMapping(pmap);
+                }
             }
+        }
 
+        if (doLoadBalance)
+        {
             RemakeLevel(lev, t_new[lev], boxArray(lev), newdm);
 
             // Record the load balance efficiency
@@ -113,6 +168,9 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
     {
         if (ParallelDescriptor::NProcs() == 1) return;
 
+        // The cached cell binning of the particles is indexed by tile
+        mypc->ClearCellBins(lev);
+
 #ifdef AMREX_USE_EB
         m_field_factory[lev] = amrex::makeEBFabFactory(Geom(lev), ba, dm,
                                                        {1,1,1}, // Not clear how many ghost cells we need yet
@@ -376,6 +434,17 @@ WarpX::RemakeLevel (int lev, Real /*time*/, const BoxArray& ba, const Distributi
             }
         }
 
+        // the counters accumulated since the last output are dropped
+        if (kernel_counters[lev] != nullptr)
+        {
+            FlushKernelTimers();
+            kernel_counters[lev] = std::make_unique<LayoutData<KernelCounterArray>>(ba, dm);
+            for (int i : kernel_counters[lev]->IndexArray())
+            {
+                (*kernel_counters[lev])[i].fill(0.0);
+            }
+        }
+
         SetDistributionMap(lev, dm);
 
     } else
@@ -416,6 +485,85 @@ WarpX::ComputeCostsHeuristic (amrex::Vector<std::unique_ptr<amrex::LayoutData<am
     }
 }
 
+void
+WarpX::CalibrateCostsHeuristicBeginStep ()
+{
+    if (costs_calibration_nsteps_done >= costs_heuristic_calibration_steps) return;
+
+    // The counters may have been reset since the end of the last step
+    // (by load balancing or by the KernelCounters reduced diagnostics)
+    costs_calibration_start = SumLocalKernelCounters(finest_level);
+}
+
+void
+WarpX::CalibrateCostsHeuristicEndStep ()
+{
+    if (costs_calibration_nsteps_done >= costs_heuristic_calibration_steps) return;
+
+    const KernelCounterArray step_end = SumLocalKernelCounters(finest_level);
+    for (std::size_t k = 0; k < step_end.size(); ++k)
+    {
+        costs_calibration_sums[k] += step_end[k] - costs_calibration_start[k];
+    }
+    // Same cell count as in ComputeCostsHeuristic
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        for (MFIter mfi(*Efield_fp[lev][0], false); mfi.isValid(); ++mfi)
+        {
+            costs_calibration_ncells += mfi.growntilebox().numPts();
+        }
+    }
+
+    ++costs_calibration_nsteps_done;
+    if (costs_calibration_nsteps_done < costs_heuristic_calibration_steps) return;
+
+    // Time spent in particle kernels (the collisions and ionization are attributed
+    // to the pushed particles), and in field kernels
+    auto time_of = [this] (int kernel) {
+        return costs_calibration_sums[kernel*KernelCounter::nquantities + KernelCounter::time];
+    };
+    Real sums[4] = {
+        time_of(KernelCounter::GatherPush) + time_of(KernelCounter::CurrentDeposition)
+        + time_of(KernelCounter::ChargeDeposition) + time_of(KernelCounter::Collisions)
+        + time_of(KernelCounter::Ionization),
+        costs_calibration_sums[KernelCounter::GatherPush*KernelCounter::nquantities
+                               + KernelCounter::particles],
+        time_of(KernelCounter::FieldSolve) + time_of(KernelCounter::FillBoundary),
+        costs_calibration_ncells
+    };
+    ParallelDescriptor::ReduceRealSum(sums, 4);
+    const Real time_particles = sums[0];
+    const Real nparticles = sums[1];
+    const Real time_cells = sums[2];
+    const Real ncells = sums[3];
+
+    if (time_particles > 0. && nparticles > 0. && time_cells > 0. && ncells > 0.)
+    {
+        // Normalized like the default weights
+        const Real particles_wt = time_particles/nparticles;
+        const Real cells_wt = time_cells/ncells;
+        costs_heuristic_particles_wt = particles_wt/(particles_wt + cells_wt);
+        costs_heuristic_cells_wt = cells_wt/(particles_wt + cells_wt);
+        if (verbose) {
+            amrex::Print() << "Heuristic costs calibrated over "
+                           << costs_heuristic_calibration_steps << " steps: "
+                           << "costs_heuristic_particles_wt = " << costs_heuristic_particles_wt
+                           << ", costs_heuristic_cells_wt = " << costs_heuristic_cells_wt << "\n";
+        }
+    } else {
+        amrex::Warning("Heuristic costs calibration: no particle or cell kernel was timed;"
+                       " the weights are not modified");
+    }
+
+    // Stop recording the counters, unless they are output by a reduced diagnostic
+    if (costs_calibration_owns_counters)
+    {
+        do_kernel_counters = false;
+        FlushKernelTimers();
+        for (auto& counters : kernel_counters) counters.reset();
+    }
+}
+
 void
 WarpX::ResetCosts ()
 {
@@ -175,3 +175,18 @@ WarpXParser::symbols () const
 #endif
     return results;
 }
+
+struct wp_bc_program*
+WarpXParser::compile (int nvars) const
+{
+#ifdef AMREX_USE_OMP
+    std::vector<std::string> const& varnames = m_varnames[0];
+    struct wp_parser* parser = m_parser[0];
+#else
+    std::vector<std::string> const& varnames = m_varnames;
+    struct wp_parser* parser = m_parser;
+#endif
+    if (nvars > static_cast<int>(varnames.size())) return nullptr;
+    std::vector<std::string> names(varnames.begin(), varnames.begin()+nvars);
+    return wp_bc_compile(parser->ast, names);
+}
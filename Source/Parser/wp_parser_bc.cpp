@@ -0,0 +1,305 @@
+#include "wp_parser_bc.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <tuple>
+
+namespace {
+
+/* Pseudo instruction for the values of the variables.  They live in
+ * registers [0,n_vars) and are never emitted. */
+constexpr int WP_BC_VAR = 0;
+
+/* One value of the program in SSA form, before register allocation.
+ * Operands a and b are indices of other values. */
+struct wp_bc_value {
+    int op;
+    int ftype;
+    int a;
+    int b;
+    amrex_real c;
+};
+
+struct wp_bc_builder {
+    std::vector<std::string> const* varnames;
+    std::vector<wp_bc_value> values;
+    std::map<std::tuple<int,int,int,int,unsigned long long>,int> cse;
+};
+
+unsigned long long
+wp_bc_bits (amrex_real c)
+{
+    unsigned long long r = 0;
+    std::memcpy(&r, &c, sizeof(amrex_real));
+    return r;
+}
+
+/* Add a value unless an identical one already exists. */
+int
+wp_bc_add (wp_bc_builder& bld, int op, int ftype, int a, int b, amrex_real c)
+{
+    if ((op == WP_BC_ADD || op == WP_BC_MUL) && a > b) std::swap(a,b);
+    auto key = std::make_tuple(op, ftype, a, b, wp_bc_bits(c));
+    auto found = bld.cse.find(key);
+    if (found != bld.cse.end()) return found->second;
+    const int id = static_cast<int>(bld.values.size());
+    bld.values.push_back(wp_bc_value{op, ftype, a, b, c});
+    bld.cse.emplace(key, id);
+    return id;
+}
+
+int
+wp_bc_const (wp_bc_builder& bld, amrex_real c)
+{
+    return wp_bc_add(bld, WP_BC_CONST, 0, -1, -1, c);
+}
+
+bool
+wp_bc_is_const (wp_bc_builder const& bld, int v)
+{
+    return bld.values[v].op == WP_BC_CONST;
+}
+
+int
+wp_bc_symbol (wp_bc_builder& bld, struct wp_node* node)
+{
+    char const* name = ((struct wp_symbol*)node)->name;
+    auto const& varnames = *bld.varnames;
+    for (int i = 0; i < static_cast<int>(varnames.size()); ++i) {
+        if (varnames[i] == name) return wp_bc_add(bld, WP_BC_VAR, 0, i, -1, 0.0);
+    }
+    return -1;
+}
+
+/* Binary operation with constant folding and the exact algebraic
+ * simplifications (x*1, x/1, x-0).  Operations with one constant
+ * operand use the immediate forms. */
+int
+wp_bc_binary (wp_bc_builder& bld, enum wp_node_t type, int a, int b)
+{
+    if (a < 0 || b < 0) return -1;
+    const bool ca = wp_bc_is_const(bld, a);
+    const bool cb = wp_bc_is_const(bld, b);
+    const amrex_real va = bld.values[a].c;
+    const amrex_real vb = bld.values[b].c;
+    switch (type)
+    {
+    case WP_ADD:
+        if (ca && cb) return wp_bc_const(bld, va + vb);
+        if (ca) return wp_bc_add(bld, WP_BC_ADD_C, 0, b, -1, va);
+        if (cb) return wp_bc_add(bld, WP_BC_ADD_C, 0, a, -1, vb);
+        return wp_bc_add(bld, WP_BC_ADD, 0, a, b, 0.0);
+    case WP_SUB:
+        if (ca && cb) return wp_bc_const(bld, va - vb);
+        if (cb && vb == amrex_real(0.0)) return a;
+        if (ca) return wp_bc_add(bld, WP_BC_SUB_C, 0, b, -1, va);
+        if (cb) return wp_bc_add(bld, WP_BC_ADD_C, 0, a, -1, -vb);
+        return wp_bc_add(bld, WP_BC_SUB, 0, a, b, 0.0);
+    case WP_MUL:
+        if (ca && cb) return wp_bc_const(bld, va * vb);
+        if (ca && va == amrex_real(1.0)) return b;
+        if (cb && vb == amrex_real(1.0)) return a;
+        if (ca) return wp_bc_add(bld, WP_BC_MUL_C, 0, b, -1, va);
+        if (cb) return wp_bc_add(bld, WP_BC_MUL_C, 0, a, -1, vb);
+        return wp_bc_add(bld, WP_BC_MUL, 0, a, b, 0.0);
+    case WP_DIV:
+        if (ca && cb) return wp_bc_const(bld, va / vb);
+        if (cb && vb == amrex_real(1.0)) return a;
+        if (ca) return wp_bc_add(bld, WP_BC_DIV_C, 0, b, -1, va);
+        if (cb) return wp_bc_add(bld, WP_BC_DIV_RC, 0, a, -1, vb);
+        return wp_bc_add(bld, WP_BC_DIV, 0, a, b, 0.0);
+    default:
+        return -1;
+    }
+}
+
+int
+wp_bc_neg (wp_bc_builder& bld, int a)
+{
+    if (a < 0) return -1;
+    if (wp_bc_is_const(bld, a)) return wp_bc_const(bld, -bld.values[a].c);
+    if (bld.values[a].op == WP_BC_NEG) return bld.values[a].a;
+    return wp_bc_add(bld, WP_BC_NEG, 0, a, -1, 0.0);
+}
+
+int
+wp_bc_build (wp_bc_builder& bld, struct wp_node* node)
+{
+    switch (node->type)
+    {
+    case WP_NUMBER:
+        return wp_bc_const(bld, ((struct wp_number*)node)->value);
+    case WP_SYMBOL:
+        return wp_bc_symbol(bld, node);
+    case WP_ADD:
+    case WP_SUB:
+    case WP_MUL:
+    case WP_DIV:
+    {
+        int a = wp_bc_build(bld, node->l);
+        int b = wp_bc_build(bld, node->r);
+        return wp_bc_binary(bld, node->type, a, b);
+    }
+    case WP_NEG:
+        return wp_bc_neg(bld, wp_bc_build(bld, node->l));
+    case WP_F1:
+    {
+        auto f1 = (struct wp_f1*)node;
+        int a = wp_bc_build(bld, f1->l);
+        if (a < 0) return -1;
+        if (wp_bc_is_const(bld, a)) {
+            return wp_bc_const(bld, wp_call_f1(f1->ftype, bld.values[a].c));
+        }
+        if (f1->ftype == WP_POW_P1) return a;
+        return wp_bc_add(bld, WP_BC_F1, f1->ftype, a, -1, 0.0);
+    }
+    case WP_F2:
+    {
+        auto f2 = (struct wp_f2*)node;
+        int a = wp_bc_build(bld, f2->l);
+        int b = wp_bc_build(bld, f2->r);
+        if (a < 0 || b < 0) return -1;
+        if (wp_bc_is_const(bld, a) && wp_bc_is_const(bld, b)) {
+            return wp_bc_const(bld, wp_call_f2(f2->ftype, bld.values[a].c,
+                                                          bld.values[b].c));
+        }
+        return wp_bc_add(bld, WP_BC_F2, f2->ftype, a, b, 0.0);
+    }
+    case WP_ADD_VP:
+        return wp_bc_binary(bld, WP_ADD, wp_bc_const(bld, node->lvp.v), wp_bc_symbol(bld, node->r));
+    case WP_SUB_VP:
+        return wp_bc_binary(bld, WP_SUB, wp_bc_const(bld, node->lvp.v), wp_bc_symbol(bld, node->r));
+    case WP_MUL_VP:
+        return wp_bc_binary(bld, WP_MUL, wp_bc_const(bld, node->lvp.v), wp_bc_symbol(bld, node->r));
+    case WP_DIV_VP:
+        return wp_bc_binary(bld, WP_DIV, wp_bc_const(bld, node->lvp.v), wp_bc_symbol(bld, node->r));
+    case WP_ADD_PP:
+        return wp_bc_binary(bld, WP_ADD, wp_bc_symbol(bld, node->l), wp_bc_symbol(bld, node->r));
+    case WP_SUB_PP:
+        return wp_bc_binary(bld, WP_SUB, wp_bc_symbol(bld, node->l), wp_bc_symbol(bld, node->r));
+    case WP_MUL_PP:
+        return wp_bc_binary(bld, WP_MUL, wp_bc_symbol(bld, node->l), wp_bc_symbol(bld, node->r));
+    case WP_DIV_PP:
+        return wp_bc_binary(bld, WP_DIV, wp_bc_symbol(bld, node->l), wp_bc_symbol(bld, node->r));
+    case WP_NEG_P:
+        return wp_bc_neg(bld, wp_bc_symbol(bld, node->l));
+    default:
+        amrex::Abort("wp_bc_build: unknown node type " + std::to_string(node->type));
+        return -1;
+    }
+}
+
+/* Number of register operands of an instruction */
+int
+wp_bc_noperands (int op)
+{
+    switch (op)
+    {
+    case WP_BC_VAR:
+    case WP_BC_CONST:
+        return 0;
+    case WP_BC_ADD:
+    case WP_BC_SUB:
+    case WP_BC_MUL:
+    case WP_BC_DIV:
+    case WP_BC_F2:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+}
+
+struct wp_bc_program*
+wp_bc_compile (struct wp_node* ast, std::vector<std::string> const& varnames)
+{
+    wp_bc_builder bld;
+    bld.varnames = &varnames;
+    const int n_vars = static_cast<int>(varnames.size());
+
+    int root = wp_bc_build(bld, ast);
+    if (root < 0) return nullptr;
+
+    // The result must be computed into a temporary register.
+    if (bld.values[root].op == WP_BC_VAR) {
+        bld.values.push_back(wp_bc_value{WP_BC_MOV, 0, root, -1, 0.0});
+        root = static_cast<int>(bld.values.size()) - 1;
+    }
+
+    // Dead code elimination and liveness.  Values are in topological
+    // order, so one backward sweep is enough.
+    const int n_values = static_cast<int>(bld.values.size());
+    std::vector<int> last_use(n_values, -1);
+    std::vector<char> live(n_values, 0);
+    live[root] = 1;
+    for (int v = n_values-1; v >= 0; --v) {
+        if (!live[v]) continue;
+        auto const& val = bld.values[v];
+        const int nops = wp_bc_noperands(val.op);
+        if (nops >= 1) {
+            live[val.a] = 1;
+            last_use[val.a] = std::max(last_use[val.a], v);
+        }
+        if (nops >= 2) {
+            live[val.b] = 1;
+            last_use[val.b] = std::max(last_use[val.b], v);
+        }
+    }
+
+    // Linear register allocation.  Operands are read before the
+    // destination is written, so the register of an operand that dies
+    // at an instruction can be reused for its result.
+    std::vector<int> reg(n_values, -1);
+    std::vector<int> free_regs;
+    int n_regs = n_vars;
+    std::vector<struct wp_bc_instr> instr;
+    for (int v = 0; v < n_values; ++v) {
+        if (!live[v]) continue;
+        auto const& val = bld.values[v];
+        if (val.op == WP_BC_VAR) {
+            reg[v] = val.a;
+            continue;
+        }
+        const int nops = wp_bc_noperands(val.op);
+        if (nops >= 1 && last_use[val.a] == v && reg[val.a] >= n_vars) {
+            free_regs.push_back(reg[val.a]);
+        }
+        if (nops >= 2 && val.b != val.a && last_use[val.b] == v && reg[val.b] >= n_vars) {
+            free_regs.push_back(reg[val.b]);
+        }
+        if (free_regs.empty()) {
+            reg[v] = n_regs++;
+        } else {
+            auto it = std::min_element(free_regs.begin(), free_regs.end());
+            reg[v] = *it;
+            free_regs.erase(it);
+        }
+        instr.push_back(wp_bc_instr{val.op, val.ftype, reg[v],
+                                    (nops >= 1) ? reg[val.a] : -1,
+                                    (nops >= 2) ? reg[val.b] : -1,
+                                    val.c});
+    }
+
+    if (n_regs > WARPX_PARSER_BC_MAX_REGS) return nullptr;
+
+    const size_t sz_program = sizeof(struct wp_bc_program)
+        + instr.size()*sizeof(struct wp_bc_instr);
+    auto program = (struct wp_bc_program*) std::malloc(sz_program);
+    program->n_instr = static_cast<int>(instr.size());
+    program->n_vars = n_vars;
+    program->n_regs = n_regs;
+    program->result = reg[root];
+    program->sz_program = sz_program;
+    std::memcpy((void*)wp_bc_instructions(program), instr.data(),
+                instr.size()*sizeof(struct wp_bc_instr));
+    return program;
+}
+
+void
+wp_bc_program_delete (struct wp_bc_program* program)
+{
+    std::free(program);
+}
@@ -0,0 +1,151 @@
+#ifndef WP_PARSER_BC_H_
+#define WP_PARSER_BC_H_
+
+#include "wp_parser_y.h"
+
+#include <AMReX_GpuQualifiers.H>
+#include <AMReX_GpuPrint.H>
+#include <AMReX_Extension.H>
+#include <AMReX_Math.H>
+#include <AMReX_REAL.H>
+#include <AMReX_Print.H>
+#include <AMReX.H>
+
+#include <string>
+#include <vector>
+
+/* Maximum number of registers (variables + temporaries) of a compiled
+ * program.  Expressions that need more registers are not compiled and
+ * are evaluated by walking the AST instead.
+ */
+#ifndef WARPX_PARSER_BC_MAX_REGS
+#define WARPX_PARSER_BC_MAX_REGS 32
+#endif
+
+enum wp_bc_op_t {  // Instructions of the compiled parser program
+    WP_BC_MOV = 1,   // r[dst] = r[a]
+    WP_BC_CONST,     // r[dst] = c
+    WP_BC_ADD,       // r[dst] = r[a] + r[b]
+    WP_BC_SUB,       // r[dst] = r[a] - r[b]
+    WP_BC_MUL,       // r[dst] = r[a] * r[b]
+    WP_BC_DIV,       // r[dst] = r[a] / r[b]
+    WP_BC_ADD_C,     // r[dst] = c + r[a]
+    WP_BC_SUB_C,     // r[dst] = c - r[a]
+    WP_BC_MUL_C,     // r[dst] = c * r[a]
+    WP_BC_DIV_C,     // r[dst] = c / r[a]
+    WP_BC_DIV_RC,    // r[dst] = r[a] / c
+    WP_BC_NEG,       // r[dst] = -r[a]
+    WP_BC_F1,        // r[dst] = f1(r[a])
+    WP_BC_F2         // r[dst] = f2(r[a], r[b])
+};
+
+struct wp_bc_instr {
+    int op;          // enum wp_bc_op_t
+    int ftype;       // enum wp_f1_t or wp_f2_t for WP_BC_F1 and WP_BC_F2
+    int dst;
+    int a;
+    int b;
+    amrex_real c;    // immediate operand
+};
+
+/* A compiled parser program.  It is stored in one contiguous chunk of
+ * memory of size sz_program: this header is directly followed by
+ * n_instr instructions.  Registers [0,n_vars) hold the variables passed
+ * to wp_bc_eval, the other registers hold temporaries.  Because the
+ * program does not contain any pointer, it can be copied to device
+ * memory as is.
+ */
+struct wp_bc_program {
+    int n_instr;
+    int n_vars;
+    int n_regs;
+    int result;
+    size_t sz_program;
+};
+
+/* Compile the optimized AST into a register-based program with constant
+ * folding and common-subexpression elimination.  Symbol varnames[i] is
+ * mapped to x[i] of wp_bc_eval.  Returns nullptr if the AST contains
+ * symbols that are not in varnames or if the program needs more than
+ * WARPX_PARSER_BC_MAX_REGS registers.
+ */
+struct wp_bc_program* wp_bc_compile (struct wp_node* ast,
+                                     std::vector<std::string> const& varnames);
+void wp_bc_program_delete (struct wp_bc_program* program);
+
+AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+struct wp_bc_instr const*
+wp_bc_instructions (struct wp_bc_program const* program)
+{
+    return reinterpret_cast<struct wp_bc_instr const*>(program+1);
+}
+
+AMREX_GPU_HOST_DEVICE
+#ifdef AMREX_USE_GPU
+AMREX_NO_INLINE
+#endif
+inline
+amrex::Real
+wp_bc_eval (struct wp_bc_program const* program, amrex::Real const* x)
+{
+    amrex::Real r[WARPX_PARSER_BC_MAX_REGS];
+    const int n_vars = program->n_vars;
+    for (int i = 0; i < n_vars; ++i) {
+        r[i] = x[i];
+    }
+
+    struct wp_bc_instr const* instr = wp_bc_instructions(program);
+    const int n_instr = program->n_instr;
+    for (int n = 0; n < n_instr; ++n)
+    {
+        struct wp_bc_instr const& in = instr[n];
+        switch (in.op)
+        {
+        case WP_BC_MOV:    r[in.dst] = r[in.a];              break;
+        case WP_BC_CONST:  r[in.dst] = in.c;                 break;
+        case WP_BC_ADD:    r[in.dst] = r[in.a] + r[in.b];    break;
+        case WP_BC_SUB:    r[in.dst] = r[in.a] - r[in.b];    break;
+        case WP_BC_MUL:    r[in.dst] = r[in.a] * r[in.b];    break;
+        case WP_BC_DIV:    r[in.dst] = r[in.a] / r[in.b];    break;
+        case WP_BC_ADD_C:  r[in.dst] = in.c + r[in.a];       break;
+        case WP_BC_SUB_C:  r[in.dst] = in.c - r[in.a];       break;
+        case WP_BC_MUL_C:  r[in.dst] = in.c * r[in.a];       break;
+        case WP_BC_DIV_C:  r[in.dst] = in.c / r[in.a];       break;
+        case WP_BC_DIV_RC: r[in.dst] = r[in.a] / in.c;       break;
+        case WP_BC_NEG:    r[in.dst] = -r[in.a];             break;
+        case WP_BC_F1:
+            r[in.dst] = wp_call_f1(static_cast<enum wp_f1_t>(in.ftype), r[in.a]);
+            break;
+        case WP_BC_F2:
+            r[in.dst] = wp_call_f2(static_cast<enum wp_f2_t>(in.ftype), r[in.a], r[in.b]);
+            break;
+        default:
+#if AMREX_DEVICE_COMPILE
+            AMREX_DEVICE_PRINTF("wp_bc_eval: unknown instruction %d\n", in.op);
+            amrex::Abort();
+#else
+            amrex::Abort("wp_bc_eval: unknown instruction " + std::to_string(in.op));
+#endif
+            break;
+        }
+    }
+
+    amrex::Real result = r[program->result];
+
+    // check for NaN & Infs, same as wp_ast_eval
+    if (!amrex::Math::isfinite(result))
+    {
+        constexpr char const * const err_msg =
+            "wp_bc_eval: function parser encountered an invalid result value (NaN or Inf)!";
+#if AMREX_DEVICE_COMPILE
+        AMREX_DEVICE_PRINTF("%s\n", err_msg);
+#else
+        amrex::AllPrint() << err_msg << "\n";
+#endif
+        amrex::Abort(err_msg);
+    }
+
+    return result;
+}
+
+#endif
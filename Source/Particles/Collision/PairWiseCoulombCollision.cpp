@@ -50,6 +50,7 @@ PairWiseCoulombCollision::doCollisions (amrex::Real cur_time, MultiParticleConta
     for (int lev = 0; lev <= species1.finestLevel(); ++lev){
 
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+    amrex::LayoutData<KernelCounterArray>* counters = WarpX::getKernelCounters(lev);
 
         // Loop over all grids/tiles at this level
 #ifdef AMREX_USE_OMP
@@ -62,9 +63,20 @@ PairWiseCoulombCollision::doCollisions (amrex::Real cur_time, MultiParticleConta
                 amrex::Gpu::synchronize();
             }
             amrex::Real wt = amrex::second();
+            const KernelTimer t_kernel = StartKernelTimer(counters);
 
             doCoulombCollisionsWithinTile( lev, mfi, species1, species2 );
 
+            if (counters)
+            {
+                const auto np1 = species1.ParticlesAt(lev, mfi).numParticles();
+                const auto np2 = (&species1 == &species2) ? 0 :
+                    species2.ParticlesAt(lev, mfi).numParticles();
+                RecordKernelCounter(counters, mfi.index(), KernelCounter::Collisions, t_kernel,
+                                    np1 + np2, ParticleDataBytes(species1, np1)
+                                               + ParticleDataBytes(species2, np2));
+            }
+
             if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
             {
                 amrex::Gpu::synchronize();
@@ -107,7 +119,8 @@ void PairWiseCoulombCollision::doCoulombCollisionsWithinTile
         ParticleTileType& ptile_1 = species_1.ParticlesAt(lev, mfi);
 
         // Find the particles that are in each cell of this tile
-        ParticleBins bins_1 = findParticlesInEachCell( lev, mfi, ptile_1 );
+        // (cached, shared with the other collisions and resampling)
+        ParticleBins& bins_1 = species_1.GetCellBins( lev, mfi );
 
         // Loop over cells, and collide the particles in each cell
 
@@ -181,8 +194,9 @@ void PairWiseCoulombCollision::doCoulombCollisionsWithinTile
         ParticleTileType& ptile_2 = species_2.ParticlesAt(lev, mfi);
 
         // Find the particles that are in each cell of this tile
-        ParticleBins bins_1 = findParticlesInEachCell( lev, mfi, ptile_1 );
-        ParticleBins bins_2 = findParticlesInEachCell( lev, mfi, ptile_2 );
+        // (cached, shared with the other collisions and resampling)
+        ParticleBins& bins_1 = species_1.GetCellBins( lev, mfi );
+        ParticleBins& bins_2 = species_2.GetCellBins( lev, mfi );
 
         // Loop over cells, and collide the particles in each cell
 
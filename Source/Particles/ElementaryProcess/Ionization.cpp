@@ -9,6 +9,10 @@
 #include "WarpX.H"
 #include "Particles/ElementaryProcess/Ionization.H"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 IonizationFilterFunc::IonizationFilterFunc (const WarpXParIter& a_pti, int lev, amrex::IntVect ngE,
                                             amrex::FArrayBox const& exfab,
                                             amrex::FArrayBox const& eyfab,
@@ -23,6 +27,8 @@ IonizationFilterFunc::IonizationFilterFunc (const WarpXParIter& a_pti, int lev,
                                             const amrex::Real* const AMREX_RESTRICT a_adk_power,
                                             int a_comp,
                                             int a_atomic_number,
+                                            ADKTable a_adk_table,
+                                            amrex::GpuArray<amrex::ParticleReal*, 6> a_gathered_fields,
                                             int a_offset) noexcept
 {
     m_ionization_energies = a_ionization_energies;
@@ -31,6 +37,8 @@ IonizationFilterFunc::IonizationFilterFunc (const WarpXParIter& a_pti, int lev,
     m_adk_power = a_adk_power;
     comp = a_comp;
     m_atomic_number = a_atomic_number;
+    m_adk_table = a_adk_table;
+    m_gathered_fields = a_gathered_fields;
 
     m_get_position  = GetParticlePosition(a_pti, a_offset);
     m_get_externalE = GetExternalEField  (a_pti, a_offset);
@@ -70,3 +78,74 @@ IonizationFilterFunc::IonizationFilterFunc (const WarpXParIter& a_pti, int lev,
 
     m_lo = amrex::lbound(box);
 }
+
+amrex::Real
+BuildADKTable (const amrex::Vector<amrex::Real>& adk_prefactor,
+               const amrex::Vector<amrex::Real>& adk_exp_prefactor,
+               const amrex::Vector<amrex::Real>& adk_power,
+               amrex::Real tolerance,
+               amrex::Vector<amrex::Real>& table,
+               ADKTable& adk_table)
+{
+    const int nlevels = adk_prefactor.size();
+
+    // ionization probability per time step below which ionization is neglected
+    constexpr double w_min = 1.e-20;
+    constexpr int max_npoints = 1024;
+
+    // w_dtau, for gamma = 1 (evaluated with logarithms to avoid overflows)
+    auto w_dtau = [&] (int lev, double E) -> double {
+        if (E <= 0.) return 0.;
+        return std::exp( std::log(static_cast<double>(adk_prefactor[lev]))
+                         + adk_power[lev]*std::log(E) + adk_exp_prefactor[lev]/E );
+    };
+    auto probability = [] (double w) -> double { return -std::expm1(-w); };
+
+    // Range of octaves: from the field where the probability becomes non-negligible
+    // to above the field where it is maximum (adk_exp_prefactor/adk_power)
+    int kmin = std::numeric_limits<int>::max();
+    int kmax = std::numeric_limits<int>::lowest();
+    for (int lev = 0; lev < nlevels; ++lev) {
+        const double E_peak = static_cast<double>(adk_exp_prefactor[lev])/adk_power[lev];
+        const int k_hi = static_cast<int>(std::ceil(std::log2(E_peak))) + 1;
+        int k_lo = 0;
+        while (k_lo < k_hi && w_dtau(lev, std::ldexp(1., k_lo+1)) < w_min) ++k_lo;
+        kmin = std::min(kmin, k_lo);
+        kmax = std::max(kmax, k_hi);
+    }
+
+    adk_table.m_kmin = kmin;
+    adk_table.m_noctaves = kmax - kmin;
+
+    double max_error = 0.;
+    for (int npoints = 16; npoints <= max_npoints; npoints *= 2)
+    {
+        adk_table.m_npoints = npoints;
+        const int nnodes = adk_table.m_noctaves*npoints + 1;
+        table.resize(nlevels*nnodes);
+
+        auto node = [&] (int j) -> double {
+            return std::ldexp(1. + static_cast<double>(j%npoints)/npoints, kmin + j/npoints);
+        };
+
+        max_error = 0.;
+        for (int lev = 0; lev < nlevels; ++lev) {
+            amrex::Real* AMREX_RESTRICT w = table.dataPtr() + lev*nnodes;
+            for (int j = 0; j < nnodes; ++j) {
+                w[j] = static_cast<amrex::Real>(w_dtau(lev, node(j)));
+            }
+            // below the table, the probability is set to 0
+            max_error = std::max(max_error, probability(w_dtau(lev, std::ldexp(1., kmin))));
+            // error at the middle of each interval, where it is the largest
+            for (int j = 0; j < nnodes-1; ++j) {
+                const double E_mid = 0.5*(node(j) + node(j+1));
+                const double w_mid = 0.5*(static_cast<double>(w[j]) + w[j+1]);
+                max_error = std::max(max_error,
+                    std::abs(probability(w_mid) - probability(w_dtau(lev, E_mid))));
+            }
+        }
+        if (max_error <= tolerance) break;
+    }
+
+    return static_cast<amrex::Real>(max_error);
+}
@@ -343,6 +343,7 @@ MultiParticleContainer::Evolve (int lev,
     for (auto& pc : allcontainers) {
         pc->Evolve(lev, Ex, Ey, Ez, Bx, By, Bz, jx, jy, jz, cjx, cjy, cjz,
                    rho, crho, cEx, cEy, cEz, cBx, cBy, cBz, t, dt, a_dt_type, skip_deposition);
+        pc->InvalidateCellBins();
     }
 }
 
@@ -351,6 +352,7 @@ MultiParticleContainer::PushX (Real dt)
 {
     for (auto& pc : allcontainers) {
         pc->PushX(dt);
+        pc->InvalidateCellBins();
     }
 }
 
@@ -407,6 +409,7 @@ MultiParticleContainer::SortParticlesByBin (amrex::IntVect bin_size)
 {
     for (auto& pc : allcontainers) {
         pc->SortParticlesByBin(bin_size);
+        pc->InvalidateCellBins();
     }
 }
 
@@ -415,6 +418,15 @@ MultiParticleContainer::Redistribute ()
 {
     for (auto& pc : allcontainers) {
         pc->Redistribute();
+        pc->InvalidateCellBins();
+    }
+}
+
+void
+MultiParticleContainer::ClearCellBins (int lev)
+{
+    for (auto& pc : allcontainers) {
+        pc->ClearCellBins(lev);
     }
 }
 
@@ -431,6 +443,7 @@ MultiParticleContainer::RedistributeLocal (const int num_ghost)
 {
     for (auto& pc : allcontainers) {
         pc->Redistribute(0, 0, 0, num_ghost);
+        pc->InvalidateCellBins();
     }
 }
 
@@ -439,6 +452,7 @@ MultiParticleContainer::ApplyBoundaryConditions ()
 {
     for (auto& pc : allcontainers) {
         pc->ApplyBoundaryConditions(m_boundary_conditions);
+        pc->InvalidateCellBins();
     }
 }
 
@@ -696,6 +710,7 @@ MultiParticleContainer::doFieldIonization (int lev,
     WARPX_PROFILE("MultiParticleContainer::doFieldIonization()");
 
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+    amrex::LayoutData<KernelCounterArray>* counters = WarpX::getKernelCounters(lev);
 
     // Loop over all species.
     // Ionized particles in pc_source create particles in pc_product
@@ -726,6 +741,7 @@ MultiParticleContainer::doFieldIonization (int lev,
                 amrex::Gpu::synchronize();
             }
             Real wt = amrex::second();
+            const KernelTimer t_kernel = StartKernelTimer(counters);
 
             auto& src_tile = pc_source ->ParticlesAt(lev, pti);
             auto& dst_tile = pc_product->ParticlesAt(lev, pti);
@@ -740,6 +756,11 @@ MultiParticleContainer::doFieldIonization (int lev,
 
             setNewParticleIDs(dst_tile, np_dst, num_added);
 
+            const auto np_src = src_tile.numParticles();
+            RecordKernelCounter(counters, pti.index(), KernelCounter::Ionization, t_kernel,
+                                np_src, ParticleDataBytes(*pc_source, np_src)
+                                        + ParticleDataBytes(*pc_product, num_added));
+
             if (cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::Timers)
             {
                 amrex::Gpu::synchronize();
@@ -765,6 +786,7 @@ void MultiParticleContainer::doResampling (const int timestep)
         if (!pc->do_resampling){ continue; }
 
         pc->resample(timestep);
+        pc->InvalidateCellBins();
     }
 }
 
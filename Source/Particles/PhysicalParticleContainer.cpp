@@ -17,6 +17,8 @@
 #include "Python/WarpXWrappers.h"
 #include "Utils/IonizationEnergiesTable.H"
 #include "Particles/Gather/FieldGather.H"
+#include "Particles/Deposition/ChargeDeposition.H"
+#include "Particles/Deposition/CurrentDeposition.H"
 #include "Particles/Pusher/GetAndSetPosition.H"
 #include "Particles/Pusher/CopyParticleAttribs.H"
 #include "Particles/Pusher/PushSelector.H"
@@ -35,6 +37,7 @@
 #include <limits>
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 using namespace amrex;
 
@@ -88,6 +91,79 @@ namespace
 #endif
         return pos;
     }
+
+    /** No deposition after the push (PushPX) */
+    struct NoDeposition
+    {
+        AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+        void operator() (long /*ip*/, ParticleReal /*xp_old*/, ParticleReal /*yp_old*/,
+                         ParticleReal /*zp_old*/) const noexcept {}
+    };
+
+    /** Direct deposition of the current of one particle after its push */
+    template <int depos_order>
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    void DepositCurrentAfterPush (DirectCurrentDepositor<depos_order> const& deposit,
+                                  ParticleReal /*xp_old*/, ParticleReal /*yp_old*/,
+                                  ParticleReal /*zp_old*/, ParticleReal xp, ParticleReal yp,
+                                  ParticleReal zp, ParticleReal ux, ParticleReal uy,
+                                  ParticleReal uz, Real wq) noexcept
+    {
+        deposit(xp, yp, zp, ux, uy, uz, wq);
+    }
+
+    /** Esirkepov deposition of the current of one particle after its push,
+     *  from its position before the push */
+    template <int depos_order>
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    void DepositCurrentAfterPush (EsirkepovDepositor<depos_order> const& deposit,
+                                  ParticleReal xp_old, ParticleReal yp_old,
+                                  ParticleReal zp_old, ParticleReal xp, ParticleReal yp,
+                                  ParticleReal zp, ParticleReal ux, ParticleReal uy,
+                                  ParticleReal uz, Real wq) noexcept
+    {
+        deposit(xp_old, yp_old, zp_old, xp, yp, zp, ux, uy, uz, wq);
+    }
+
+    /**
+     * Deposition of the current, and of the charge if m_do_rho, of one particle
+     * after its push (PushPXAndDeposit). The charge of the particle is computed
+     * as in doDepositionShapeN and doChargeDepositionShapeN.
+     * CurrentDepositor is DirectCurrentDepositor or EsirkepovDepositor.
+     */
+    template <int depos_order, bool do_ionization, typename CurrentDepositor>
+    struct FusedDeposition
+    {
+        GetParticlePosition m_get_position;
+        const ParticleReal* m_wp;
+        const ParticleReal* m_ux;
+        const ParticleReal* m_uy;
+        const ParticleReal* m_uz;
+        const int* m_ion_lev;
+        Real m_q;
+        CurrentDepositor m_deposit_current;
+        ChargeDepositor<depos_order> m_deposit_charge;
+        bool m_do_rho;
+
+        AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+        void operator() (long ip, ParticleReal xp_old, ParticleReal yp_old,
+                         ParticleReal zp_old) const noexcept
+        {
+            ParticleReal xp, yp, zp;
+            m_get_position(ip, xp, yp, zp);
+
+            Real wq = m_q*m_wp[ip];
+            if (do_ionization) wq *= m_ion_lev[ip];
+            DepositCurrentAfterPush(m_deposit_current, xp_old, yp_old, zp_old, xp, yp, zp,
+                                    m_ux[ip], m_uy[ip], m_uz[ip], wq);
+
+            if (m_do_rho) {
+                Real wq_rho = m_q*m_wp[ip]*m_deposit_charge.m_invvol;
+                if (do_ionization) wq_rho *= m_ion_lev[ip];
+                m_deposit_charge(xp, yp, zp, wq_rho);
+            }
+        }
+    };
 }
 
 PhysicalParticleContainer::PhysicalParticleContainer (AmrCore* amr_core, int ispecies,
@@ -962,12 +1038,31 @@ PhysicalParticleContainer::Evolve (int lev,
     BL_ASSERT(OnSameGrids(lev,jx));
 
     amrex::LayoutData<amrex::Real>* cost = WarpX::getCosts(lev);
+    amrex::LayoutData<KernelCounterArray>* counters = WarpX::getKernelCounters(lev);
 
     const iMultiFab* current_masks = WarpX::CurrentBufferMasks(lev);
     const iMultiFab* gather_masks = WarpX::GatherBufferMasks(lev);
 
     bool has_buffer = cEx || cjx;
 
+    // Whether the field gather, the push and the deposition of the current (and of the
+    // charge after the push) may be done in one kernel, with PushPXAndDeposit.
+    // The Esirkepov deposition takes the position before the push from the pusher; it is
+    // not fused with subcycling, and with the nodal and Galilean algorithms, for which
+    // DepositCurrent aborts.
+    const bool fuse_esirkepov =
+        WarpX::current_deposition_algo == CurrentDepositionAlgo::Esirkepov &&
+        !WarpX::do_subcycling && !WarpX::do_nodal &&
+        m_v_galilean[0] == 0._rt && m_v_galilean[1] == 0._rt && m_v_galilean[2] == 0._rt;
+    const bool fuse_kernels = WarpX::fuse_particle_kernels && CanFuseParticleKernels() &&
+        !has_buffer && !do_not_push && !do_not_deposit && !skip_deposition &&
+        ((WarpX::current_deposition_algo == CurrentDepositionAlgo::Direct &&
+          !WarpX::use_sorted_cpu_deposition) || fuse_esirkepov) &&
+        !(cost && WarpX::load_balance_costs_update_algo == LoadBalanceCostsUpdateAlgo::GpuClock);
+
+    // Partitioning the particles in buffers reorders them
+    if (has_buffer && !do_not_push) InvalidateGatheredFields();
+
     if (WarpX::do_back_transformed_diagnostics && do_back_transformed_diagnostics)
     {
         for (WarpXParIter pti(*this, lev); pti.isValid(); ++pti)
@@ -1054,8 +1149,10 @@ PhysicalParticleContainer::Evolve (int lev,
             }
 
             const long np_current = (cjx) ? nfine_current : np;
+            const amrex::Long particle_bytes = ParticleDataBytes(*this, np);
 
             if (rho && ! skip_deposition) {
+                const KernelTimer t_kernel = StartKernelTimer(counters);
                 // Deposit charge before particle push, in component 0 of MultiFab rho.
                 int* AMREX_RESTRICT ion_lev;
                 if (do_field_ionization){
@@ -1069,9 +1166,36 @@ PhysicalParticleContainer::Evolve (int lev,
                     DepositCharge(pti, wp, ion_lev, crho, 0, np_current,
                                   np-np_current, thread_num, lev, lev-1);
                 }
+                RecordKernelCounter(counters, pti.index(), KernelCounter::ChargeDeposition,
+                                    t_kernel, np, particle_bytes);
+            }
+
+            // Fused gather, push and deposition. If the particles may leave the
+            // deposition region during the push, fused is false and the separate
+            // kernels below are used.
+            bool fused = false;
+            if (fuse_kernels)
+            {
+                const KernelTimer t_kernel = StartKernelTimer(counters);
+                int* AMREX_RESTRICT ion_lev = nullptr;
+                if (do_field_ionization){
+                    ion_lev = pti.GetiAttribs(particle_icomps["ionization_level"]).dataPtr();
+                }
+                MultiFab* rho_new =
+                    (WarpX::do_electrostatic == ElectrostaticSolverAlgo::None) ? rho : nullptr;
+                fused = PushPXAndDeposit(pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab,
+                                         Ex.nGrowVect(), wp, ion_lev, jx, jy, jz, rho_new,
+                                         thread_num, lev, dt, a_dt_type);
+                // The time of the deposition is included in the GatherPush counter
+                if (fused) {
+                    RecordKernelCounter(counters, pti.index(), KernelCounter::GatherPush,
+                                        t_kernel, np, particle_bytes);
+                } else {
+                    CancelKernelTimer(t_kernel);
+                }
             }
 
-            if (! do_not_push)
+            if (! do_not_push && ! fused)
             {
                 const long np_gather = (cEx) ? nfine_gather : np;
 
@@ -1081,6 +1205,7 @@ PhysicalParticleContainer::Evolve (int lev,
                 // Gather and push for particles not in the buffer
                 //
                 WARPX_PROFILE_VAR_START(blp_fg);
+                KernelTimer t_kernel = StartKernelTimer(counters);
                 PushPX(pti, exfab, eyfab, ezfab,
                        bxfab, byfab, bzfab,
                        Ex.nGrowVect(), e_is_nodal,
@@ -1123,11 +1248,14 @@ PhysicalParticleContainer::Evolve (int lev,
                 }
 
                 WARPX_PROFILE_VAR_STOP(blp_fg);
+                RecordKernelCounter(counters, pti.index(), KernelCounter::GatherPush,
+                                    t_kernel, np, particle_bytes);
 
                 //
                 // Current Deposition
                 //
                 if (! skip_deposition) {
+                    t_kernel = StartKernelTimer(counters);
                     int* AMREX_RESTRICT ion_lev;
                     if (do_field_ionization){
                         ion_lev = pti.GetiAttribs(particle_icomps["ionization_level"]).dataPtr();
@@ -1144,13 +1272,16 @@ PhysicalParticleContainer::Evolve (int lev,
                                        np_current, np-np_current, thread_num,
                                        lev, lev-1, dt, -0.5_rt);  // Deposit current at t_{n+1/2}
                     }
+                    RecordKernelCounter(counters, pti.index(), KernelCounter::CurrentDeposition,
+                                        t_kernel, np, particle_bytes);
                 } // end of "if do_electrostatic == ElectrostaticSolverAlgo::None"
             } // end of "if do_not_push"
 
-            if (rho && ! skip_deposition) {
+            if (rho && ! skip_deposition && ! fused) {
                 // Deposit charge after particle push, in component 1 of MultiFab rho.
                 // (Skipped for electrostatic solver, as this may lead to out-of-bounds)
                 if (WarpX::do_electrostatic == ElectrostaticSolverAlgo::None) {
+                    const KernelTimer t_kernel = StartKernelTimer(counters);
                     int* AMREX_RESTRICT ion_lev;
                     if (do_field_ionization){
                         ion_lev = pti.GetiAttribs(particle_icomps["ionization_level"]).dataPtr();
@@ -1163,6 +1294,8 @@ PhysicalParticleContainer::Evolve (int lev,
                         DepositCharge(pti, wp, ion_lev, crho, 1, np_current,
                                       np-np_current, thread_num, lev, lev-1);
                     }
+                    RecordKernelCounter(counters, pti.index(), KernelCounter::ChargeDeposition,
+                                        t_kernel, np, particle_bytes);
                 }
             }
 
@@ -1754,23 +1887,22 @@ PhysicalParticleContainer::ContinuousInjection (const RealBox& injection_box)
     AddPlasma(lev, injection_box);
 }
 
-/* \brief Perform the field gather and particle push operations in one fused kernel
- *
- */
+template <int depos_order, int galerkin_interpolation, int staggering, int pusher,
+          typename Deposit>
 void
-PhysicalParticleContainer::PushPX (WarpXParIter& pti,
-                                   amrex::FArrayBox const * exfab,
-                                   amrex::FArrayBox const * eyfab,
-                                   amrex::FArrayBox const * ezfab,
-                                   amrex::FArrayBox const * bxfab,
-                                   amrex::FArrayBox const * byfab,
-                                   amrex::FArrayBox const * bzfab,
-                                   const amrex::IntVect ngE, const int /*e_is_nodal*/,
-                                   const long offset,
-                                   const long np_to_push,
-                                   int lev, int gather_lev,
-                                   amrex::Real dt, ScaleFields scaleFields,
-                                   DtType a_dt_type)
+PhysicalParticleContainer::PushPXImpl (WarpXParIter& pti,
+                                       amrex::FArrayBox const * exfab,
+                                       amrex::FArrayBox const * eyfab,
+                                       amrex::FArrayBox const * ezfab,
+                                       amrex::FArrayBox const * bxfab,
+                                       amrex::FArrayBox const * byfab,
+                                       amrex::FArrayBox const * bzfab,
+                                       const amrex::IntVect ngE,
+                                       const long offset,
+                                       const long np_to_push,
+                                       int lev, int gather_lev,
+                                       amrex::Real dt, ScaleFields scaleFields,
+                                       DtType a_dt_type, Deposit const& deposit)
 {
     AMREX_ALWAYS_ASSERT_WITH_MESSAGE((gather_lev==(lev-1)) ||
                                      (gather_lev==(lev  )),
@@ -1812,8 +1944,6 @@ PhysicalParticleContainer::PushPX (WarpXParIter& pti,
 
     const Dim3 lo = lbound(box);
 
-    bool galerkin_interpolation = WarpX::galerkin_interpolation;
-    int nox = WarpX::nox;
     int n_rz_azimuthal_modes = WarpX::n_rz_azimuthal_modes;
 
     amrex::GpuArray<amrex::Real, 3> dx_arr = {dx[0], dx[1], dx[2]};
@@ -1870,6 +2000,14 @@ PhysicalParticleContainer::PushPX (WarpXParIter& pti,
 
     const auto t_do_not_gather = do_not_gather;
 
+    // Fields already gathered at the particle positions (by the ionization module), if any
+    amrex::GpuArray<amrex::ParticleReal const*, 6> gathered_fields = {{nullptr, nullptr, nullptr,
+                                                                       nullptr, nullptr, nullptr}};
+    if (lev == gather_lev && offset == 0 && np_to_push == pti.numParticles() && !do_not_gather) {
+        gathered_fields = UseGatheredFields(lev, pti, *exfab, *bxfab);
+    }
+    const bool use_gathered_fields = (gathered_fields[0] != nullptr);
+
     amrex::ParallelFor( np_to_push, [=] AMREX_GPU_DEVICE (long ip)
     {
         amrex::ParticleReal xp, yp, zp;
@@ -1878,22 +2016,31 @@ PhysicalParticleContainer::PushPX (WarpXParIter& pti,
         amrex::ParticleReal Exp = 0._rt, Eyp = 0._rt, Ezp = 0._rt;
         amrex::ParticleReal Bxp = 0._rt, Byp = 0._rt, Bzp = 0._rt;
 
-        if(!t_do_not_gather){
-            // first gather E and B to the particle positions
-            doGatherShapeN(xp, yp, zp, Exp, Eyp, Ezp, Bxp, Byp, Bzp,
-                           ex_arr, ey_arr, ez_arr, bx_arr, by_arr, bz_arr,
-                           ex_type, ey_type, ez_type, bx_type, by_type, bz_type,
-                           dx_arr, xyzmin_arr, lo, n_rz_azimuthal_modes,
-                           nox, galerkin_interpolation);
+        if (use_gathered_fields) {
+            Exp = gathered_fields[0][ip];
+            Eyp = gathered_fields[1][ip];
+            Ezp = gathered_fields[2][ip];
+            Bxp = gathered_fields[3][ip];
+            Byp = gathered_fields[4][ip];
+            Bzp = gathered_fields[5][ip];
+        } else {
+            if(!t_do_not_gather){
+                // first gather E and B to the particle positions
+                doGatherShapeNStaggered<depos_order, galerkin_interpolation, staggering>(
+                    xp, yp, zp, Exp, Eyp, Ezp, Bxp, Byp, Bzp,
+                    ex_arr, ey_arr, ez_arr, bx_arr, by_arr, bz_arr,
+                    ex_type, ey_type, ez_type, bx_type, by_type, bz_type,
+                    dx_arr, xyzmin_arr, lo, n_rz_azimuthal_modes);
+            }
+            // Externally applied E-field in Cartesian co-ordinates
+            getExternalE(ip, Exp, Eyp, Ezp);
+            // Externally applied B-field in Cartesian co-ordinates
+            getExternalB(ip, Bxp, Byp, Bzp);
         }
-        // Externally applied E-field in Cartesian co-ordinates
-        getExternalE(ip, Exp, Eyp, Ezp);
-        // Externally applied B-field in Cartesian co-ordinates
-        getExternalB(ip, Bxp, Byp, Bzp);
 
         scaleFields(xp, yp, zp, Exp, Eyp, Ezp, Bxp, Byp, Bzp);
 
-        doParticlePush(getPosition, setPosition, copyAttribs, ip,
+        doParticlePush<pusher>(getPosition, setPosition, copyAttribs, ip,
                        ux[ip+offset], uy[ip+offset], uz[ip+offset],
                        Exp, Eyp, Ezp, Bxp, Byp, Bzp,
                        ion_lev ? ion_lev[ip] : 0,
@@ -1912,9 +2059,213 @@ PhysicalParticleContainer::PushPX (WarpXParIter& pti,
         }
 #endif
 
+        // xp, yp and zp are still the positions before the push
+        deposit(ip, xp, yp, zp);
     });
 }
 
+/* \brief Perform the field gather and particle push operations in one fused kernel
+ *
+ */
+void
+PhysicalParticleContainer::PushPX (WarpXParIter& pti,
+                                   amrex::FArrayBox const * exfab,
+                                   amrex::FArrayBox const * eyfab,
+                                   amrex::FArrayBox const * ezfab,
+                                   amrex::FArrayBox const * bxfab,
+                                   amrex::FArrayBox const * byfab,
+                                   amrex::FArrayBox const * bzfab,
+                                   const amrex::IntVect ngE, const int /*e_is_nodal*/,
+                                   const long offset,
+                                   const long np_to_push,
+                                   int lev, int gather_lev,
+                                   amrex::Real dt, ScaleFields scaleFields,
+                                   DtType a_dt_type)
+{
+    const int staggering = GetGatherStaggering(exfab->box().ixType(), eyfab->box().ixType(),
+                                               ezfab->box().ixType(), bxfab->box().ixType(),
+                                               byfab->box().ixType(), bzfab->box().ixType());
+    GatherPushDispatch(WarpX::nox, WarpX::galerkin_interpolation, staggering,
+                       WarpX::particle_pusher_algo, do_classical_radiation_reaction,
+        [&] (auto order, auto galerkin, auto stag, auto pusher) {
+            PushPXImpl<decltype(order)::value, decltype(galerkin)::value,
+                       decltype(stag)::value, decltype(pusher)::value>(
+                pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab, ngE, offset, np_to_push,
+                lev, gather_lev, dt, scaleFields, a_dt_type, NoDeposition{});
+        });
+}
+
+bool
+PhysicalParticleContainer::PushPXAndDeposit (WarpXParIter& pti,
+                                             amrex::FArrayBox const * exfab,
+                                             amrex::FArrayBox const * eyfab,
+                                             amrex::FArrayBox const * ezfab,
+                                             amrex::FArrayBox const * bxfab,
+                                             amrex::FArrayBox const * byfab,
+                                             amrex::FArrayBox const * bzfab,
+                                             const amrex::IntVect ngE,
+                                             RealVector& wp, const int * const ion_lev,
+                                             amrex::MultiFab& jx, amrex::MultiFab& jy,
+                                             amrex::MultiFab& jz, amrex::MultiFab* rho,
+                                             int thread_num, int lev,
+                                             amrex::Real dt, DtType a_dt_type)
+{
+    const long np = pti.numParticles();
+    if (np == 0) return true;
+
+    WarpX& warpx = WarpX::GetInstance();
+    const std::array<Real,3>& dx = WarpX::CellSize(lev);
+
+    // DepositCurrent and DepositCharge check after the push that the particle shapes
+    // fit within the tile (CPU) or guard cells (GPU) used for the deposition. Here, the
+    // same check is done before the push, for the shape of the charge deposition (which
+    // is the largest) and with a margin for the displacement of the particles, which
+    // move by less than c*dt during the push.
+#if   (AMREX_SPACEDIM == 2)
+    const amrex::IntVect shape_extent = amrex::IntVect(static_cast<int>(WarpX::nox/2+1),
+                                                       static_cast<int>(WarpX::noz/2+1));
+    const amrex::IntVect max_displacement = amrex::IntVect(
+        static_cast<int>(std::ceil(PhysConst::c*dt/dx[0])),
+        static_cast<int>(std::ceil(PhysConst::c*dt/dx[2])));
+#elif (AMREX_SPACEDIM == 3)
+    const amrex::IntVect shape_extent = amrex::IntVect(static_cast<int>(WarpX::nox/2+1),
+                                                       static_cast<int>(WarpX::noy/2+1),
+                                                       static_cast<int>(WarpX::noz/2+1));
+    const amrex::IntVect max_displacement = amrex::IntVect(
+        static_cast<int>(std::ceil(PhysConst::c*dt/dx[0])),
+        static_cast<int>(std::ceil(PhysConst::c*dt/dx[1])),
+        static_cast<int>(std::ceil(PhysConst::c*dt/dx[2])));
+#endif
+
+    const amrex::IntVect& ng_J = warpx.get_ng_depos_J();
+    const amrex::IntVect& ng_rho = warpx.get_ng_depos_rho();
+#ifndef AMREX_USE_GPU
+    amrex::IntVect ng_depos = ng_J;
+    if (rho) ng_depos.min(ng_rho);
+#else
+    amrex::IntVect ng_depos = jx.nGrowVect();
+    if (rho) ng_depos.min(rho->nGrowVect());
+#endif
+    const amrex::IntVect range = ng_depos - shape_extent - max_displacement;
+    if (range.min() < 0 || amrex::numParticlesOutOfRange(pti, range) > 0) return false;
+
+    WARPX_PROFILE("PhysicalParticleContainer::PushPXAndDeposit()");
+
+    // Tile boxes where the current and the charge are deposited, as in DepositCurrent
+    // and DepositCharge
+    Box tilebox_J = pti.tilebox();
+    Box tilebox_rho = pti.tilebox();
+#ifndef AMREX_USE_GPU
+    const Box tbx = amrex::grow(amrex::convert(tilebox_J, jx.ixType().toIntVect()), ng_J);
+    const Box tby = amrex::grow(amrex::convert(tilebox_J, jy.ixType().toIntVect()), ng_J);
+    const Box tbz = amrex::grow(amrex::convert(tilebox_J, jz.ixType().toIntVect()), ng_J);
+    Box tb;
+    if (rho) tb = amrex::grow(amrex::convert(tilebox_rho, rho->ixType().toIntVect()), ng_rho);
+#endif
+    tilebox_J.grow(ng_J);
+    tilebox_rho.grow(ng_rho);
+
+    const int nc = WarpX::ncomps;
+#ifdef AMREX_USE_GPU
+    amrex::ignore_unused(thread_num);
+    // GPU, no tiling: deposit directly in the J arrays and in component 1 of rho
+    auto & jx_fab = jx.get(pti);
+    auto & jy_fab = jy.get(pti);
+    auto & jz_fab = jz.get(pti);
+    FArrayBox rho_fab;
+    if (rho) rho_fab = FArrayBox((*rho)[pti], amrex::make_alias, nc, nc);
+#else
+    // CPU, tiling: deposit in local_j<xyz>[thread_num] and local_rho[thread_num]
+    local_jx[thread_num].resize(tbx, jx.nComp());
+    local_jy[thread_num].resize(tby, jy.nComp());
+    local_jz[thread_num].resize(tbz, jz.nComp());
+    local_jx[thread_num].setVal(0.0);
+    local_jy[thread_num].setVal(0.0);
+    local_jz[thread_num].setVal(0.0);
+    auto & jx_fab = local_jx[thread_num];
+    auto & jy_fab = local_jy[thread_num];
+    auto & jz_fab = local_jz[thread_num];
+    if (rho) {
+        local_rho[thread_num].resize(tb, nc);
+        local_rho[thread_num].setVal(0.0);
+    }
+    auto & rho_fab = local_rho[thread_num];
+#endif
+
+    // Lower corners of the tile boxes (take into account Galilean shift):
+    // J is deposited at t_{n+1/2} and rho at t_{n+1}
+    const Real cur_time = warpx.gett_new(lev);
+    const auto& time_of_last_gal_shift = warpx.time_of_last_gal_shift;
+    const Real time_shift_J = (cur_time + 0.5*dt - time_of_last_gal_shift);
+    const Real time_shift_rho = (cur_time + dt - time_of_last_gal_shift);
+    const amrex::Array<amrex::Real,3> galilean_shift_J = {
+        m_v_galilean[0]*time_shift_J,
+        m_v_galilean[1]*time_shift_J,
+        m_v_galilean[2]*time_shift_J };
+    const amrex::Array<amrex::Real,3> galilean_shift_rho = {
+        m_v_galilean[0]*time_shift_rho,
+        m_v_galilean[1]*time_shift_rho,
+        m_v_galilean[2]*time_shift_rho };
+    const std::array<Real, 3>& xyzmin_J = WarpX::LowerCorner(tilebox_J, galilean_shift_J, lev);
+    const std::array<Real, 3>& xyzmin_rho = WarpX::LowerCorner(tilebox_rho, galilean_shift_rho, lev);
+
+    auto& attribs = pti.GetAttribs();
+    const ParticleReal* const uxp = attribs[PIdx::ux].dataPtr();
+    const ParticleReal* const uyp = attribs[PIdx::uy].dataPtr();
+    const ParticleReal* const uzp = attribs[PIdx::uz].dataPtr();
+    const Real q = this->charge;
+    const int n_rz_azimuthal_modes = WarpX::n_rz_azimuthal_modes;
+
+    const int staggering = GetGatherStaggering(exfab->box().ixType(), eyfab->box().ixType(),
+                                               ezfab->box().ixType(), bxfab->box().ixType(),
+                                               byfab->box().ixType(), bzfab->box().ixType());
+
+    // The kernel is specialized on the shape order, on whether the species is ionizable,
+    // and on the parameters of the gather and push (see GatherPushDispatch)
+    DepositionDispatch(WarpX::nox, ion_lev != nullptr, std::false_type{},
+        [&] (auto order, auto ionization, auto) {
+            constexpr int depos_order = decltype(order)::value;
+            ChargeDepositor<depos_order> deposit_charge;
+            if (rho) {
+                deposit_charge = ChargeDepositor<depos_order>(
+                    rho_fab, dx, xyzmin_rho, lbound(tilebox_rho), n_rz_azimuthal_modes);
+            }
+            auto push_and_deposit = [&] (auto const& deposit_current) {
+                const FusedDeposition<depos_order, decltype(ionization)::value,
+                                      std::decay_t<decltype(deposit_current)>> deposit{
+                    GetParticlePosition(pti), wp.dataPtr(), uxp, uyp, uzp, ion_lev, q,
+                    deposit_current, deposit_charge, rho != nullptr};
+                GatherPushDispatch(order, WarpX::galerkin_interpolation, staggering,
+                                   WarpX::particle_pusher_algo, do_classical_radiation_reaction,
+                    [&] (auto, auto galerkin, auto stag, auto pusher) {
+                        PushPXImpl<depos_order, decltype(galerkin)::value,
+                                   decltype(stag)::value, decltype(pusher)::value>(
+                            pti, exfab, eyfab, ezfab, bxfab, byfab, bzfab, ngE, 0, np,
+                            lev, lev, dt, ScaleFields(false), a_dt_type, deposit);
+                    });
+            };
+            if (WarpX::current_deposition_algo == CurrentDepositionAlgo::Esirkepov) {
+                push_and_deposit(EsirkepovDepositor<depos_order>(
+                    jx_fab.array(), jy_fab.array(), jz_fab.array(), dt, dx, xyzmin_J,
+                    lbound(tilebox_J), n_rz_azimuthal_modes));
+            } else {
+                push_and_deposit(DirectCurrentDepositor<depos_order>(
+                    jx_fab, jy_fab, jz_fab, -0.5_rt*dt, dx, xyzmin_J, lbound(tilebox_J),
+                    n_rz_azimuthal_modes));
+            }
+        });
+
+#ifndef AMREX_USE_GPU
+    // CPU, tiling: atomicAdd local_j<xyz> into j<xyz> and local_rho into rho
+    jx[pti].atomicAdd(local_jx[thread_num], tbx, tbx, 0, 0, jx.nComp());
+    jy[pti].atomicAdd(local_jy[thread_num], tby, tby, 0, 0, jy.nComp());
+    jz[pti].atomicAdd(local_jz[thread_num], tbz, tbz, 0, 0, jz.nComp());
+    if (rho) (*rho)[pti].atomicAdd(local_rho[thread_num], tb, tb, 0, nc, nc);
+#endif
+
+    return true;
+}
+
 void
 PhysicalParticleContainer::InitIonizationModule ()
 {
@@ -1977,6 +2328,38 @@ PhysicalParticleContainer::InitIonizationModule ()
     });
 
     Gpu::synchronize();
+
+    // Lookup table of the ionization probability, for the current time step
+    pp_species_name.query("ionization_adk_table", ionization_adk_table);
+    if (ionization_adk_table) {
+        pp_species_name.query("ionization_adk_table_tolerance", ionization_adk_table_tolerance);
+
+        Vector<Real> h_adk_power(ion_atomic_number);
+        Vector<Real> h_adk_prefactor(ion_atomic_number);
+        Vector<Real> h_adk_exp_prefactor(ion_atomic_number);
+        Gpu::copy(Gpu::deviceToHost, adk_power.begin(), adk_power.end(), h_adk_power.begin());
+        Gpu::copy(Gpu::deviceToHost, adk_prefactor.begin(), adk_prefactor.end(), h_adk_prefactor.begin());
+        Gpu::copy(Gpu::deviceToHost, adk_exp_prefactor.begin(), adk_exp_prefactor.end(),
+                  h_adk_exp_prefactor.begin());
+
+        Vector<Real> h_adk_table;
+        const Real error = BuildADKTable(h_adk_prefactor, h_adk_exp_prefactor, h_adk_power,
+                                         ionization_adk_table_tolerance,
+                                         h_adk_table, adk_table_params);
+
+        adk_table.resize(h_adk_table.size());
+        Gpu::copy(Gpu::hostToDevice, h_adk_table.begin(), h_adk_table.end(), adk_table.begin());
+        adk_table_params.m_data = adk_table.dataPtr();
+
+        amrex::Print() << "Species " << species_name << ": ionization probability table with "
+                       << adk_table_params.m_noctaves << " octaves of "
+                       << adk_table_params.m_npoints << " points, maximum error "
+                       << error << "\n";
+        if (error > ionization_adk_table_tolerance) {
+            amrex::Warning("The error of the ionization probability table of species "
+                           + species_name + " is larger than ionization_adk_table_tolerance");
+        }
+    }
 }
 
 IonizationFilterFunc
@@ -1999,7 +2382,9 @@ PhysicalParticleContainer::getIonizationFunc (const WarpXParIter& pti,
                                 adk_exp_prefactor.dataPtr(),
                                 adk_power.dataPtr(),
                                 particle_icomps["ionization_level"],
-                                ion_atomic_number);
+                                ion_atomic_number,
+                                adk_table_params,
+                                StoreGatheredFields(lev, pti, Ex, Bx));
 }
 
 void PhysicalParticleContainer::resample (const int timestep)
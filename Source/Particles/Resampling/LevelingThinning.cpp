@@ -34,19 +34,20 @@ void LevelingThinning::operator() (WarpXParIter& pti, const int lev,
 {
     using namespace amrex::literals;
 
+    // Using this function means that we must loop over the cells in the ParallelFor. In the case
+    // of the leveling thinning algorithm, it would have possibly been more natural and more
+    // efficient to directly loop over the particles. Nevertheless, this structure with a loop over
+    // the cells is more general and can be readily used to implement almost any other resampling
+    // algorithm. The binning is cached and shared with the collisions.
+    auto& bins = pc->GetCellBins(lev, pti);
+
+    // Particle data is extracted after the binning, which may reorder the particles
     auto& ptile = pc->ParticlesAt(lev, pti);
     auto& soa = ptile.GetStructOfArrays();
     amrex::ParticleReal * const AMREX_RESTRICT w = soa.GetRealData(PIdx::w).data();
     WarpXParticleContainer::ParticleType * const AMREX_RESTRICT
                                  particle_ptr = ptile.GetArrayOfStructs()().data();
 
-    // Using this function means that we must loop over the cells in the ParallelFor. In the case
-    // of the leveling thinning algorithm, it would have possibly been more natural and more
-    // efficient to directly loop over the particles. Nevertheless, this structure with a loop over
-    // the cells is more general and can be readily used to implement almost any other resampling
-    // algorithm.
-    auto bins = ParticleUtils::findParticlesInEachCell(lev, pti, ptile);
-
     const int n_cells = bins.numBins();
     const auto indices = bins.permutationPtr();
     const auto cell_offsets = bins.offsetsPtr();
@@ -12,6 +12,7 @@
 #include "WarpX.H"
 #include "Utils/WarpXAlgorithmSelection.H"
 #include "Utils/CoarsenMR.H"
+#include "Utils/ParticleUtils.H"
 // Import low-level single-particle kernels
 #include "Pusher/GetAndSetPosition.H"
 #include "Pusher/UpdatePosition.H"
@@ -26,6 +27,9 @@
 
 using namespace amrex;
 
+bool WarpXParticleContainer::reorder_by_cell = false;
+bool WarpXParticleContainer::cache_gathered_fields = false;
+
 WarpXParIter::WarpXParIter (ContainerType& pc, int level)
     : amrex::ParIter<0,0,PIdx::nattribs>(pc, level,
              MFItInfo().SetDynamic(WarpX::do_dynamic_scheduling))
@@ -65,6 +69,7 @@ WarpXParticleContainer::WarpXParticleContainer (AmrCore* amr_core, int ispecies)
     local_jx.resize(num_threads);
     local_jy.resize(num_threads);
     local_jz.resize(num_threads);
+    local_deposition_buffers.resize(num_threads);
 }
 
 void
@@ -81,11 +86,128 @@ WarpXParticleContainer::ReadParameters ()
         do_tiling = true;
 #endif
         pp_particles.query("do_tiling", do_tiling);
+        pp_particles.query("reorder_by_cell", reorder_by_cell);
+        pp_particles.query("cache_gathered_fields", cache_gathered_fields);
 
         initialized = true;
     }
 }
 
+void
+WarpXParticleContainer::ClearCellBins (int lev)
+{
+    if (lev < static_cast<int>(m_cell_bins.size())) m_cell_bins[lev].clear();
+}
+
+WarpXParticleContainer::ParticleBins&
+WarpXParticleContainer::GetCellBins (int lev, MFIter const& mfi)
+{
+    WARPX_PROFILE("WarpXParticleContainer::GetCellBins()");
+
+    auto& ptile = ParticlesAt(lev, mfi);
+    const int np = ptile.numParticles();
+    const Box cbx = mfi.tilebox(IntVect::TheZeroVector());
+
+    // Tiles are processed concurrently: the map is only modified in a critical section,
+    // the entry of each tile is then only accessed by one thread.
+    CellBinsEntry* entry;
+#ifdef AMREX_USE_OMP
+#pragma omp critical (warpx_cell_bins)
+#endif
+    {
+        if (static_cast<int>(m_cell_bins.size()) <= lev) m_cell_bins.resize(lev+1);
+        entry = &m_cell_bins[lev][PairIndex(mfi.index(), mfi.LocalTileIndex())];
+    }
+
+    if (entry->version == m_cell_bins_version && entry->np == np &&
+        entry->particle_ptr == ptile.GetArrayOfStructs()().data() &&
+        entry->cell_box == cbx) {
+        return entry->bins;
+    }
+
+    entry->bins = ParticleUtils::findParticlesInEachCell(lev, mfi, ptile);
+
+    if (reorder_by_cell && np > 0) {
+        // Sort the particle data by cell; the permutation is then the identity
+        ReorderParticles(lev, mfi, entry->bins.permutationPtr());
+#ifdef AMREX_USE_OMP
+#pragma omp atomic
+#endif
+        ++m_gathered_fields_version;
+        auto* const permutation = entry->bins.permutationPtr();
+        amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (int i) noexcept
+        {
+            permutation[i] = i;
+        });
+    }
+
+    entry->version = m_cell_bins_version;
+    entry->np = np;
+    entry->particle_ptr = ptile.GetArrayOfStructs()().data();
+    entry->cell_box = cbx;
+    return entry->bins;
+}
+
+WarpXParticleContainer::GatheredFieldsEntry&
+WarpXParticleContainer::GetGatheredFieldsEntry (int lev, MFIter const& mfi)
+{
+    GatheredFieldsEntry* entry;
+#ifdef AMREX_USE_OMP
+#pragma omp critical (warpx_gathered_fields)
+#endif
+    {
+        if (static_cast<int>(m_gathered_fields.size()) <= lev) m_gathered_fields.resize(lev+1);
+        entry = &m_gathered_fields[lev][PairIndex(mfi.index(), mfi.LocalTileIndex())];
+    }
+    return *entry;
+}
+
+amrex::GpuArray<amrex::ParticleReal*, 6>
+WarpXParticleContainer::StoreGatheredFields (int lev, MFIter const& mfi,
+                                             FArrayBox const& exfab, FArrayBox const& bxfab)
+{
+    amrex::GpuArray<amrex::ParticleReal*, 6> fields = {{nullptr, nullptr, nullptr,
+                                                        nullptr, nullptr, nullptr}};
+    if (!cache_gathered_fields) return fields;
+
+    auto& ptile = ParticlesAt(lev, mfi);
+    const int np = ptile.numParticles();
+
+    auto& entry = GetGatheredFieldsEntry(lev, mfi);
+    for (int i = 0; i < 6; ++i) {
+        entry.fields[i].resize(np);
+        fields[i] = entry.fields[i].dataPtr();
+    }
+    entry.version = m_gathered_fields_version;
+    entry.np = np;
+    entry.particle_ptr = ptile.GetArrayOfStructs()().data();
+    entry.e_ptr = exfab.dataPtr();
+    entry.b_ptr = bxfab.dataPtr();
+    return fields;
+}
+
+amrex::GpuArray<amrex::ParticleReal const*, 6>
+WarpXParticleContainer::UseGatheredFields (int lev, MFIter const& mfi,
+                                           FArrayBox const& exfab, FArrayBox const& bxfab)
+{
+    amrex::GpuArray<amrex::ParticleReal const*, 6> fields = {{nullptr, nullptr, nullptr,
+                                                              nullptr, nullptr, nullptr}};
+    if (!cache_gathered_fields) return fields;
+
+    auto& ptile = ParticlesAt(lev, mfi);
+    const int np = ptile.numParticles();
+
+    auto& entry = GetGatheredFieldsEntry(lev, mfi);
+    if (entry.version == m_gathered_fields_version && entry.np == np && np > 0 &&
+        entry.particle_ptr == ptile.GetArrayOfStructs()().data() &&
+        entry.e_ptr == exfab.dataPtr() && entry.b_ptr == bxfab.dataPtr()) {
+        for (int i = 0; i < 6; ++i) fields[i] = entry.fields[i].dataPtr();
+    }
+    // the particles are pushed after this call: the fields are outdated
+    entry.version = -1;
+    return fields;
+}
+
 void
 WarpXParticleContainer::AllocData ()
 {
@@ -208,6 +330,7 @@ WarpXParticleContainer::AddNParticles (int /*lev*/,
     }
 
     Redistribute();
+    InvalidateCellBins();
 }
 
 /* \brief Current Deposition for thread thread_num
@@ -379,74 +502,62 @@ WarpXParticleContainer::DepositCurrent(WarpXParIter& pti,
     amrex::LayoutData<amrex::Real>* costs = WarpX::getCosts(lev);
     amrex::Real* cost = costs ? &((*costs)[pti.index()]) : nullptr;
 
+    // The deposition kernels are specialized on the shape order, on whether the
+    // species is ionizable and on whether the kernels are timed
+    const bool do_ionization = (ion_lev != nullptr);
+    const bool do_costs = cost && WarpX::load_balance_costs_update_algo
+                                  == LoadBalanceCostsUpdateAlgo::GpuClock;
+
     if (WarpX::current_deposition_algo == CurrentDepositionAlgo::Esirkepov) {
-        if        (WarpX::nox == 1){
-            doEsirkepovDepositionShapeN<1>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, lo, q,
-                WarpX::n_rz_azimuthal_modes, cost,
-                WarpX::load_balance_costs_update_algo);
-        } else if (WarpX::nox == 2){
-            doEsirkepovDepositionShapeN<2>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, lo, q,
-                WarpX::n_rz_azimuthal_modes, cost,
-                WarpX::load_balance_costs_update_algo);
-        } else if (WarpX::nox == 3){
-            doEsirkepovDepositionShapeN<3>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, lo, q,
-                WarpX::n_rz_azimuthal_modes, cost,
-                WarpX::load_balance_costs_update_algo);
-        }
+        DepositionDispatch(WarpX::nox, do_ionization, do_costs,
+            [&] (auto order, auto ionization, auto timed) {
+                doEsirkepovDepositionShapeN<decltype(order)::value,
+                                            decltype(ionization)::value,
+                                            decltype(timed)::value>(
+                    GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                    uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                    jx_arr, jy_arr, jz_arr, np_to_depose, dt, dx, xyzmin, lo, q,
+                    WarpX::n_rz_azimuthal_modes, cost);
+            });
     } else if (WarpX::current_deposition_algo == CurrentDepositionAlgo::Vay) {
-        if        (WarpX::nox == 1){
-            doVayDepositionShapeN<1>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx, xyzmin, lo, q,
-                WarpX::n_rz_azimuthal_modes, cost,
-                WarpX::load_balance_costs_update_algo);
-        } else if (WarpX::nox == 2){
-            doVayDepositionShapeN<2>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx, xyzmin, lo, q,
-                WarpX::n_rz_azimuthal_modes, cost,
-                WarpX::load_balance_costs_update_algo);
-        } else if (WarpX::nox == 3){
-            doVayDepositionShapeN<3>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx, xyzmin, lo, q,
-                WarpX::n_rz_azimuthal_modes, cost,
-                WarpX::load_balance_costs_update_algo);
-        }
+        DepositionDispatch(WarpX::nox, do_ionization, do_costs,
+            [&] (auto order, auto ionization, auto timed) {
+                doVayDepositionShapeN<decltype(order)::value,
+                                      decltype(ionization)::value,
+                                      decltype(timed)::value>(
+                    GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                    uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                    jx_fab, jy_fab, jz_fab, np_to_depose, dt, dx, xyzmin, lo, q,
+                    WarpX::n_rz_azimuthal_modes, cost);
+            });
     } else {
-        if        (WarpX::nox == 1){
-            doDepositionShapeN<1>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_fab, jy_fab, jz_fab, np_to_depose, dt*relative_time, dx,
-                xyzmin, lo, q, WarpX::n_rz_azimuthal_modes, cost,
-                WarpX::load_balance_costs_update_algo);
-        } else if (WarpX::nox == 2){
-            doDepositionShapeN<2>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_fab, jy_fab, jz_fab, np_to_depose, dt*relative_time, dx,
-                xyzmin, lo, q, WarpX::n_rz_azimuthal_modes, cost,
-                WarpX::load_balance_costs_update_algo);
-        } else if (WarpX::nox == 3){
-            doDepositionShapeN<3>(
-                GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
-                uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
-                jx_fab, jy_fab, jz_fab, np_to_depose, dt*relative_time, dx,
-                xyzmin, lo, q, WarpX::n_rz_azimuthal_modes, cost,
-                WarpX::load_balance_costs_update_algo);
+        bool deposited = false;
+#if !defined(AMREX_USE_GPU) && !defined(WARPX_DIM_RZ)
+        if (WarpX::use_sorted_cpu_deposition) {
+            // Falls back to the unsorted deposition below when some particles
+            // are outside of the cells of the tile
+            DepositionDispatch(WarpX::nox, do_ionization, std::false_type{},
+                [&] (auto order, auto ionization, auto) {
+                    deposited = doDepositionShapeNSortedCPU<decltype(order)::value,
+                                                            decltype(ionization)::value>(
+                        GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                        uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                        jx_fab, jy_fab, jz_fab, np_to_depose, dt*relative_time, dx,
+                        xyzmin, lo, q, local_deposition_buffers[thread_num]);
+                });
+        }
+#endif
+        if (!deposited) {
+            DepositionDispatch(WarpX::nox, do_ionization, do_costs,
+                [&] (auto order, auto ionization, auto timed) {
+                    doDepositionShapeN<decltype(order)::value,
+                                       decltype(ionization)::value,
+                                       decltype(timed)::value>(
+                        GetPosition, wp.dataPtr() + offset, uxp.dataPtr() + offset,
+                        uyp.dataPtr() + offset, uzp.dataPtr() + offset, ion_lev,
+                        jx_fab, jy_fab, jz_fab, np_to_depose, dt*relative_time, dx,
+                        xyzmin, lo, q, WarpX::n_rz_azimuthal_modes, cost);
+                });
         }
     }
     WARPX_PROFILE_VAR_STOP(blp_deposit);
@@ -641,6 +752,8 @@ WarpXParticleContainer::DepositCharge (amrex::Vector<std::unique_ptr<amrex::Mult
         // Reset the `rho` array if `reset` is True
         if (reset) rho[lev]->setVal(0.0, rho[lev]->nGrowVect());
 
+        amrex::LayoutData<KernelCounterArray>* counters = WarpX::getKernelCounters(lev);
+
         // Loop over particle tiles and deposit charge on each level
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
@@ -661,7 +774,10 @@ WarpXParticleContainer::DepositCharge (amrex::Vector<std::unique_ptr<amrex::Mult
                 ion_lev = nullptr;
             }
 
+            const KernelTimer t_kernel = StartKernelTimer(counters);
             DepositCharge(pti, wp, ion_lev, rho[lev].get(), 0, 0, np, thread_num, lev, lev);
+            RecordKernelCounter(counters, pti.index(), KernelCounter::ChargeDeposition,
+                                t_kernel, np, ParticleDataBytes(*this, np));
         }
 #ifdef AMREX_USE_OMP
         }
@@ -0,0 +1,181 @@
+/* This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "KernelCounter.H"
+
+#include <AMReX_GpuAtomic.H>
+#include <AMReX_GpuDevice.H>
+#include <AMReX_GpuError.H>
+#include <AMReX_Utility.H>
+
+#include <vector>
+
+#if defined(AMREX_USE_CUDA) || defined(AMREX_USE_HIP)
+#   define WARPX_KERNEL_COUNTER_EVENTS
+#endif
+
+using namespace amrex;
+
+const std::array<std::string, KernelCounter::nkernels> KernelCounter::names = {
+    "GatherPush", "CurrentDeposition", "ChargeDeposition", "FillBoundary",
+    "FieldSolve", "Collisions", "Ionization", "Diagnostics"
+};
+
+namespace
+{
+    /** Add the time wt of a kernel to box i (all the local boxes if i < 0) */
+    void AddKernelTime (LayoutData<KernelCounterArray>* counters,
+                        const int box, const int kernel, const Real wt)
+    {
+        if (box >= 0) {
+            Real* c = (*counters)[box].data() + kernel*KernelCounter::nquantities;
+            HostDevice::Atomic::Add(c + KernelCounter::time, wt);
+            return;
+        }
+        const Vector<int>& local_index = counters->IndexArray();
+        if (local_index.empty()) return;
+        const Real wt_box = wt/local_index.size();
+        for (const int i : local_index)
+        {
+            (*counters)[i][kernel*KernelCounter::nquantities + KernelCounter::time] += wt_box;
+        }
+    }
+
+#ifdef WARPX_KERNEL_COUNTER_EVENTS
+    using GpuEvent = AMREX_HIP_OR_CUDA(hipEvent_t, cudaEvent_t);
+
+    /** A kernel whose time is not yet in the counters */
+    struct PendingKernel
+    {
+        LayoutData<KernelCounterArray>* counters;
+        int box;
+        int kernel;
+        int start;
+        int stop;
+    };
+
+    // Events are created once and reused
+    std::vector<GpuEvent> events;
+    std::vector<int> free_events;
+    std::vector<PendingKernel> pending_kernels;
+    // Bound on the number of pending kernels, i.e. on the number of events
+    constexpr std::size_t max_pending_kernels = 4096;
+
+    /** Record an event in the current stream, returns its index in events */
+    int RecordEvent ()
+    {
+        if (free_events.empty()) {
+            GpuEvent ev;
+            AMREX_HIP_OR_CUDA(AMREX_HIP_SAFE_CALL(hipEventCreate(&ev));,
+                              AMREX_CUDA_SAFE_CALL(cudaEventCreate(&ev)););
+            free_events.push_back(static_cast<int>(events.size()));
+            events.push_back(ev);
+        }
+        const int n = free_events.back();
+        free_events.pop_back();
+        AMREX_HIP_OR_CUDA(AMREX_HIP_SAFE_CALL(hipEventRecord(events[n], Gpu::gpuStream()));,
+                          AMREX_CUDA_SAFE_CALL(cudaEventRecord(events[n], Gpu::gpuStream())););
+        return n;
+    }
+
+    void StopKernelTimer (LayoutData<KernelCounterArray>* counters,
+                          const int box, const int kernel, const KernelTimer& timer)
+    {
+        pending_kernels.push_back({counters, box, kernel, timer.event, RecordEvent()});
+        if (pending_kernels.size() >= max_pending_kernels) FlushKernelTimers();
+    }
+#else
+    void StopKernelTimer (LayoutData<KernelCounterArray>* counters,
+                          const int box, const int kernel, const KernelTimer& timer)
+    {
+#ifdef AMREX_USE_DPCPP
+        Gpu::synchronize();
+#endif
+        AddKernelTime(counters, box, kernel, static_cast<Real>(amrex::second()) - timer.t_start);
+    }
+#endif
+}
+
+KernelTimer
+StartKernelTimer (const LayoutData<KernelCounterArray>* counters)
+{
+    KernelTimer timer;
+    if (!counters) return timer;
+#if defined(WARPX_KERNEL_COUNTER_EVENTS)
+    timer.event = RecordEvent();
+#else
+#   ifdef AMREX_USE_DPCPP
+    Gpu::synchronize();
+#   endif
+    timer.t_start = static_cast<Real>(amrex::second());
+#endif
+    return timer;
+}
+
+void
+RecordKernelCounter (LayoutData<KernelCounterArray>* counters,
+                     const int box, const int kernel, const KernelTimer& timer,
+                     const Long nparticles, const Long nbytes)
+{
+    if (!counters) return;
+    StopKernelTimer(counters, box, kernel, timer);
+    Real* c = (*counters)[box].data() + kernel*KernelCounter::nquantities;
+    HostDevice::Atomic::Add(c + KernelCounter::calls, Real(1.));
+    HostDevice::Atomic::Add(c + KernelCounter::particles, static_cast<Real>(nparticles));
+    HostDevice::Atomic::Add(c + KernelCounter::bytes, static_cast<Real>(nbytes));
+}
+
+void
+RecordKernelCounterAllBoxes (LayoutData<KernelCounterArray>* counters,
+                             const int kernel, const KernelTimer& timer,
+                             const Vector<const MultiFab*>& mfs, const IntVect& ng)
+{
+    if (!counters) return;
+    StopKernelTimer(counters, -1, kernel, timer);
+
+    for (const int i : counters->IndexArray())
+    {
+        Real bytes = 0.;
+        for (const MultiFab* mf : mfs)
+        {
+            if (!mf) continue;
+            const Box& bx = amrex::convert(counters->boxArray()[i], mf->ixType());
+            const Box& gbx = amrex::grow(bx, amrex::min(ng, mf->nGrowVect()));
+            bytes += static_cast<Real>((gbx.numPts() - bx.numPts())*mf->nComp()*sizeof(Real));
+        }
+        Real* c = (*counters)[i].data() + kernel*KernelCounter::nquantities;
+        c[KernelCounter::calls] += 1.;
+        c[KernelCounter::bytes] += bytes;
+    }
+}
+
+void
+CancelKernelTimer (const KernelTimer& timer)
+{
+#ifdef WARPX_KERNEL_COUNTER_EVENTS
+    if (timer.event >= 0) free_events.push_back(timer.event);
+#else
+    amrex::ignore_unused(timer);
+#endif
+}
+
+void
+FlushKernelTimers ()
+{
+#ifdef WARPX_KERNEL_COUNTER_EVENTS
+    if (pending_kernels.empty()) return;
+    Gpu::synchronize();
+    for (const auto& k : pending_kernels)
+    {
+        float ms = 0.f;
+        AMREX_HIP_OR_CUDA(
+            AMREX_HIP_SAFE_CALL(hipEventElapsedTime(&ms, events[k.start], events[k.stop]));,
+            AMREX_CUDA_SAFE_CALL(cudaEventElapsedTime(&ms, events[k.start], events[k.stop])););
+        AddKernelTime(k.counters, k.box, k.kernel, static_cast<Real>(1.e-3*ms));
+        free_events.push_back(k.start);
+        free_events.push_back(k.stop);
+    }
+    pending_kernels.clear();
+#endif
+}
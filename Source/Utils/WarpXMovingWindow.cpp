@@ -243,18 +243,16 @@ WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
 {
     WARPX_PROFILE("WarpX::shiftMF()");
     const BoxArray& ba = mf.boxArray();
-    const DistributionMapping& dm = mf.DistributionMap();
     const int nc = mf.nComp();
     const IntVect& ng = mf.nGrowVect();
 
     AMREX_ALWAYS_ASSERT(ng.min() >= num_shift);
 
-    MultiFab tmpmf(ba, dm, nc, ng);
-    MultiFab::Copy(tmpmf, mf, 0, 0, nc, ng);
-
+    // The guard cells in the moving direction are the source of the shift:
+    // fill them in place, the shift below only reads them before overwriting them.
     if ( WarpX::safe_guard_cells ) {
         // Fill guard cells.
-        tmpmf.FillBoundary(geom.periodicity());
+        mf.FillBoundary(geom.periodicity());
     } else {
         IntVect ng_mw = IntVect::TheUnitVector();
         // Enough guard cells in the MW direction
@@ -262,7 +260,7 @@ WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
         // Make sure we don't exceed number of guard cells allocated
         ng_mw = ng_mw.min(ng);
         // Fill guard cells.
-        tmpmf.FillBoundary(ng_mw, geom.periodicity());
+        mf.FillBoundary(ng_mw, geom.periodicity());
     }
 
     // Make a box that covers the region that the window moved into
@@ -289,71 +287,75 @@ WarpX::shiftMF (MultiFab& mf, const Geometry& geom, int num_shift, int dir,
         }
     }
 
-    IntVect shiftiv(0);
-    shiftiv[dir] = num_shift;
-    Dim3 shift = shiftiv.dim3();
-
     const RealBox& real_box = geom.ProbDomain();
     const auto dx = geom.CellSizeArray();
 
+    // index type of mf, for the coordinates passed to the parser
+    IntVect mf_type(AMREX_D_DECL(0,0,0));
+    for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+        mf_type[idim] = typ.nodeCentered(idim);
+    }
+
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (Gpu::notInLaunchRegion())
 #endif
-
-
-    for (MFIter mfi(tmpmf); mfi.isValid(); ++mfi )
+    for (MFIter mfi(mf); mfi.isValid(); ++mfi )
     {
-        auto const& dstfab = mf.array(mfi);
-        auto const& srcfab = tmpmf.array(mfi);
+        auto const& fab = mf.array(mfi);
 
+        // Points of the region that the window moved into: their new value is the
+        // external field, not the old data
         const Box& outbox = mfi.fabbox() & adjBox;
-
-        if (outbox.ok()) {
-            if (useparser == false) {
-                AMREX_PARALLEL_FOR_4D ( outbox, nc, i, j, k, n,
-                {
-                    srcfab(i,j,k,n) = external_field;
-                })
-            } else if (useparser == true) {
-                // index type of the src mf
-                auto const& mf_IndexType = (tmpmf).ixType();
-                IntVect mf_type(AMREX_D_DECL(0,0,0));
-                for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
-                    mf_type[idim] = mf_IndexType.nodeCentered(idim);
-                }
-
-                amrex::ParallelFor (outbox, nc,
-                      [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-                {
-                      // Compute x,y,z co-ordinates based on index type of mf
-                      Real fac_x = (1.0 - mf_type[0]) * dx[0]*0.5;
-                      Real x = i*dx[0] + real_box.lo(0) + fac_x;
+        const Dim3 out_lo = lbound(outbox);
+        const Dim3 out_hi = ubound(outbox);
+        const bool has_outbox = outbox.ok();
+
+        // The shift is done in place: each GPU thread / loop iteration owns one line
+        // of points along dir, which it walks in the direction of the shift, so that
+        // every point is read before it is overwritten. The lines are given by the
+        // box collapsed to a single index in dir.
+        const Box& fabbox = mf[mfi].box();
+        Box lines = fabbox;
+        lines.setBig(dir, fabbox.smallEnd(dir));
+        const int first = (num_shift > 0) ? fabbox.smallEnd(dir) : fabbox.bigEnd(dir);
+        const int last = (num_shift > 0) ? fabbox.bigEnd(dir) - num_shift
+                                         : fabbox.smallEnd(dir) - num_shift;
+        const int step = (num_shift > 0) ? 1 : -1;
+
+        amrex::ParallelFor (lines, nc,
+            [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
+        {
+            int dst[3] = {i, j, k};
+            for (int l = first; l*step <= last*step; l += step) {
+                dst[dir] = l;
+                int src[3] = {dst[0], dst[1], dst[2]};
+                src[dir] += num_shift;
+                const bool in_outbox = has_outbox &&
+                    src[0] >= out_lo.x && src[0] <= out_hi.x &&
+                    src[1] >= out_lo.y && src[1] <= out_hi.y &&
+                    src[2] >= out_lo.z && src[2] <= out_hi.z;
+                if (!in_outbox) {
+                    fab(dst[0],dst[1],dst[2],n) = fab(src[0],src[1],src[2],n);
+                } else if (useparser == false) {
+                    fab(dst[0],dst[1],dst[2],n) = external_field;
+                } else {
+                    // Compute x,y,z co-ordinates based on index type of mf
+                    Real fac_x = (1.0 - mf_type[0]) * dx[0]*0.5;
+                    Real x = src[0]*dx[0] + real_box.lo(0) + fac_x;
 #if (AMREX_SPACEDIM==2)
-                      Real y = 0.0;
-                      Real fac_z = (1.0 - mf_type[1]) * dx[1]*0.5;
-                      Real z = j*dx[1] + real_box.lo(1) + fac_z;
+                    Real y = 0.0;
+                    Real fac_z = (1.0 - mf_type[1]) * dx[1]*0.5;
+                    Real z = src[1]*dx[1] + real_box.lo(1) + fac_z;
 #else
-                      Real fac_y = (1.0 - mf_type[1]) * dx[1]*0.5;
-                      Real y = j*dx[1] + real_box.lo(1) + fac_y;
-                      Real fac_z = (1.0 - mf_type[2]) * dx[2]*0.5;
-                      Real z = k*dx[2] + real_box.lo(2) + fac_z;
+                    Real fac_y = (1.0 - mf_type[1]) * dx[1]*0.5;
+                    Real y = src[1]*dx[1] + real_box.lo(1) + fac_y;
+                    Real fac_z = (1.0 - mf_type[2]) * dx[2]*0.5;
+                    Real z = src[2]*dx[2] + real_box.lo(2) + fac_z;
 #endif
-                      srcfab(i,j,k,n) = field_parser(x,y,z);
-                });
+                    fab(dst[0],dst[1],dst[2],n) = field_parser(x,y,z);
+                }
             }
-
-        }
-
-        Box dstBox = mf[mfi].box();
-        if (num_shift > 0) {
-            dstBox.growHi(dir, -num_shift);
-        } else {
-            dstBox.growLo(dir,  num_shift);
-        }
-        AMREX_PARALLEL_FOR_4D ( dstBox, nc, i, j, k, n,
-        {
-            dstfab(i,j,k,n) = srcfab(i+shift.x,j+shift.y,k+shift.z,n);
-        })
+        });
     }
 }
 
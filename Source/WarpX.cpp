@@ -61,6 +61,8 @@ int WarpX::moving_window_dir = -1;
 Real WarpX::moving_window_v = std::numeric_limits<amrex::Real>::max();
 
 bool WarpX::fft_do_time_averaging = false;
+int WarpX::fft_batch_size = 3;
+bool WarpX::fft_on_the_fly_coefficients = false;
 
 Real WarpX::quantum_xi_c2 = PhysConst::xi_c2;
 Real WarpX::gamma_boost = 1._rt;
@@ -77,6 +79,7 @@ int WarpX::maxwell_solver_id;
 long WarpX::load_balance_costs_update_algo;
 bool WarpX::do_dive_cleaning = 0;
 bool WarpX::do_divb_cleaning = 0;
+bool WarpX::do_kernel_counters = false;
 int WarpX::em_solver_medium;
 int WarpX::macroscopic_solver_algo;
 amrex::Vector<int> WarpX::field_boundary_lo(AMREX_SPACEDIM,0);
@@ -107,6 +110,9 @@ bool WarpX::use_fdtd_nci_corr = false;
 bool WarpX::galerkin_interpolation = true;
 
 bool WarpX::use_filter        = false;
+bool WarpX::use_separable_filter = false;
+bool WarpX::use_sorted_cpu_deposition = false;
+bool WarpX::fuse_particle_kernels = false;
 bool WarpX::use_kspace_filter       = false;
 bool WarpX::use_filter_compensation = false;
 bool WarpX::use_damp_fields_in_z_guard = false;
@@ -138,6 +144,7 @@ int WarpX::self_fields_max_iters = 200;
 
 int WarpX::do_subcycling = 0;
 bool WarpX::safe_guard_cells = 0;
+bool WarpX::overlap_guard_cell_exchange = false;
 
 IntVect WarpX::filter_npass_each_dir(1);
 
@@ -259,6 +266,7 @@ WarpX::WarpX ()
 
     pml.resize(nlevs_max);
     costs.resize(nlevs_max);
+    kernel_counters.resize(nlevs_max);
     load_balance_efficiency.resize(nlevs_max);
 
     m_field_factory.resize(nlevs_max);
@@ -315,6 +323,16 @@ WarpX::WarpX ()
 #endif // AMREX_USE_GPU
     }
 
+    // The weights above are used until the end of the calibration, if any.
+    // The calibration uses the kernel counters, which are then also recorded
+    // if no KernelCounters reduced diagnostics asked for them.
+    if (costs_heuristic_calibration_steps > 0
+        && WarpX::load_balance_costs_update_algo==LoadBalanceCostsUpdateAlgo::Heuristic)
+    {
+        costs_calibration_owns_counters = !do_kernel_counters;
+        do_kernel_counters = true;
+    }
+
     // Allocate field solver objects
 #ifdef WARPX_USE_PSATD
     if (WarpX::maxwell_solver_id == MaxwellSolverAlgo::PSATD) {
@@ -349,6 +367,18 @@ WarpX::~WarpX ()
     }
 
     delete reduced_diags;
+
+#ifdef WARPX_USE_PSATD
+    if (maxwell_solver_id == MaxwellSolverAlgo::PSATD) {
+        // The PML own spectral solvers too: destroy them with their FFT plans
+        // here, since Finalize cleans up the FFTW threads and saves the wisdom
+        for (int lev = 0; lev < nlevs_max; ++lev) {
+            pml[lev].reset();
+        }
+        // Saves the FFTW wisdom, after all plans have been destroyed
+        AnyFFT::Finalize();
+    }
+#endif
 }
 
 void
@@ -415,6 +445,11 @@ WarpX::ReadParameters ()
         pp_warpx.query("do_subcycling", do_subcycling);
         pp_warpx.query("use_hybrid_QED", use_hybrid_QED);
         pp_warpx.query("safe_guard_cells", safe_guard_cells);
+        pp_warpx.query("overlap_guard_cell_exchange", overlap_guard_cell_exchange);
+#ifdef WARPX_DIM_RZ
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(!overlap_guard_cell_exchange,
+            "warpx.overlap_guard_cell_exchange is not implemented in RZ geometry");
+#endif
         std::vector<std::string> override_sync_intervals_string_vec = {"1"};
         pp_warpx.queryarr("override_sync_intervals", override_sync_intervals_string_vec);
         override_sync_intervals = IntervalsParser(override_sync_intervals_string_vec);
@@ -516,6 +551,7 @@ WarpX::ReadParameters ()
         // Read filter and fill IntVect filter_npass_each_dir with
         // proper size for AMREX_SPACEDIM
         pp_warpx.query("use_filter", use_filter);
+        pp_warpx.query("use_separable_filter", use_separable_filter);
         pp_warpx.query("use_filter_compensation", use_filter_compensation);
         Vector<int> parse_filter_npass_each_dir(AMREX_SPACEDIM,1);
         pp_warpx.queryarr("filter_npass_each_dir", parse_filter_npass_each_dir);
@@ -764,6 +800,19 @@ WarpX::ReadParameters ()
         // note: current_deposition must be set after maxwell_solver is already determined,
         //       because its default depends on the solver selection
         current_deposition_algo = GetAlgorithmInteger(pp_algo, "current_deposition");
+
+        ParmParse pp_warpx("warpx");
+        pp_warpx.query("use_sorted_cpu_deposition", use_sorted_cpu_deposition);
+        if (use_sorted_cpu_deposition) {
+#if defined(AMREX_USE_GPU) || defined(WARPX_DIM_RZ)
+            amrex::Abort("warpx.use_sorted_cpu_deposition is only available on CPU, in Cartesian geometry");
+#endif
+            AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+                current_deposition_algo == CurrentDepositionAlgo::Direct,
+                "warpx.use_sorted_cpu_deposition requires algo.current_deposition = direct");
+        }
+        pp_warpx.query("fuse_particle_kernels", fuse_particle_kernels);
+
         charge_deposition_algo = GetAlgorithmInteger(pp_algo, "charge_deposition");
         particle_pusher_algo = GetAlgorithmInteger(pp_algo, "particle_pusher");
 
@@ -783,12 +832,14 @@ WarpX::ReadParameters ()
         pp_algo.queryarr("load_balance_intervals", load_balance_intervals_string_vec);
         load_balance_intervals = IntervalsParser(load_balance_intervals_string_vec);
         pp_algo.query("load_balance_with_sfc", load_balance_with_sfc);
+        pp_algo.query("load_balance_node_aware", load_balance_node_aware);
         pp_algo.query("load_balance_knapsack_factor", load_balance_knapsack_factor);
         queryWithParser(pp_algo, "load_balance_efficiency_ratio_threshold",
                         load_balance_efficiency_ratio_threshold);
         load_balance_costs_update_algo = GetAlgorithmInteger(pp_algo, "load_balance_costs_update");
         queryWithParser(pp_algo, "costs_heuristic_cells_wt", costs_heuristic_cells_wt);
         queryWithParser(pp_algo, "costs_heuristic_particles_wt", costs_heuristic_particles_wt);
+        pp_algo.query("costs_heuristic_calibration_steps", costs_heuristic_calibration_steps);
     }
     {
         ParmParse pp_interpolation("interpolation");
@@ -860,7 +911,46 @@ WarpX::ReadParameters ()
     {
         ParmParse pp_psatd("psatd");
         pp_psatd.query("periodic_single_box_fft", fft_periodic_single_box);
-        pp_psatd.query("fftw_plan_measure", fftw_plan_measure);
+
+#ifdef WARPX_USE_PSATD
+        // FFTW planner rigor, threads and wisdom (ignored by cuFFT and rocFFT)
+        AnyFFT::PlannerRigor plan_rigor = AnyFFT::PlannerRigor::Estimate;
+        int fftw_nthreads = 1;
+        std::string fftw_wisdom_file;
+        std::string fftw_plan_rigor = "estimate";
+        if (!pp_psatd.query("fftw_plan_rigor", fftw_plan_rigor)) {
+            int fftw_plan_measure = 0;
+            pp_psatd.query("fftw_plan_measure", fftw_plan_measure);
+            if (fftw_plan_measure) fftw_plan_rigor = "measure";
+        }
+        std::transform(fftw_plan_rigor.begin(), fftw_plan_rigor.end(),
+                       fftw_plan_rigor.begin(), ::tolower);
+        if (fftw_plan_rigor == "estimate") {
+            plan_rigor = AnyFFT::PlannerRigor::Estimate;
+        } else if (fftw_plan_rigor == "measure") {
+            plan_rigor = AnyFFT::PlannerRigor::Measure;
+        } else if (fftw_plan_rigor == "patient") {
+            plan_rigor = AnyFFT::PlannerRigor::Patient;
+        } else {
+            amrex::Abort("psatd.fftw_plan_rigor must be estimate, measure or patient");
+        }
+#ifdef AMREX_USE_OMP
+        fftw_nthreads = omp_get_max_threads();
+#endif
+        const bool fftw_nthreads_set = pp_psatd.query("fftw_nthreads", fftw_nthreads);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(fftw_nthreads >= 1, "psatd.fftw_nthreads must be >= 1");
+#ifndef WARPX_USE_FFTW_THREADS
+        if (fftw_nthreads_set && fftw_nthreads > 1) {
+            amrex::Warning("WARNING: psatd.fftw_nthreads > 1 is ignored, "
+                           "WarpX was compiled without multithreaded FFTW");
+        }
+        fftw_nthreads = 1;
+#else
+        amrex::ignore_unused(fftw_nthreads_set);
+#endif
+        pp_psatd.query("fftw_wisdom_file", fftw_wisdom_file);
+        AnyFFT::Initialize(plan_rigor, fftw_nthreads, fftw_wisdom_file);
+#endif
 
         std::string nox_str;
         std::string noy_str;
@@ -896,6 +986,8 @@ WarpX::ReadParameters ()
         pp_psatd.query("current_correction", current_correction);
         pp_psatd.query("v_comoving", m_v_comoving);
         pp_psatd.query("do_time_averaging", fft_do_time_averaging);
+        pp_psatd.query("fft_batch_size", fft_batch_size);
+        pp_psatd.query("on_the_fly_coefficients", fft_on_the_fly_coefficients);
 
         if (!fft_periodic_single_box && current_correction)
             amrex::Abort(
@@ -1153,7 +1245,11 @@ WarpX::ClearLevel (int lev)
     }
 #endif
 
+    if (mypc) mypc->ClearCellBins(lev);
+
     costs[lev].reset();
+    FlushKernelTimers();
+    kernel_counters[lev].reset();
     load_balance_efficiency[lev] = -1;
 }
 
@@ -1626,6 +1722,15 @@ WarpX::AllocLevelMFs (int lev, const BoxArray& ba, const DistributionMapping& dm
         costs[lev] = std::make_unique<LayoutData<Real>>(ba, dm);
         load_balance_efficiency[lev] = -1;
     }
+
+    if (do_kernel_counters)
+    {
+        kernel_counters[lev] = std::make_unique<LayoutData<KernelCounterArray>>(ba, dm);
+        for (int i : kernel_counters[lev]->IndexArray())
+        {
+            (*kernel_counters[lev])[i].fill(0.0);
+        }
+    }
 }
 
 #ifdef WARPX_USE_PSATD
@@ -1909,6 +2014,18 @@ WarpX::getCosts (int lev)
     }
 }
 
+amrex::LayoutData<KernelCounterArray>*
+WarpX::getKernelCounters (int lev)
+{
+    if (m_instance)
+    {
+        return m_instance->kernel_counters[lev].get();
+    } else
+    {
+        return nullptr;
+    }
+}
+
 void
 WarpX::BuildBufferMasks ()
 {
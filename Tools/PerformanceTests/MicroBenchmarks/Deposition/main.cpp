@@ -0,0 +1,414 @@
+/* This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "Particles/Deposition/ChargeDeposition.H"
+#include "Particles/Deposition/CurrentDeposition.H"
+#include "Particles/Gather/FieldGather.H"
+#include "Particles/Pusher/UpdateMomentumBoris.H"
+#include "Particles/Pusher/UpdatePosition.H"
+#include "Utils/WarpXAlgorithmSelection.H"
+
+#include <AMReX.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_GpuContainers.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Random.H>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace amrex;
+
+namespace {
+
+    enum struct Algo {Direct, DirectSorted, Esirkepov, Vay};
+
+    struct Particles
+    {
+        Gpu::DeviceVector<WarpXParticleContainer::ParticleType> structs;
+        Gpu::DeviceVector<ParticleReal> w, ux, uy, uz;
+        Gpu::DeviceVector<int> ion_lev;
+    };
+
+    /** Uniformly distributed particles in bx, with ppc particles per cell on average
+     *  and velocities small enough for the particles to move less than a cell per step */
+    void init_particles (Particles& p, Box const& bx, Real dx, int ppc)
+    {
+        const Long np = bx.numPts()*ppc;
+        Gpu::HostVector<WarpXParticleContainer::ParticleType> structs(np);
+        Gpu::HostVector<ParticleReal> w(np), ux(np), uy(np), uz(np);
+        Gpu::HostVector<int> ion_lev(np, 1);
+        for (Long ip = 0; ip < np; ++ip) {
+            for (int idim = 0; idim < AMREX_SPACEDIM; ++idim) {
+                structs[ip].pos(idim) = (bx.smallEnd(idim) + amrex::Random()*bx.length(idim))*dx;
+            }
+            w[ip] = 1.e10_prt;
+            ux[ip] = 0.2_prt*PhysConst::c*(amrex::Random() - 0.5_prt);
+            uy[ip] = 0.2_prt*PhysConst::c*(amrex::Random() - 0.5_prt);
+            uz[ip] = 0.2_prt*PhysConst::c*(amrex::Random() - 0.5_prt);
+        }
+        p.structs.resize(np);
+        p.w.resize(np); p.ux.resize(np); p.uy.resize(np); p.uz.resize(np);
+        p.ion_lev.resize(np);
+        Gpu::copy(Gpu::hostToDevice, structs.begin(), structs.end(), p.structs.begin());
+        Gpu::copy(Gpu::hostToDevice, w.begin(), w.end(), p.w.begin());
+        Gpu::copy(Gpu::hostToDevice, ux.begin(), ux.end(), p.ux.begin());
+        Gpu::copy(Gpu::hostToDevice, uy.begin(), uy.end(), p.uy.begin());
+        Gpu::copy(Gpu::hostToDevice, uz.begin(), uz.end(), p.uz.begin());
+        Gpu::copy(Gpu::hostToDevice, ion_lev.begin(), ion_lev.end(), p.ion_lev.begin());
+    }
+
+    /** Deposit the current of all particles, through the same dispatch as
+     *  WarpXParticleContainer::DepositCurrent */
+    void deposit (Algo algo, int order, bool ionizable, Particles& p,
+                  FArrayBox& jx, FArrayBox& jy, FArrayBox& jz, Real dt,
+                  std::array<Real,3> const& dx, std::array<Real,3> const& xyzmin)
+    {
+        GetParticlePosition GetPosition;
+        GetPosition.m_structs = p.structs.dataPtr();
+        const long np = p.w.size();
+        const int* ion_lev = ionizable ? p.ion_lev.dataPtr() : nullptr;
+        const Dim3 lo = lbound(jx.box());
+        const Real q = -PhysConst::q_e;
+        const int n_rz_azimuthal_modes = 1;
+#if !defined(AMREX_USE_GPU)
+        static SortedDepositionBuffers buffers;
+#endif
+
+        DepositionDispatch(order, ionizable, false,
+            [&] (auto depos_order, auto ionization, auto timed) {
+                constexpr int o = decltype(depos_order)::value;
+                constexpr bool i = decltype(ionization)::value;
+                constexpr bool t = decltype(timed)::value;
+                if (algo == Algo::Esirkepov) {
+                    doEsirkepovDepositionShapeN<o,i,t>(
+                        GetPosition, p.w.dataPtr(), p.ux.dataPtr(), p.uy.dataPtr(), p.uz.dataPtr(),
+                        ion_lev, jx.array(), jy.array(), jz.array(), np, dt, dx, xyzmin, lo, q,
+                        n_rz_azimuthal_modes, nullptr);
+                } else if (algo == Algo::Vay) {
+                    doVayDepositionShapeN<o,i,t>(
+                        GetPosition, p.w.dataPtr(), p.ux.dataPtr(), p.uy.dataPtr(), p.uz.dataPtr(),
+                        ion_lev, jx, jy, jz, np, dt, dx, xyzmin, lo, q,
+                        n_rz_azimuthal_modes, nullptr);
+                } else if (algo == Algo::DirectSorted) {
+#if !defined(AMREX_USE_GPU)
+                    const bool deposited = doDepositionShapeNSortedCPU<o,i>(
+                        GetPosition, p.w.dataPtr(), p.ux.dataPtr(), p.uy.dataPtr(), p.uz.dataPtr(),
+                        ion_lev, jx, jy, jz, np, -0.5_rt*dt, dx, xyzmin, lo, q, buffers);
+                    // The particles are created inside the box, so there is no fallback
+                    AMREX_ALWAYS_ASSERT_WITH_MESSAGE(deposited,
+                        "direct_sorted: some particles are outside of the box");
+#else
+                    amrex::Abort("direct_sorted is only available on CPU");
+#endif
+                } else {
+                    doDepositionShapeN<o,i,t>(
+                        GetPosition, p.w.dataPtr(), p.ux.dataPtr(), p.uy.dataPtr(), p.uz.dataPtr(),
+                        ion_lev, jx, jy, jz, np, -0.5_rt*dt, dx, xyzmin, lo, q,
+                        n_rz_azimuthal_modes, nullptr);
+                }
+            });
+    }
+
+    /** Fields on the grid and parameters of the gather, as in PhysicalParticleContainer::PushPXImpl */
+    struct Fields
+    {
+        std::array<FArrayBox,6> fab; // Ex, Ey, Ez, Bx, By, Bz
+        GpuArray<Real,3> dx;
+        GpuArray<Real,3> xyzmin;
+        Dim3 lo;
+    };
+
+    /** No deposition after the push (split kernels) */
+    struct NoDeposition
+    {
+        AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+        void operator() (long /*ip*/) const noexcept {}
+    };
+
+    /** Deposition of the current and of the charge of one particle after its push,
+     *  as the FusedDeposition of PhysicalParticleContainer::PushPXAndDeposit */
+    template <int depos_order>
+    struct FusedDeposition
+    {
+        GetParticlePosition m_get_position;
+        const ParticleReal* m_wp;
+        const ParticleReal* m_ux;
+        const ParticleReal* m_uy;
+        const ParticleReal* m_uz;
+        Real m_q;
+        DirectCurrentDepositor<depos_order> m_deposit_current;
+        ChargeDepositor<depos_order> m_deposit_charge;
+
+        AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+        void operator() (long ip) const noexcept
+        {
+            ParticleReal xp, yp, zp;
+            m_get_position(ip, xp, yp, zp);
+            const Real wq = m_q*m_wp[ip];
+            m_deposit_current(xp, yp, zp, m_ux[ip], m_uy[ip], m_uz[ip], wq);
+            m_deposit_charge(xp, yp, zp, wq*m_deposit_charge.m_invvol);
+        }
+    };
+
+    /** Field gather and Boris push of all the particles, as PhysicalParticleContainer::PushPXImpl
+     *  on a Yee grid; deposit(ip) is then called for each particle in the same kernel */
+    template <int depos_order, typename Deposit>
+    void gather_push (Particles& p, Fields const& f, Real dt, Deposit const& deposit)
+    {
+        GetParticlePosition GetPosition;
+        GetPosition.m_structs = p.structs.dataPtr();
+        auto* const AMREX_RESTRICT structs = p.structs.dataPtr();
+        ParticleReal* const AMREX_RESTRICT ux = p.ux.dataPtr();
+        ParticleReal* const AMREX_RESTRICT uy = p.uy.dataPtr();
+        ParticleReal* const AMREX_RESTRICT uz = p.uz.dataPtr();
+        const Real q = -PhysConst::q_e;
+        const Real m = PhysConst::m_e;
+        Array4<Real const> const& ex_arr = f.fab[0].array();
+        Array4<Real const> const& ey_arr = f.fab[1].array();
+        Array4<Real const> const& ez_arr = f.fab[2].array();
+        Array4<Real const> const& bx_arr = f.fab[3].array();
+        Array4<Real const> const& by_arr = f.fab[4].array();
+        Array4<Real const> const& bz_arr = f.fab[5].array();
+        const IndexType ex_type = f.fab[0].box().ixType();
+        const IndexType ey_type = f.fab[1].box().ixType();
+        const IndexType ez_type = f.fab[2].box().ixType();
+        const IndexType bx_type = f.fab[3].box().ixType();
+        const IndexType by_type = f.fab[4].box().ixType();
+        const IndexType bz_type = f.fab[5].box().ixType();
+        const GpuArray<Real,3> dx = f.dx;
+        const GpuArray<Real,3> xyzmin = f.xyzmin;
+        const Dim3 lo = f.lo;
+
+        const long np = p.w.size();
+        amrex::ParallelFor(np, [=] AMREX_GPU_DEVICE (long ip)
+        {
+            ParticleReal xp, yp, zp;
+            GetPosition(ip, xp, yp, zp);
+            ParticleReal Exp = 0._prt, Eyp = 0._prt, Ezp = 0._prt;
+            ParticleReal Bxp = 0._prt, Byp = 0._prt, Bzp = 0._prt;
+            doGatherShapeNStaggered<depos_order, 0, GatherStaggering::Yee>(
+                xp, yp, zp, Exp, Eyp, Ezp, Bxp, Byp, Bzp,
+                ex_arr, ey_arr, ez_arr, bx_arr, by_arr, bz_arr,
+                ex_type, ey_type, ez_type, bx_type, by_type, bz_type,
+                dx, xyzmin, lo, 1);
+            UpdateMomentumBoris(ux[ip], uy[ip], uz[ip], Exp, Eyp, Ezp, Bxp, Byp, Bzp, q, m, dt);
+            UpdatePosition(xp, yp, zp, ux[ip], uy[ip], uz[ip], dt);
+            structs[ip].pos(0) = xp;
+#if (AMREX_SPACEDIM == 3)
+            structs[ip].pos(1) = yp;
+            structs[ip].pos(2) = zp;
+#else
+            structs[ip].pos(1) = zp;
+#endif
+            deposit(ip);
+        });
+    }
+
+    /** One step of the gather, push, current deposition and charge deposition after the push,
+     *  in one kernel (fused, PushPXAndDeposit) or in three (PushPX, DepositCurrent, DepositCharge) */
+    void push_and_deposit (bool fused, int order, Particles& p, Fields const& f,
+                           FArrayBox& jx, FArrayBox& jy, FArrayBox& jz, FArrayBox& rho, Real dt,
+                           std::array<Real,3> const& dx, std::array<Real,3> const& xyzmin)
+    {
+        GetParticlePosition GetPosition;
+        GetPosition.m_structs = p.structs.dataPtr();
+        const long np = p.w.size();
+        const Dim3 lo = lbound(jx.box());
+        const Real q = -PhysConst::q_e;
+
+        DepositionDispatch(order, false, false,
+            [&] (auto depos_order, auto, auto) {
+                constexpr int o = decltype(depos_order)::value;
+                if (fused) {
+                    const FusedDeposition<o> deposit{
+                        GetPosition, p.w.dataPtr(), p.ux.dataPtr(), p.uy.dataPtr(), p.uz.dataPtr(), q,
+                        DirectCurrentDepositor<o>(jx, jy, jz, -0.5_rt*dt, dx, xyzmin, lo, 1),
+                        ChargeDepositor<o>(rho, dx, xyzmin, lbound(rho.box()), 1)};
+                    gather_push<o>(p, f, dt, deposit);
+                } else {
+                    gather_push<o>(p, f, dt, NoDeposition{});
+                    doDepositionShapeN<o,false,false>(
+                        GetPosition, p.w.dataPtr(), p.ux.dataPtr(), p.uy.dataPtr(), p.uz.dataPtr(),
+                        nullptr, jx, jy, jz, np, -0.5_rt*dt, dx, xyzmin, lo, q, 1, nullptr);
+                    doChargeDepositionShapeN<o>(
+                        GetPosition, p.w.dataPtr(), nullptr, rho, np, dx, xyzmin, lbound(rho.box()),
+                        q, 1, nullptr, 0);
+                }
+            });
+    }
+
+    /** Copy of the particles, to run the fused and split kernels from the same state */
+    void copy_particles (Particles const& src, Particles& dst)
+    {
+        dst.structs.resize(src.structs.size());
+        dst.w.resize(src.w.size()); dst.ux.resize(src.ux.size());
+        dst.uy.resize(src.uy.size()); dst.uz.resize(src.uz.size());
+        dst.ion_lev.resize(src.ion_lev.size());
+        Gpu::copy(Gpu::deviceToDevice, src.structs.begin(), src.structs.end(), dst.structs.begin());
+        Gpu::copy(Gpu::deviceToDevice, src.w.begin(), src.w.end(), dst.w.begin());
+        Gpu::copy(Gpu::deviceToDevice, src.ux.begin(), src.ux.end(), dst.ux.begin());
+        Gpu::copy(Gpu::deviceToDevice, src.uy.begin(), src.uy.end(), dst.uy.begin());
+        Gpu::copy(Gpu::deviceToDevice, src.uz.begin(), src.uz.end(), dst.uz.begin());
+        Gpu::copy(Gpu::deviceToDevice, src.ion_lev.begin(), src.ion_lev.end(), dst.ion_lev.begin());
+    }
+
+    /** Maximum of |a-b| over max |a| */
+    Real rel_diff (FArrayBox const& a, FArrayBox const& b)
+    {
+        auto const& aa = a.array();
+        auto const& ba = b.array();
+        Real diff = 0._rt;
+        Real norm = 0._rt;
+        amrex::LoopOnCpu(a.box(), [&] (int i, int j, int k) noexcept
+        {
+            diff = std::max(diff, std::abs(aa(i,j,k) - ba(i,j,k)));
+            norm = std::max(norm, std::abs(aa(i,j,k)));
+        });
+        return (norm > 0._rt) ? diff/norm : diff;
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 32;
+        std::vector<int> ppc_list = {1, 8, 64};
+#if !defined(AMREX_USE_GPU)
+        std::vector<std::string> algo_list = {"direct", "direct_sorted", "esirkepov", "vay"};
+#else
+        std::vector<std::string> algo_list = {"direct", "esirkepov", "vay"};
+#endif
+        int nrepeat = 5;
+        bool do_fused = true;
+        ParmParse pp("bench");
+        pp.query("n_cell", n_cell);
+        pp.queryarr("ppc", ppc_list);
+        pp.queryarr("algo", algo_list);
+        pp.query("nrepeat", nrepeat);
+        pp.query("fused", do_fused);
+
+        // One tile with Yee staggering of J, and enough guard cells for order 3
+        const int ng = 4;
+        const Box valid_box(IntVect(0), IntVect(n_cell-1));
+        const Box tile_box = amrex::grow(valid_box, ng);
+        const Real h = 1.e-6_rt;
+        const std::array<Real,3> dx = {h, h, h};
+        const std::array<Real,3> xyzmin = {-ng*h, -ng*h, -ng*h};
+        const Real dt = 0.5_rt*h/PhysConst::c;
+        std::array<FArrayBox,3> j_ref, j_ion;
+        for (int idir = 0; idir < 3; ++idir) {
+            IntVect stag = IntVect::TheNodeVector();
+            if (idir < AMREX_SPACEDIM) stag[idir] = 0;
+            const Box bx = amrex::convert(tile_box, stag);
+            j_ref[idir].resize(bx, 1, The_Managed_Arena());
+            j_ion[idir].resize(bx, 1, The_Managed_Arena());
+        }
+
+        amrex::Print() << "Current deposition micro-benchmark on a tile of " << valid_box.numPts() << " cells\n";
+        for (int const ppc : ppc_list) {
+            Particles particles;
+            init_particles(particles, valid_box, h, ppc);
+            const Long np = particles.w.size();
+            for (std::string const& algo_name : algo_list) {
+                const Algo algo = (algo_name == "esirkepov") ? Algo::Esirkepov :
+                                  (algo_name == "vay") ? Algo::Vay :
+                                  (algo_name == "direct_sorted") ? Algo::DirectSorted : Algo::Direct;
+                for (int order = 1; order <= 3; ++order) {
+                    Real t[2];
+                    for (int ionizable = 0; ionizable < 2; ++ionizable) {
+                        auto& j = ionizable ? j_ion : j_ref;
+                        for (auto& fab : j) fab.setVal<RunOn::Device>(0._rt);
+                        deposit(algo, order, ionizable, particles, j[0], j[1], j[2], dt, dx, xyzmin);
+                        Gpu::synchronize();
+                        const Real t0 = amrex::second();
+                        for (int n = 0; n < nrepeat; ++n) {
+                            deposit(algo, order, ionizable, particles, j[0], j[1], j[2], dt, dx, xyzmin);
+                        }
+                        Gpu::synchronize();
+                        t[ionizable] = (amrex::second() - t0)*1.e9_rt / (Real(nrepeat)*np);
+                    }
+                    Real diff = 0._rt;
+                    for (int idir = 0; idir < 3; ++idir) {
+                        diff = std::max(diff, rel_diff(j_ref[idir], j_ion[idir]));
+                    }
+                    amrex::Print() << "ppc = " << ppc << "  algo = " << algo_name << "  order = " << order
+                                   << "  non-ionizable: " << t[0] << " ns/particle"
+                                   << "  ionizable: " << t[1] << " ns/particle"
+                                   << "  max relative difference: " << diff
+                                   << ((diff < 100*std::numeric_limits<Real>::epsilon()) ? "  (OK)" : "  (MISMATCH)")
+                                   << "\n";
+                }
+            }
+        }
+
+        if (do_fused) {
+            // Fields with the Yee centering, small enough for the particles to stay in the tile
+            Fields fields;
+            for (int comp = 0; comp < 6; ++comp) {
+                fields.fab[comp].resize(amrex::convert(tile_box, YeeIndexType(comp)), 1, The_Managed_Arena());
+                auto const& arr = fields.fab[comp].array();
+                const Real amplitude = (comp < 3) ? 1.e9_rt : 1._rt;
+                amrex::LoopOnCpu(fields.fab[comp].box(), [&] (int i, int j, int k) noexcept
+                {
+                    arr(i,j,k) = amplitude*(amrex::Random() - 0.5_rt);
+                });
+            }
+            fields.dx = {dx[0], dx[1], dx[2]};
+            fields.xyzmin = {xyzmin[0], xyzmin[1], xyzmin[2]};
+            fields.lo = lbound(tile_box);
+            FArrayBox rho_split(amrex::convert(tile_box, IntVect::TheNodeVector()), 1, The_Managed_Arena());
+            FArrayBox rho_fused(rho_split.box(), 1, The_Managed_Arena());
+
+            amrex::Print() << "\nGather, push and deposition of J and rho (direct deposition, Boris pusher), "
+                           << "in separate kernels (split) and in one kernel (fused)\n";
+            for (int const ppc : ppc_list) {
+                Particles initial;
+                init_particles(initial, valid_box, h, ppc);
+                const Long np = initial.w.size();
+                for (int order = 1; order <= 3; ++order) {
+                    Real t[2];
+                    for (int fused = 0; fused < 2; ++fused) {
+                        auto& j = fused ? j_ion : j_ref;
+                        FArrayBox& rho = fused ? rho_fused : rho_split;
+                        // Both start from the same particles, so that the J and rho deposited
+                        // over all the steps can be compared. The particles move by less than
+                        // 0.05 cell per step, and stay within the guard cells for up to about
+                        // 30 steps (bench.nrepeat).
+                        Particles particles;
+                        copy_particles(initial, particles);
+                        for (auto& fab : j) fab.setVal<RunOn::Device>(0._rt);
+                        rho.setVal<RunOn::Device>(0._rt);
+                        push_and_deposit(fused, order, particles, fields, j[0], j[1], j[2], rho, dt, dx, xyzmin);
+                        Gpu::synchronize();
+                        const Real t0 = amrex::second();
+                        for (int n = 0; n < nrepeat; ++n) {
+                            push_and_deposit(fused, order, particles, fields, j[0], j[1], j[2], rho, dt, dx, xyzmin);
+                        }
+                        Gpu::synchronize();
+                        t[fused] = (amrex::second() - t0)*1.e9_rt / (Real(nrepeat)*np);
+                    }
+                    Real diff = 0._rt;
+                    for (int idir = 0; idir < 3; ++idir) {
+                        diff = std::max(diff, rel_diff(j_ref[idir], j_ion[idir]));
+                    }
+                    diff = std::max(diff, rel_diff(rho_split, rho_fused));
+                    amrex::Print() << "ppc = " << ppc << "  order = " << order
+                                   << "  split: " << t[0] << " ns/particle"
+                                   << "  fused: " << t[1] << " ns/particle"
+                                   << "  max relative difference: " << diff
+                                   << ((diff < 100*std::numeric_limits<Real>::epsilon()) ? "  (OK)" : "  (MISMATCH)")
+                                   << "\n";
+                }
+            }
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,90 @@
+/* This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "Filter/BilinearFilter.H"
+
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace amrex;
+
+namespace {
+
+    /** Apply the filter nrepeat times, return the wall time per cell in ns */
+    Real time_filter (BilinearFilter& filter, MultiFab& dst, MultiFab const& src, int nrepeat)
+    {
+        Gpu::synchronize();
+        const Real t0 = amrex::second();
+        for (int n = 0; n < nrepeat; ++n) {
+            filter.ApplyStencil(dst, src);
+        }
+        Gpu::synchronize();
+        return (amrex::second() - t0)*1.e9_rt / (Real(nrepeat)*dst.boxArray().numPts());
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 128;
+        int max_grid_size = 64;
+        int max_npass = 6;
+        int nrepeat = 5;
+        ParmParse pp("bench");
+        pp.query("n_cell", n_cell);
+        pp.query("max_grid_size", max_grid_size);
+        pp.query("max_npass", max_npass);
+        pp.query("nrepeat", nrepeat);
+
+        BoxArray ba(Box(IntVect(0), IntVect(n_cell-1)));
+        ba.maxSize(max_grid_size);
+        DistributionMapping dm(ba);
+        const int ncomp = 1;
+        const int ngrow = max_npass;
+
+        MultiFab src(ba, dm, ncomp, ngrow);
+        MultiFab dst_ref(ba, dm, ncomp, 0);
+        MultiFab dst_sep(ba, dm, ncomp, 0);
+        for (MFIter mfi(src); mfi.isValid(); ++mfi) {
+            auto const& arr = src.array(mfi);
+            amrex::ParallelFor(mfi.fabbox(),
+            [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                arr(i,j,k) = std::sin(0.37_rt*i + 1.1_rt*j + 2.3_rt*k) + 0.1_rt*std::cos(0.05_rt*i*j);
+            });
+        }
+
+        amrex::Print() << "Bilinear filter micro-benchmark on " << ba.numPts() << " cells\n";
+        for (int npass = 0; npass <= max_npass; ++npass) {
+            BilinearFilter filter;
+            filter.npass_each_dir.fill(static_cast<unsigned int>(npass));
+            filter.ComputeStencils();
+
+            filter.use_separable = false;
+            const Real t_ref = time_filter(filter, dst_ref, src, nrepeat);
+            filter.use_separable = true;
+            const Real t_sep = time_filter(filter, dst_sep, src, nrepeat);
+
+            const Real ref_norm = dst_ref.norm0();
+            MultiFab::Subtract(dst_sep, dst_ref, 0, 0, ncomp, 0);
+            const Real rel_diff = dst_sep.norm0() / std::max(ref_norm, std::numeric_limits<Real>::min());
+
+            amrex::Print() << "npass = " << npass
+                           << "  tensor-product: " << t_ref << " ns/cell"
+                           << "  separable: " << t_sep << " ns/cell"
+                           << "  speedup: " << t_ref/t_sep
+                           << "  max relative difference: " << rel_diff
+                           << ((rel_diff < 100*std::numeric_limits<Real>::epsilon()) ? "  (OK)" : "  (MISMATCH)")
+                           << "\n";
+        }
+    }
+    amrex::Finalize();
+}
@@ -0,0 +1,96 @@
+/* This file is part of WarpX.
+ *
+ * License: BSD-3-Clause-LBNL
+ */
+#include "Parser/WarpXParser.H"
+#include "Parser/WarpXParserWrapper.H"
+
+#include <AMReX.H>
+#include <AMReX_Box.H>
+#include <AMReX_FArrayBox.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Reduce.H>
+
+#include <string>
+#include <vector>
+
+using namespace amrex::literals;
+
+namespace {
+
+    /** Evaluate the parser on every cell of bx, return the wall time
+     *  per evaluation in ns */
+    amrex::Real
+    time_parser (HostDeviceParser<3> const& parser, amrex::Box const& bx,
+                 amrex::FArrayBox& fab, int nrepeat)
+    {
+        auto const& arr = fab.array();
+        const amrex::Real dx = 1.e-6_rt/bx.length(0);
+        amrex::Gpu::synchronize();
+        const amrex::Real t0 = amrex::second();
+        for (int n = 0; n < nrepeat; ++n) {
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                arr(i,j,k) = parser(i*dx, j*dx, k*dx);
+            });
+        }
+        amrex::Gpu::synchronize();
+        return (amrex::second() - t0)*1.e9_rt / (amrex::Real(nrepeat)*bx.numPts());
+    }
+}
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc, argv);
+    {
+        int n_cell = 64;
+        int nrepeat = 10;
+        amrex::ParmParse pp("bench");
+        pp.query("n_cell", n_cell);
+        pp.query("nrepeat", nrepeat);
+
+        // Representative expressions: plasma density profiles,
+        // laser and external field functions, histogram filters.
+        std::vector<std::string> exprs = {
+            "n0*(z>0)*(z<L)",
+            "n0*exp(-(x*x+y*y)/(w0*w0))*(z>0)*(z<L)",
+            "n0*(1.+tanh((z-L)/1.e-6))*0.5*(1.+4.*(x*x+y*y)/(w0*w0))",
+            "E0*exp(-(x*x+y*y)/(w0*w0))*sin(2*pi*z/lambda0)*cos(2*pi*z/lambda0)",
+            "(x*x+y*y<w0*w0)*(sqrt(x*x+y*y+z*z)>1.e-7)",
+            "min(max(x,y),z) + x^2*y^3 - y/z + (x+y)*(x+y)/(1.+(x+y)^2)"
+        };
+
+        const amrex::Box bx(amrex::IntVect(0), amrex::IntVect(n_cell-1));
+        amrex::FArrayBox fab_ast(bx, 1);
+        amrex::FArrayBox fab_bc(bx, 1);
+
+        amrex::Print() << "Parser micro-benchmark on " << bx.numPts()
+                       << " points, " << nrepeat << " repetitions\n";
+        for (auto const& expr : exprs) {
+            WarpXParser wp(expr);
+            wp.setConstant("n0", 1.e24);
+            wp.setConstant("L", 0.5e-6);
+            wp.setConstant("w0", 0.3e-6);
+            wp.setConstant("E0", 1.e12);
+            wp.setConstant("lambda0", 0.8e-6);
+            wp.setConstant("pi", 3.141592653589793);
+            wp.registerVariables({"x","y","z"});
+
+            ParserWrapper<3> ast_parser(wp, false);
+            ParserWrapper<3> bc_parser(wp, true);
+
+            const amrex::Real t_ast = time_parser(ast_parser.getParser(), bx, fab_ast, nrepeat);
+            const amrex::Real t_bc = time_parser(bc_parser.getParser(), bx, fab_bc, nrepeat);
+
+            fab_bc.minus<amrex::RunOn::Device>(fab_ast);
+            const amrex::Real diff = fab_bc.norm<amrex::RunOn::Device>(0);
+
+            amrex::Print() << expr << "\n"
+                           << "    AST: " << t_ast << " ns/eval,  bytecode: " << t_bc
+                           << " ns/eval,  speedup: " << t_ast/t_bc
+                           << ",  max |diff|: " << diff << "\n";
+        }
+    }
+    amrex::Finalize();
+}
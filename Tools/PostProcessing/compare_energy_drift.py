@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+#
+# This file is part of WarpX.
+#
+# License: BSD-3-Clause-LBNL
+
+"""
+Compare the total energy drift of two WarpX executables, typically a
+double-precision build and a build with single-precision particles
+(WarpX_PARTICLE_PRECISION=SINGLE), on a set of input files.
+
+Each input file is run in its own directory with FieldEnergy and
+ParticleEnergy reduced diagnostics added on the command line, and the
+relative drift (E(t) - E(0))/E(0) of the total energy is reported.
+If the initial energy is zero, the drift is normalized by max|E(t)|
+instead, and flagged with a * in the output.
+
+By default, the 3D uniform plasma and Langmuir wave examples are run: they
+are periodic and have no injection, so that their total energy is conserved.
+Inputs with a moving window, open boundaries or injected particles or lasers
+do not conserve the total energy, and their drift is not meaningful.
+
+Example:
+    python compare_energy_drift.py \\
+        --reference ./warpx.3d.MPI.OMP.DP.ex \\
+        --test ./warpx.3d.MPI.OMP.DP.pSP.ex \\
+        --max_step 200
+"""
+
+# Standard imports
+import argparse
+import os
+import shutil
+import subprocess
+
+# High-performance math
+import numpy as np
+
+# Standard benchmarks with a closed (periodic) domain, relative to the root of the repository
+default_inputs = ['Examples/Physics_applications/uniform_plasma/inputs_3d',
+                  'Examples/Tests/Langmuir/inputs_3d_multi_rt']
+repository_root = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..')
+
+
+def run(executable, inputs, run_dir, max_step, intervals):
+    """
+    Run executable on inputs in run_dir, with energy reduced diagnostics
+    """
+    if os.path.exists(run_dir):
+        shutil.rmtree(run_dir)
+    os.makedirs(run_dir)
+    args = [os.path.abspath(executable), os.path.abspath(inputs),
+            'warpx.reduced_diags_names=drift_EF drift_EP',
+            'drift_EF.type=FieldEnergy', 'drift_EF.intervals={}'.format(intervals),
+            'drift_EP.type=ParticleEnergy', 'drift_EP.intervals={}'.format(intervals)]
+    if max_step is not None:
+        args.append('max_step={}'.format(max_step))
+    with open(os.path.join(run_dir, 'output.txt'), 'w') as output:
+        subprocess.run(args, cwd=run_dir, stdout=output, stderr=subprocess.STDOUT,
+                       check=True)
+
+
+def total_energy(run_dir):
+    """
+    Steps and total (field + particle) energy of a run
+    """
+    reduced = os.path.join(run_dir, 'diags', 'reducedfiles')
+    # columns: step, time, total energy, ...
+    ef = np.atleast_2d(np.loadtxt(os.path.join(reduced, 'drift_EF.txt')))
+    ep = np.atleast_2d(np.loadtxt(os.path.join(reduced, 'drift_EP.txt')))
+    return ef[:, 0], ef[:, 2] + ep[:, 2]
+
+
+def relative_drift(energy):
+    """
+    Relative drift of the energy with respect to its initial value, or with
+    respect to its maximum absolute value if the initial value is zero.
+    Also returns whether the latter normalization was used.
+    """
+    if energy[0] != 0.:
+        return (energy - energy[0])/energy[0], False
+    norm = np.amax(np.abs(energy))
+    if norm == 0.:
+        return np.zeros_like(energy), True
+    return (energy - energy[0])/norm, True
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--reference', required=True,
+                        help='reference executable (e.g. double precision)')
+    parser.add_argument('--test', required=True,
+                        help='tested executable (e.g. single-precision particles)')
+    parser.add_argument('--inputs', nargs='+', default=None,
+                        help='input files (default: {})'.format(' '.join(default_inputs)))
+    parser.add_argument('--max_step', type=int, default=None,
+                        help='number of steps (default: max_step of the input files)')
+    parser.add_argument('--intervals', type=int, default=1,
+                        help='interval between energy outputs')
+    parser.add_argument('--run_dir', default='energy_drift',
+                        help='directory where the simulations are run')
+    args = parser.parse_args()
+    if args.inputs is None:
+        args.inputs = [os.path.normpath(os.path.join(repository_root, inputs))
+                       for inputs in default_inputs]
+
+    print('{:<60} {:>14} {:>14} {:>14}'.format('input', 'drift ref', 'drift test', 'difference'))
+    flagged = False
+    for inputs in args.inputs:
+        name = os.path.normpath(os.path.relpath(inputs, repository_root))
+        name = name.replace(os.sep, '_').lstrip('._')
+        drifts = []
+        normalized_by_max = False
+        for label, executable in (('reference', args.reference), ('test', args.test)):
+            run_dir = os.path.join(args.run_dir, name, label)
+            run(executable, inputs, run_dir, args.max_step, args.intervals)
+            drift, by_max = relative_drift(total_energy(run_dir)[1])
+            drifts.append(drift)
+            normalized_by_max = normalized_by_max or by_max
+        flagged = flagged or normalized_by_max
+        nsteps = min(len(drifts[0]), len(drifts[1]))
+        ref, test = drifts[0][nsteps-1], drifts[1][nsteps-1]
+        print('{:<60} {:>14.6e} {:>14.6e} {:>14.6e}{}'.format(
+            inputs, ref, test, test - ref, ' *' if normalized_by_max else ''))
+    if flagged:
+        print('* zero initial energy: drift normalized by the maximum absolute energy')
+
+
+if __name__ == '__main__':
+    main()
@@ -1,3 +1,6 @@
+# multithreaded FFTW transforms: set below if the library is found
+set(WarpX_FFTW_THREADS OFF)
+
 if(WarpX_PSATD)
     # cuFFT  (CUDA)
     #   TODO: check if `find_package` search works
@@ -58,22 +61,42 @@ if(WarpX_PSATD)
                 # subtargets: fftw3, fftw3_threads, fftw3_omp
                 if(WarpX_COMPUTE STREQUAL OMP AND TARGET FFTW3::fftw3_omp)
                     make_third_party_includes_system(FFTW3::fftw3_omp FFT)
+                    set(WarpX_FFTW_THREADS ON)
                 else()
                     make_third_party_includes_system(FFTW3::fftw3 FFT)
                 endif()
             else()
                 make_third_party_includes_system(PkgConfig::fftw3 FFT)
+                # multithreaded FFTW is not part of the .pc file
+                if(WarpX_COMPUTE STREQUAL OMP)
+                    find_library(WarpX_fftw3_omp_LIBRARY fftw3_omp HINTS ${fftw3_LIBRARY_DIRS})
+                    mark_as_advanced(WarpX_fftw3_omp_LIBRARY)
+                    if(WarpX_fftw3_omp_LIBRARY)
+                        target_link_libraries(WarpX::thirdparty::FFT INTERFACE ${WarpX_fftw3_omp_LIBRARY})
+                        set(WarpX_FFTW_THREADS ON)
+                    endif()
+                endif()
             endif()
         else()
             if(FFTW3f_FOUND)
                 # subtargets: fftw3f, fftw3f_threads, fftw3f_omp
                 if(WarpX_COMPUTE STREQUAL OMP AND TARGET FFTW3::fftw3f_omp)
                     make_third_party_includes_system(FFTW3::fftw3f_omp FFT)
+                    set(WarpX_FFTW_THREADS ON)
                 else()
                     make_third_party_includes_system(FFTW3::fftw3f FFT)
                 endif()
             else()
                 make_third_party_includes_system(PkgConfig::fftw3f FFT)
+                # multithreaded FFTW is not part of the .pc file
+                if(WarpX_COMPUTE STREQUAL OMP)
+                    find_library(WarpX_fftw3f_omp_LIBRARY fftw3f_omp HINTS ${fftw3f_LIBRARY_DIRS})
+                    mark_as_advanced(WarpX_fftw3f_omp_LIBRARY)
+                    if(WarpX_fftw3f_omp_LIBRARY)
+                        target_link_libraries(WarpX::thirdparty::FFT INTERFACE ${WarpX_fftw3f_omp_LIBRARY})
+                        set(WarpX_FFTW_THREADS ON)
+                    endif()
+                endif()
             endif()
         endif()
     endif()